@@ -21,16 +21,19 @@ namespace bso { namespace structural_design { namespace component {
 		else if (s.type() == "quad_hexahedron") mHasQuadHexahedron = true;
 		
 		mStructures.push_back(s);
+		++mRevision;
 	} // addStructure()
 
 	void geometry::addLoad(const load& l)
 	{
 		mLoads.push_back(l);
+		++mRevision;
 	} // addLoad()
 
 	void geometry::addConstraint(const constraint& c)
 	{
 		mConstraints.push_back(c);
+		++mRevision;
 	} // addConstraint()
 
 	void geometry::clearMesh()
@@ -46,6 +49,7 @@ namespace bso { namespace structural_design { namespace component {
 		{
 			i.rescaleStructuralVolume(scaleFactor);
 		}
+		++mRevision;
 	} // rescaleStructuralVolume()
 
 } // namespace component
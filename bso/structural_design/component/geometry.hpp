@@ -5,6 +5,7 @@
 #include <bso/structural_design/component/load.hpp>
 #include <bso/structural_design/component/constraint.hpp>
 #include <bso/structural_design/component/point.hpp>
+#include <bso/structural_design/component/point_store.hpp>
 
 #include <bso/structural_design/element/elements.hpp>
 #include <initializer_list>
@@ -21,6 +22,7 @@ namespace bso { namespace structural_design { namespace component {
 		std::vector<structure> 	mStructures;
 		std::vector<load> 			mLoads;
 		std::vector<constraint> mConstraints;
+		unsigned long mRevision = 0; // counts the changes to its structures, loads and constraints
 		
 		bool mHasTruss = false;
 		bool mHasBeam = false;
@@ -38,7 +40,7 @@ namespace bso { namespace structural_design { namespace component {
 		virtual void addLoad(const load& l);
 		virtual void addConstraint(const constraint& c);
 
-		virtual void mesh(const unsigned int& n, std::vector<point*>& point_store) = 0;
+		virtual void mesh(const unsigned int& n, point_store& pointStore) = 0;
 		virtual void clearMesh();
 		
 		void rescaleStructuralVolume(const double& scaleFactor);
@@ -59,6 +61,7 @@ namespace bso { namespace structural_design { namespace component {
 		const std::vector<structure>& getStructures() const {return mStructures;} 
 		const std::vector<load>& getLoads() const {return mLoads;}
 		const std::vector<constraint>& getConstraints() const {return mConstraints;}	
+		const unsigned long& getRevision() const {return mRevision;}
 	};
 	
 } // namespace component
@@ -18,7 +18,7 @@ namespace bso { namespace structural_design { namespace component {
 		~line_segment();
 		
 		void addStructure(const structure& s);
-		void mesh(const unsigned int& n, std::vector<point*>& point_store);
+		void mesh(const unsigned int& n, point_store& pointStore);
 	};
 	
 } // namespace component
@@ -24,11 +24,13 @@ namespace bso { namespace structural_design { namespace component {
 	void point::addLoad(const load& l)
 	{
 		mLoads.push_back(l);
+		++mRevision;
 	} // addLoad
 
 	void point::addConstraint(const constraint& c)
 	{
 		mConstraints.push_back(c);
+		++mRevision;
 	} // addConstraint
 
 } // namespace component
@@ -17,6 +17,7 @@ namespace bso { namespace structural_design { namespace component {
 		
 		std::vector<load> mLoads;
 		std::vector<constraint> mConstraints;
+		unsigned long mRevision = 0; // counts the changes to its loads and constraints
 	public:
 		template<class T>
 		point(const unsigned long& ID, const Eigen::MatrixBase<T>& rhs);
@@ -27,6 +28,7 @@ namespace bso { namespace structural_design { namespace component {
 		void addConstraint(const constraint& c);
 		
 		const unsigned long& getID() const {return mID;}
+		const unsigned long& getRevision() const {return mRevision;}
 		
 		const std::vector<load>& getLoads() const {return mLoads;}
 		const std::vector<constraint>& getConstraints() const {return mConstraints;}
@@ -0,0 +1,71 @@
+#ifndef SD_POINT_STORE_CPP
+#define SD_POINT_STORE_CPP
+
+namespace bso { namespace structural_design { namespace component {
+	
+	point_store::point_store(const double& tol /*= 1e-9*/)
+	: mOwnArena(new bso::utilities::arena()), mPointGrid(tol)
+	{
+		mArena = mOwnArena.get();
+	} // ctor
+	
+	point_store::point_store(bso::utilities::arena* meshArena, const double& tol /*= 1e-9*/)
+	: mArena(meshArena), mPointGrid(tol)
+	{
+		
+	} // ctor
+	
+	point_store::point_store(const point_store& rhs)
+	: mOwnArena(new bso::utilities::arena()), mPointGrid(rhs.mPointGrid.tolerance())
+	{ // the copy has an arena of its own
+		mArena = mOwnArena.get();
+		*this = rhs;
+	} // copy ctor
+	
+	point_store& point_store::operator = (const point_store& rhs)
+	{ // deep copy, the points keep their IDs, loads, and constraints
+		if (this == &rhs) return *this;
+		this->clear();
+		mPointGrid = bso::utilities::geometry::vertex_grid<point*>(rhs.mPointGrid.tolerance());
+		for (const auto& i : rhs.mPoints)
+		{
+			mPoints.push_back(mArena->create<point>(*i));
+			mPointGrid.insert(mPoints.back());
+		}
+		mNextID = rhs.mNextID;
+		return *this;
+	} // operator =
+	
+	point_store::~point_store()
+	{ // the points are destroyed with the arena
+		
+	} // dtor
+	
+	point* point_store::addPoint(const bso::utilities::geometry::vertex& v)
+	{ // returns the point at v if it is in the store already, otherwise a new point is created
+		point* existingPoint = mPointGrid.find(v);
+		if (existingPoint != nullptr) return existingPoint;
+		
+		mPoints.push_back(mArena->create<point>(mNextID++,v));
+		mPointGrid.insert(mPoints.back());
+		return mPoints.back();
+	} // addPoint()
+	
+	point* point_store::findPoint(const bso::utilities::geometry::vertex& v) const
+	{
+		return mPointGrid.find(v);
+	} // findPoint()
+	
+	void point_store::clear()
+	{ // a shared arena is released by its owner
+		mPoints.clear();
+		mPointGrid.clear();
+		mNextID = 0;
+		if (mOwnArena) mOwnArena->release();
+	} // clear()
+	
+} // namespace component
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_POINT_STORE_CPP
@@ -0,0 +1,46 @@
+#ifndef SD_POINT_STORE_HPP
+#define SD_POINT_STORE_HPP
+
+#include <bso/structural_design/component/point.hpp>
+#include <bso/utilities/arena.hpp>
+#include <bso/utilities/geometry/vertex_grid.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace component {
+	
+	class point_store
+	{ // owns the points that are created while meshing the geometries of a structural model
+	private:
+		std::unique_ptr<bso::utilities::arena> mOwnArena; // the arena of the points, unless the store shares one
+		bso::utilities::arena* mArena;
+		std::vector<point*> mPoints;
+		bso::utilities::geometry::vertex_grid<point*> mPointGrid; // spatial index to find existing points
+		unsigned long mNextID = 0; // one more than the highest ID in the store
+	public:
+		point_store(const double& tol = 1e-9);
+		point_store(bso::utilities::arena* meshArena, const double& tol = 1e-9); // the points are destroyed with meshArena
+		point_store(const point_store& rhs);
+		point_store& operator = (const point_store& rhs);
+		~point_store();
+		
+		point* addPoint(const bso::utilities::geometry::vertex& v);
+		point* findPoint(const bso::utilities::geometry::vertex& v) const;
+		void clear();
+		
+		std::vector<point*>::const_iterator begin() const {return mPoints.begin();}
+		std::vector<point*>::const_iterator end() const {return mPoints.end();}
+		point* operator [] (const unsigned long& i) const {return mPoints[i];}
+		point* back() const {return mPoints.back();}
+		unsigned long size() const {return mPoints.size();}
+		const unsigned long& nextID() const {return mNextID;}
+	};
+	
+} // namespace component
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/component/point_store.cpp>
+
+#endif // SD_POINT_STORE_HPP
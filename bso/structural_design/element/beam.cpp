@@ -25,8 +25,19 @@ namespace bso { namespace structural_design { namespace element {
 			}
 		}
 		
+		// share the stiffness matrix of a congruent beam, or derive it
+		terms_cache::key key;
+		for (const auto& i : {mE, mWidth, mHeight, mPoisson}) terms_cache::addParameter(key,i);
+		terms_cache::addGeometry(key,mVertices);
+		std::shared_ptr<const stiffness_terms> terms = terms_cache::instance().find(key,
+			[this](){return this->deriveStiffnessTerms();});
+		mOriginalSM = std::shared_ptr<const Eigen::MatrixXd>(terms,&terms->SM);
+	}
+	
+	std::shared_ptr<const beam::stiffness_terms> beam::deriveStiffnessTerms() const
+	{
 		// create the transformation matrix (this contains the orientations of the beam)
-		mT.setZero(12,12);
+		stiffness_matrix T = stiffness_matrix::Zero();
 		bso::utilities::geometry::vector vx, vy, vz;
 		vx = this->getVector().normalized(); // the direction of the beam (local x-axis)
 		
@@ -52,12 +63,12 @@ namespace bso { namespace structural_design { namespace element {
 			for (int j = 0; j < 2; j++)
 			{ // and for both: displacements and rotations
 				// add the transformation term lambda
-				mT.block<3,3>((2*i+j)*3,(2*i+j)*3) = lambda.transpose();
+				T.block<3,3>((2*i+j)*3,(2*i+j)*3) = lambda.transpose();
 			}
 		}
 		
 		// initializing this element's stiffness matrix:
-		mSM.setZero(12,12);
+		stiffness_matrix K = stiffness_matrix::Zero();
 		double lenght = this->getLength();
 		double ael = (mA   * mE) / lenght; // normal strength
 		double gjl = (mG   * mJ) / lenght; // shear strength
@@ -70,49 +81,49 @@ namespace bso { namespace structural_design { namespace element {
 		double fy  = (2.0  * mE  * mIy) / lenght;
 		double fz  = (2.0  * mE  * mIz) / lenght;
 
-		mSM(0,0) = ael;   // row 0: F(x,1) : normal force
-		mSM(1,1) = az;    // row 1: F(y,1) : shear  force
-		mSM(2,2) = ay;    // row 2: F(z,1) : shear  force
-		mSM(3,3) = gjl;   // row 3: M(xy,1): torsional moment
-		mSM(4,2) = -cy;   // row 4: M(yz,1): bending   moment
-		mSM(4,4) = ey;
-		mSM(5,1) = cz;    // row 5: M(zx,1): bending   moment
-		mSM(5,5) = ez;
-		mSM(6,0) = -ael;  // row 6: F(x,2)
-		mSM(6,6) = ael;
-		mSM(7,1) = -az;   // row 7: F(y,2)
-		mSM(7,5) = -cz;
-		mSM(7,7) = az;
-		mSM(8,2) = -ay;   // row 8: F(z,2)
-		mSM(8,4) = cy;
-		mSM(8,8) = ay;
-		mSM(9,3) = -gjl;  // row 9: M(xy,2)
-		mSM(9,9) = gjl;
-		mSM(10,2) = -cy;  // row 10:M(yz,2)
-		mSM(10,4) = fy;
-		mSM(10,8) = cy;
-		mSM(10,10) = ey;
-		mSM(11,1) = cz;   // row 11:M(zx,2)
-		mSM(11,5) = fz;
-		mSM(11,7) = -cz;
-		mSM(11,11) = ez;
+		K(0,0) = ael;   // row 0: F(x,1) : normal force
+		K(1,1) = az;    // row 1: F(y,1) : shear  force
+		K(2,2) = ay;    // row 2: F(z,1) : shear  force
+		K(3,3) = gjl;   // row 3: M(xy,1): torsional moment
+		K(4,2) = -cy;   // row 4: M(yz,1): bending   moment
+		K(4,4) = ey;
+		K(5,1) = cz;    // row 5: M(zx,1): bending   moment
+		K(5,5) = ez;
+		K(6,0) = -ael;  // row 6: F(x,2)
+		K(6,6) = ael;
+		K(7,1) = -az;   // row 7: F(y,2)
+		K(7,5) = -cz;
+		K(7,7) = az;
+		K(8,2) = -ay;   // row 8: F(z,2)
+		K(8,4) = cy;
+		K(8,8) = ay;
+		K(9,3) = -gjl;  // row 9: M(xy,2)
+		K(9,9) = gjl;
+		K(10,2) = -cy;  // row 10:M(yz,2)
+		K(10,4) = fy;
+		K(10,8) = cy;
+		K(10,10) = ey;
+		K(11,1) = cz;   // row 11:M(zx,2)
+		K(11,5) = fz;
+		K(11,7) = -cz;
+		K(11,11) = ez;
 		
 		// m_SM is symmetric, so the above terms are mirrored
-		Eigen::MatrixXd tempSMCopy(12,12);
-		tempSMCopy = mSM.transpose();
+		stiffness_matrix tempSMCopy = K.transpose();
 		tempSMCopy.diagonal().setZero();
-		mSM = tempSMCopy + mSM;
+		K += tempSMCopy;
 
 		// transform element stiffness matrix to global coordinate system
-		mSM = mT.transpose() * mSM * mT;
-		mOriginalSM = mSM;
-	}
+		auto terms = std::make_shared<stiffness_terms>();
+		terms->SM = T.transpose() * K * T;
+		return terms;
+	} // deriveStiffnessTerms()
 	
 	template<class CONTAINER>
 	beam::beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
 						 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<12>(ID, E, ERelativeLowerBound)
 	{ // 
 		mIsBeam = true;
 		mWidth = width;
@@ -125,7 +136,7 @@ namespace bso { namespace structural_design { namespace element {
 	beam::beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
 						 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<12>(ID, E, ERelativeLowerBound)
 	{ // 
 		mIsBeam = true;
 		mWidth = width;
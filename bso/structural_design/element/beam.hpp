@@ -5,9 +5,15 @@
 
 namespace bso { namespace structural_design { namespace element {
 	
-	class beam : public bso::utilities::geometry::line_segment,
-							 public element
+	class beam final : public bso::utilities::geometry::line_segment,
+							 public sized_element<12>
 	{
+	public:
+		struct stiffness_terms
+		{ // the terms that only depend on the geometry and the section and material parameters
+			Eigen::MatrixXd SM; // the element stiffness matrix in the global coordinate system
+		};
+		typedef stiffness_cache<stiffness_terms> terms_cache; // shared by congruent beams
 	private:
 		double mWidth;
 		double mHeight;
@@ -18,10 +24,9 @@ namespace bso { namespace structural_design { namespace element {
 		double mJ;
 		double mG;
 		
-		Eigen::MatrixXd mT;
-		
 		template<class CONTAINER>
 		void deriveStiffnessMatrix(CONTAINER& l);
+		std::shared_ptr<const stiffness_terms> deriveStiffnessTerms() const;
 	public:
 		template<class CONTAINER>
 		beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
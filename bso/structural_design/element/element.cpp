@@ -55,62 +55,111 @@ namespace bso { namespace structural_design { namespace element {
 	std::vector<triplet> element::getSMTriplets() const
 	{ //
 		std::vector<triplet> tripletList;
-		for (unsigned int m = 0; m < mSM.rows(); ++m)
+		double factor = this->getStiffnessFactor();
+		const Eigen::MatrixXd& SM = *mOriginalSM;
+		for (unsigned int m = 0; m < SM.rows(); ++m)
 		{
-			for (unsigned int n = 0; n < mSM.cols(); ++n)
+			for (unsigned int n = 0; n < SM.cols(); ++n)
 			{
-				if ((mSM(m,n) != 0) && (mEFT.find(m) != mEFT.end()) && (mEFT.find(n) != mEFT.end()))
+				if ((SM(m,n) != 0) && (mEFT.find(m) != mEFT.end()) && (mEFT.find(n) != mEFT.end()))
 				{
-					tripletList.push_back(triplet(mEFT.at(m),mEFT.at(n),mSM(m,n))); // have to use map::at() because triplet initializer takes non const argument by reference
+					tripletList.push_back(triplet(mEFT.at(m),mEFT.at(n),factor*SM(m,n))); // have to use map::at() because triplet initializer takes non const argument by reference
 				}
 			}
 		}
 		return tripletList;
 	} //
 
-	void element::computeResponse(load_case lc)
-	{ //
-		Eigen::VectorXd elementDisplacements(mSM.rows());
-		elementDisplacements.setZero();
-		auto dispIte = elementDisplacements.data();
-
+	long element::findLoadCase(const load_case& lc) const
+	{
+		if (mOwnResponses) return mOwnResponses->findLoadCase(lc);
+		else if (mResponses != nullptr) return mResponses->findLoadCase(lc);
+		else return -1;
+	} // findLoadCase()
+	
+	template <class VECTOR>
+	void element::gatherDisplacements(const unsigned long& lcIndex, VECTOR& u) const
+	{ // an element that is not in a system takes the displacements that were added to its nodes
+		unsigned int index = 0;
 		for (const auto& i : mNodes)
 		{
+			Eigen::Vector6d nodeDisplacements = (mOwnResponses) ?
+				i->getDisplacements(mOwnResponses->getLoadCases()[lcIndex]) : i->getDisplacements(lcIndex);
 			for (unsigned int j = 0; j < 6; ++j)
 			{
-				if (mEFS(j) == 1)
-				{
-					*dispIte = i->getDisplacements(lc)(j);
-					++dispIte;
-				}
+				if (mEFS(j) == 1) u(index++) = nodeDisplacements(j);
 			}
 		}
-		mDisplacements[lc] = elementDisplacements;
-		mEnergies[lc] = 0.5 * elementDisplacements.transpose() * mSM * elementDisplacements;
-		mTotalEnergy += mEnergies[lc];
-	} //
+	} // gatherDisplacements()
+	
+	void element::addEnergy(const unsigned long& lcIndex, const double& energy)
+	{
+		if (mOwnResponses) mOwnResponses->getEnergies()(0,lcIndex) = energy;
+		else mResponses->getEnergies()(mResponseIndex,lcIndex) = energy;
+		mTotalEnergy += energy;
+	} // addEnergy()
+	
+	void element::evaluateResponse(const unsigned long& lcIndex)
+	{ //
+		Eigen::VectorXd elementDisplacements(mOriginalSM->rows());
+		this->gatherDisplacements(lcIndex,elementDisplacements);
+		this->addEnergy(lcIndex, 0.5 * (mE/mE0) * elementDisplacements.dot((*mOriginalSM) * elementDisplacements));
+	} // evaluateResponse()
+	
+	void element::setResponseBuffer(response_buffer* responses, const unsigned long& index)
+	{ // the system sizes the energies of the buffer and clears them
+		mResponses = responses;
+		mResponseIndex = index;
+		mOwnResponses.reset();
+	} // setResponseBuffer()
+	
+	void element::computeResponse(load_case lc)
+	{ // an element that is not in a system keeps its responses itself
+		unsigned long column;
+		if (mResponses != nullptr)
+		{
+			long lcIndex = mResponses->findLoadCase(lc);
+			if (lcIndex < 0)
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nError, cannot compute the response of an element to load case: " << lc << "\n"
+										 << "which is not a load case of its system.\n"
+										 << "(bso/structural_design/element.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+			column = lcIndex;
+		}
+		else
+		{
+			if (!mOwnResponses)
+			{
+				mOwnResponses = std::make_shared<response_buffer>();
+				mOwnResponses->getEnergies().setZero(1,0);
+			}
+			else if (mOwnResponses.use_count() > 1) mOwnResponses = std::make_shared<response_buffer>(*mOwnResponses);
+			column = mOwnResponses->addLoadCase(lc);
+		}
+		this->evaluateResponse(column);
+	} // computeResponse()
+	
+	void element::computeResponses()
+	{
+		for (unsigned long i = 0; i < mResponses->getLoadCases().size(); ++i)
+		{
+			this->evaluateResponse(i);
+		}
+	} // computeResponses()
 	
 	void element::clearResponse()
 	{ // 
-		mDisplacements.clear();
-		mEnergies.clear();
+		mOwnResponses.reset();
 		mTotalEnergy = 0;
 	} // clearResponse()
 	
 	void element::updateDensity(const double& x, const double& penal /*= 1*/, std::string type /*= "modifiedSIMP"*/)
 	{
-		if (type == "modifiedSIMP")
-		{
-			mDensity = x;
-			mE = mEmin + std::pow(mDensity,penal)*(mE0 - mEmin);
-			mSM = (mE/mE0) * mOriginalSM;
-		}
-		else if (type == "regularSIMP")
-		{
-			mDensity = x;
-			mE = std::pow(mDensity,penal)*mE0;
-			mSM = (mE/mE0) * mOriginalSM;
-		}
+		if (type == "modifiedSIMP") this->setDensity(x,penal,false);
+		else if (type == "regularSIMP") this->setDensity(x,penal,true);
 		else
 		{
 			std::stringstream errorMessage;
@@ -121,6 +170,13 @@ namespace bso { namespace structural_design { namespace element {
 		}
 	} // updateDensity()
 	
+	void element::setDensity(const double& x, const double& penal, const bool& regularSIMP)
+	{
+		mDensity = x;
+		if (regularSIMP) mE = std::pow(mDensity,penal)*mE0;
+		else mE = mEmin + std::pow(mDensity,penal)*(mE0 - mEmin);
+	} // setDensity()
+	
 	double element::getTotalEnergy(const std::string& type /*= ""*/) const
 	{
 		if (type == "") return mTotalEnergy;
@@ -163,9 +219,11 @@ namespace bso { namespace structural_design { namespace element {
 
 	const double& element::getEnergy(load_case lc, const std::string& type/*= ""*/) const
 	{ //
-		if (mEnergies.find(lc) != mEnergies.end())
+		long lcIndex = this->findLoadCase(lc);
+		if (lcIndex >= 0)
 		{
-			return mEnergies.find(lc)->second;
+			if (mOwnResponses) return mOwnResponses->getEnergies()(0,lcIndex);
+			else return mResponses->getEnergies()(mResponseIndex,lcIndex);
 		}
 		else
 		{
@@ -177,11 +235,14 @@ namespace bso { namespace structural_design { namespace element {
 		}
 	} //
 
-	const Eigen::VectorXd& element::getDisplacements(load_case lc) const
+	Eigen::VectorXd element::getDisplacements(load_case lc) const
 	{ //
-		if (mDisplacements.find(lc) != mDisplacements.end())
+		long lcIndex = this->findLoadCase(lc);
+		if (lcIndex >= 0)
 		{
-			return mDisplacements.find(lc)->second;
+			Eigen::VectorXd elementDisplacements(mOriginalSM->rows());
+			this->gatherDisplacements(lcIndex,elementDisplacements);
+			return elementDisplacements;
 		}
 		else
 		{
@@ -192,6 +253,24 @@ namespace bso { namespace structural_design { namespace element {
 			throw std::runtime_error(errorMessage.str());
 		}
 	} //
+	
+	Eigen::VectorXd element::extractDisplacements(const Eigen::VectorXd& systemDisplacements) const
+	{ // e.g. those of a combination of load cases, the constrained DOFs have no global DOF
+		Eigen::VectorXd u = Eigen::VectorXd::Zero(mOriginalSM->rows());
+		for (const auto& i : mEFT) u(i.first) = systemDisplacements(i.second);
+		return u;
+	} // extractDisplacements()
+	
+	Eigen::VectorXd element::getForces(const Eigen::VectorXd& u) const
+	{
+		return this->getStiffnessFactor() * ((*mOriginalSM) * u);
+	} // getForces()
+	
+	double element::getStrainEnergy(const Eigen::VectorXd& u, const std::string& type /*= ""*/) const
+	{ // the energies by type are only separated by the flat shells, as in getTotalEnergy()
+		if (type == "") return 0.5 * u.dot(this->getForces(u));
+		else return 0.0;
+	} // getStrainEnergy()
 
 } // namespace element
 } // namespace structural_design
@@ -3,12 +3,14 @@
 
 #include <bso/structural_design/component/load.hpp>
 #include <bso/structural_design/element/node.hpp>
+#include <bso/structural_design/element/response_buffer.hpp>
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
 #include <vector>
 #include <map>
+#include <memory>
 
 namespace bso { namespace structural_design { namespace element {
 	
@@ -25,12 +27,12 @@ namespace bso { namespace structural_design { namespace element {
 
 		std::map<unsigned int, unsigned long> mEFT; // element freedom table, the global DOF indices of each DOF of this element's node
 		
-		Eigen::MatrixXd mOriginalSM; // the element stiffness matrix before applying topology densities
-		Eigen::MatrixXd mSM; // the element stiffness matrix after applying topology densities
+		std::shared_ptr<const Eigen::MatrixXd> mOriginalSM; // the element stiffness matrix before applying topology densities, these scale it by mE/mE0, shared by congruent elements
 		
-		std::map<load_case, Eigen::VectorXd> mDisplacements;
-		std::map<load_case, double> mEnergies;
-		double mTotalEnergy;
+		response_buffer* mResponses = nullptr; // responses of the system this element is in
+		unsigned long mResponseIndex = 0; // the row of this element in the energies of mResponses
+		std::shared_ptr<response_buffer> mOwnResponses; // responses of an element that is not in a system, shared by its copies until one of them changes
+		double mTotalEnergy = 0;
 		
 		// Variables related to the stiffness of this element, mostly related to topology optimization
 		double mDensity = 1.0; // element density
@@ -46,16 +48,25 @@ namespace bso { namespace structural_design { namespace element {
 		bool mVisualize = true;
 		bool mActiveInCompliance = true;
 		
+		long findLoadCase(const load_case& lc) const; // the column of lc in the responses, -1 if there is none
+		template <class VECTOR>
+		void gatherDisplacements(const unsigned long& lcIndex, VECTOR& u) const; // the displacements of the DOFs of this element, in the order of its SM
+		void addEnergy(const unsigned long& lcIndex, const double& energy);
 	public:
 		element(const unsigned long& ID, const double& E, const double& ERelativeLowerBound = 1e-6);
 		virtual ~element();
 		
 		virtual void generateEFT();
 		virtual std::vector<triplet> getSMTriplets() const;
-		virtual void computeResponse(load_case lc);
+		void setResponseBuffer(response_buffer* responses, const unsigned long& index);
+		void computeResponse(load_case lc);
+		void computeResponses(); // for all load cases of the system this element is in
+		virtual void evaluateResponse(const unsigned long& lcIndex); // the response to the load case in column lcIndex of the responses
 		virtual void clearResponse();
 		
 		virtual void updateDensity(const double& x, const double& penal = 1, std::string type = "modifiedSIMP");
+		void setDensity(const double& x, const double& penal, const bool& regularSIMP); // updateDensity() without parsing the type
+		void resetDensity() {mDensity = 1.0; mE = mE0;} // back to the density it is created with
 		
 		virtual double getProperty(std::string) const = 0;
 		virtual double getVolume() const = 0;
@@ -68,6 +79,10 @@ namespace bso { namespace structural_design { namespace element {
 		virtual bso::utilities::geometry::vertex getCenter() const = 0;
 		
 		const unsigned long& ID() const {return mID;}
+		const std::map<unsigned int, unsigned long>& getEFT() const {return mEFT;}
+		const Eigen::MatrixXd& getOriginalSM() const {return *mOriginalSM;}
+		Eigen::MatrixXd getSM() const {return this->getStiffnessFactor() * (*mOriginalSM);}
+		double getStiffnessFactor() const {return mE/mE0;}
 		virtual const bool& isTruss() const {return mIsTruss;}
 		virtual const bool& isBeam() const {return mIsBeam;}
 		virtual const bool& isFlatShell() const {return mIsFlatShell;}
@@ -78,7 +93,10 @@ namespace bso { namespace structural_design { namespace element {
 		virtual bool& isActiveInCompliance() {return mActiveInCompliance;}
 		virtual const double& getDensity() const {return mDensity;}
 		virtual const double& getEnergy(load_case lc, const std::string& type = "") const;
-		virtual const Eigen::VectorXd& getDisplacements(load_case lc) const;
+		virtual Eigen::VectorXd getDisplacements(load_case lc) const;
+		Eigen::VectorXd extractDisplacements(const Eigen::VectorXd& systemDisplacements) const; // in the order of its SM, from displacements per global DOF
+		Eigen::VectorXd getForces(const Eigen::VectorXd& u) const; // nodal forces of the element displacements u
+		virtual double getStrainEnergy(const Eigen::VectorXd& u, const std::string& type = "") const; // of the element displacements u
 		const std::vector<node*>& getNodes() const {return mNodes;}
 		
 	};
@@ -0,0 +1,45 @@
+#ifndef SD_ELEMENT_GROUPS_CPP
+#define SD_ELEMENT_GROUPS_CPP
+
+namespace bso { namespace structural_design { namespace element {
+	
+	element_groups::element_groups()
+	{
+		
+	} // ctor
+	
+	element_groups::~element_groups()
+	{
+		
+	} // dtor
+	
+	void element_groups::addElement(element* ele, const unsigned long& index)
+	{ // the type is determined once, when the element is added
+		auto add = [&](auto& group, auto* typedElement)
+		{
+			group.elements.push_back(typedElement);
+			group.indices.push_back(index);
+		};
+		if (auto t = dynamic_cast<truss*>(ele)) add(std::get<element_group<truss> >(mGroups),t);
+		else if (auto b = dynamic_cast<beam*>(ele)) add(std::get<element_group<beam> >(mGroups),b);
+		else if (auto fs = dynamic_cast<flat_shell*>(ele)) add(std::get<element_group<flat_shell> >(mGroups),fs);
+		else if (auto qh = dynamic_cast<quad_hexahedron*>(ele)) add(std::get<element_group<quad_hexahedron> >(mGroups),qh);
+		else add(std::get<element_group<element> >(mGroups),ele);
+	} // addElement()
+	
+	void element_groups::clear()
+	{
+		mGroups = decltype(mGroups)();
+	} // clear()
+	
+	template <class FUNCTION>
+	void element_groups::forEach(FUNCTION f) const
+	{
+		std::apply([&](const auto&... groups){(f(groups), ...);}, mGroups);
+	} // forEach()
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_ELEMENT_GROUPS_CPP
@@ -0,0 +1,49 @@
+#ifndef SD_ELEMENT_GROUPS_HPP
+#define SD_ELEMENT_GROUPS_HPP
+
+#include <bso/structural_design/element/elements.hpp>
+
+#include <tuple>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace element {
+	
+	/*
+	 * The elements of a system, grouped by their concrete type. The element types are final, so a
+	 * loop over a group resolves the element functions at compile time instead of through the
+	 * virtual table, and can inline them. Elements of any other type are kept in a group of
+	 * pointers to the base class.
+	 */
+	
+	template <class T>
+	struct element_group
+	{
+		std::vector<T*> elements;
+		std::vector<unsigned long> indices; // the index of each element in its system
+	};
+	
+	class element_groups
+	{
+	private:
+		std::tuple<element_group<truss>, element_group<beam>, element_group<flat_shell>,
+			element_group<quad_hexahedron>, element_group<element> > mGroups;
+	public:
+		element_groups();
+		~element_groups();
+		
+		void addElement(element* ele, const unsigned long& index);
+		void clear();
+		
+		template <class T>
+		const element_group<T>& get() const {return std::get<element_group<T> >(mGroups);}
+		template <class FUNCTION>
+		void forEach(FUNCTION f) const; // calls f with each group, f must accept any element_group<T>
+	};
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/element_groups.cpp>
+
+#endif // SD_ELEMENT_GROUPS_HPP
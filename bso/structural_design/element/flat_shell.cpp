@@ -20,6 +20,19 @@ namespace bso { namespace structural_design { namespace element {
 			}
 		}
 		
+		// share the stiffness terms of a congruent flat shell, or derive them
+		terms_cache::key key;
+		for (const auto& i : {mE, mThickness, mPoisson}) terms_cache::addParameter(key,i);
+		terms_cache::addGeometry(key,mVertices);
+		mTerms = terms_cache::instance().find(key,[this](){return this->deriveStiffnessTerms();});
+		mOriginalSM = std::shared_ptr<const Eigen::MatrixXd>(mTerms,&mTerms->SM);
+	}
+	
+	std::shared_ptr<const flat_shell::stiffness_terms> flat_shell::deriveStiffnessTerms() const
+	{
+		auto terms = std::make_shared<stiffness_terms>();
+		stiffness_matrix& T = terms->T;
+		
 		// create the transformation matrix (this contains the orientations of the flat shell)
 		bso::utilities::geometry::vector vx, vy, vz;
 		vx = (((mVertices[1] + mVertices[2]) / 2.0) - this->getCenter()); // vector from center to center of a line, this will be the local x-axis
@@ -28,7 +41,7 @@ namespace bso { namespace structural_design { namespace element {
 		vz.normalize();
 		vy = vz.cross(vx).normalized(); // normal to both vx and vz, this will be the local y-axis
 
-		mT.setZero(24,24);
+		T.setZero();
 		Eigen::Matrix3d lambda;
 		lambda << vx, vy, vz;
 
@@ -37,12 +50,11 @@ namespace bso { namespace structural_design { namespace element {
 			for (int j = 0; j < 2; j++)
 			{ // and for both: displacements and rotations
 				// add the transformation term lambda
-				mT.block<3,3>((2*i+j)*3,(2*i+j)*3) = lambda.transpose();
+				T.block<3,3>((2*i+j)*3,(2*i+j)*3) = lambda.transpose();
 			}
 		}
 		
-		Eigen::MatrixXd locCoords;
-		locCoords.setZero(4,3);
+		Eigen::Matrix<double,4,3> locCoords;
 		
 		for (unsigned int i = 0; i < 4; ++i)
 		{
@@ -50,10 +62,10 @@ namespace bso { namespace structural_design { namespace element {
 		}
 
 		// initialise the element stiffness matrices and start numerical integration of the contribution of every node to the element's stiffness
-		Eigen::MatrixXd kShear, kNormal, kBending;
-		kShear.setZero(8,8);
-		kNormal.setZero(8,8);
-		kBending.setZero(12,12);
+		Eigen::Matrix<double,8,8> kShear = Eigen::Matrix<double,8,8>::Zero();
+		Eigen::Matrix<double,8,8> kNormal = Eigen::Matrix<double,8,8>::Zero();
+		Eigen::Matrix<double,12,12> kBending = Eigen::Matrix<double,12,12>::Zero();
+		Eigen::Matrix<double,3,8> BSum = Eigen::Matrix<double,3,8>::Zero();
 		double ksi, eta;
 		double wKsi, wEta;
 		for (int l=0;l<2;l++)
@@ -83,26 +95,23 @@ namespace bso { namespace structural_design { namespace element {
 				}
 
 				// Finding matrix J following Kaushalkumar Kansara
-				Eigen::MatrixXd J;
-				J.setZero(2,2);
+				Eigen::Matrix2d J;
 				J(0,0) = (-0.25+0.25*eta)*locCoords(0,0) + ( 0.25-0.25*eta)*locCoords(1,0) + (0.25+0.25*eta)*locCoords(2,0) + (-0.25-0.25*eta)*locCoords(3,0);
 				J(0,1) = (-0.25+0.25*eta)*locCoords(0,1) + ( 0.25-0.25*eta)*locCoords(1,1) + (0.25+0.25*eta)*locCoords(2,1) + (-0.25-0.25*eta)*locCoords(3,1);
 				J(1,0) = (-0.25+0.25*ksi)*locCoords(0,0) + (-0.25-0.25*ksi)*locCoords(1,0) + (0.25+0.25*ksi)*locCoords(2,0) + ( 0.25-0.25*ksi)*locCoords(3,0);
 				J(1,1) = (-0.25+0.25*ksi)*locCoords(0,1) + (-0.25-0.25*ksi)*locCoords(1,1) + (0.25+0.25*ksi)*locCoords(2,1) + ( 0.25-0.25*ksi)*locCoords(3,1);
-				Eigen::MatrixXd JInverse = J.inverse();
+				Eigen::Matrix2d JInverse = J.inverse();
 
 				// Performing integration of the in-plane behaviour
 				// Finding matrix A following Kaushalkumar Kansara
-				Eigen::MatrixXd A;
-				A.setZero(3,4);
+				Eigen::Matrix<double,3,4> A;
 				A(0,0) = J(1,1);	A(0,1) = -J(0,1);	A(0,2) = 0;				A(0,3) = 0;
 				A(1,0) = 0;				A(1,1) = 0;				A(1,2) = -J(1,0);	A(1,3) = J(0,0);
 				A(2,0) = -J(1,0);	A(2,1) = J(0,0);	A(2,2) = J(1,1);	A(2,3) = -J(0,1);
 				A = A * (1/J.determinant());
 
 				// Finding matrix G following Kaushalkumar Kansara
-				Eigen::MatrixXd G;
-				G.setZero(4,8);
+				Eigen::Matrix<double,4,8> G = Eigen::Matrix<double,4,8>::Zero();
 				G(0,0)=(-0.25+0.25*eta); 	G(2,1)=G(0,0);
 				G(0,2)=(0.25-0.25*eta);		G(2,3)=G(0,2);
 				G(0,4)=(0.25+0.25*eta);		G(2,5)=G(0,4);
@@ -113,36 +122,14 @@ namespace bso { namespace structural_design { namespace element {
 				G(1,6)=(0.25-0.25*ksi);		G(3,7)=G(1,6);
 
 				// matrix B for in-plane behaviour
-				Eigen::MatrixXd B;
-				B.setZero(3,8);
-				B = A * G;
+				Eigen::Matrix<double,3,8> B = A * G;
 
-				// save strain-displacement matrix for in-plane behaviour per integration point
-				if (m == 0 && l == 0)
-				{
-					mB1.setZero(3,8);
-					mB1 = B;
-				}
-				else if (m == 0 && l == 1)
-				{
-					mB2.setZero(3,8);
-					mB2 = B;
-				}
-				else if (m == 1 && l == 1)
-				{
-					mB3.setZero(3,8);
-					mB3 = B;
-				}
-				else
-				{
-					mB4.setZero(3,8);
-					mB4 = B;
-				}
+				// sum the strain-displacement matrices for in-plane behaviour of each integration point
+				BSum += B;
 	
 				// Matrix elasticity term, separated for normal and shear action
-				Eigen::MatrixXd ETermNormal, ETermShear;
-				ETermNormal.setZero(3,3);
-				ETermShear.setZero(3,3);
+				Eigen::Matrix3d ETermNormal = Eigen::Matrix3d::Zero();
+				Eigen::Matrix3d ETermShear = Eigen::Matrix3d::Zero();
 				ETermNormal(0,0) = 1;    			ETermNormal(0,1) = mPoisson;
 				ETermNormal(1,0) = mPoisson;  ETermNormal(1,1) = 1;  
 			  ETermShear(2,2)  = (1 - mPoisson) / 2;
@@ -153,13 +140,11 @@ namespace bso { namespace structural_design { namespace element {
 				kShear	+= mThickness * wKsi * wEta * B.transpose() * ETermShear  * B * J.determinant();
 
 				// save elasticity matrix (for a solid element) for in-plane behaviour (for stress_based topology optimization)
-				mETermSolid.setZero(3,3);
-				mETermSolid = ETermNormal * (mE0 / mE) + ETermShear * (mE0 / mE);
+				terms->ETermSolid = ETermNormal * (mE0 / mE) + ETermShear * (mE0 / mE);
 
 				// Performing integration of the out-of-plane behaviour
 				// according to Batoz & Tahar: Evaluation of a new quadrilateral thin plate bending element (1982)
-				Eigen::MatrixXd N;
-				N.setZero(8,2);
+				Eigen::Matrix<double,8,2> N;
 				N(0,0) = ( 1.0/4.0)*(2*ksi+eta)*(1-eta);	N(0,1) = ( 1.0/4.0)*((2*eta)+ksi)*(1-ksi);
 				N(1,0) = ( 1.0/4.0)*(2*ksi-eta)*(1-eta);	N(1,1) = ( 1.0/4.0)*((2*eta)-ksi)*(1+ksi);
 				N(2,0) = ( 1.0/4.0)*(2*ksi+eta)*(1+eta);	N(2,1) = ( 1.0/4.0)*((2*eta)+ksi)*(1+ksi);
@@ -170,16 +155,15 @@ namespace bso { namespace structural_design { namespace element {
 				N(7,0) = (-1.0/2.0)*(1-(eta*eta));   			N(7,1) = -eta			 *(1-ksi);
 
 				// calculating elasticity term bending behaviour
-				Eigen::MatrixXd ETermBending;
-				ETermBending.setZero(3,3);
+				Eigen::Matrix3d ETermBending = Eigen::Matrix3d::Zero();
 				ETermBending(0,0) = 1;    		ETermBending(0,1) = mPoisson;
 				ETermBending(1,0) = mPoisson; ETermBending(1,1) = 1;  
 				ETermBending(2,2) = (1-mPoisson)/2;
 				ETermBending = ETermBending * ((mE * pow(mThickness,3)) 
 																		/ (12 * (1 - pow(mPoisson, 2))));
 
-				Eigen::VectorXd a,b,c,d,e;
-				a.setZero(8);	b.setZero(8); c.setZero(8); d.setZero(8); e.setZero(8);
+				Eigen::Matrix<double,8,1> a,b,c,d,e;
+				a.setZero();	b.setZero(); c.setZero(); d.setZero(); e.setZero();
 				std::vector<std::pair<int,int> > indices = {{0,1},{1,2},{2,3},{3,0}};
 
 				for (unsigned int i = 0; i < 4; ++i)
@@ -196,8 +180,7 @@ namespace bso { namespace structural_design { namespace element {
 				}
 
 				// values for H derivatives as presented in the paper Batoz, Taher
-				Eigen::MatrixXd Hx, Hy;
-				Hx.setZero(12,2); Hy.setZero(12,2);
+				Eigen::Matrix<double,12,2> Hx, Hy;
 				indices.clear();
 				indices = {{4,7},{5,4},{6,5},{7,6}};
 
@@ -218,53 +201,56 @@ namespace bso { namespace structural_design { namespace element {
 				}
 
 				// matrix B for bending behaviour
-				B.setZero(3,12);
-				B.row(0) = Hx * JInverse.row(0).transpose();
-				B.row(1) = Hy * JInverse.row(1).transpose();
-				B.row(2) = Hy * JInverse.row(0).transpose()
-								 + Hx * JInverse.row(1).transpose();
+				Eigen::Matrix<double,3,12> BBending;
+				BBending.row(0) = Hx * JInverse.row(0).transpose();
+				BBending.row(1) = Hy * JInverse.row(1).transpose();
+				BBending.row(2) = Hy * JInverse.row(0).transpose()
+												+ Hx * JInverse.row(1).transpose();
 
 				// stiffness matrix for bending
-				kBending += B.transpose() * ETermBending * B * J.determinant();
+				kBending += BBending.transpose() * ETermBending * BBending * J.determinant();
 			} // end for m (ksi/eta)
 		} // end for l (ksi/eta)
 
 		// fill the found stiffness terms kXxxx... into the stiffness matrices
-		mSMNormal.setZero(24,24); mSMShear.setZero(24,24); mSMBending.setZero(24,24);
+		stiffness_matrix SMNormal, SMShear, SMBending;
+		SMNormal.setZero(); SMShear.setZero(); SMBending.setZero();
 		for (int m=0;m<4;m++)
 		{
 			for (int n=0;n<4;n++)
 			{
-				mSMNormal.block<2,2>(6*m+0,6*n+0) << kNormal.block<2,2>(2*m,2*n);
-				mSMShear.block<2,2>(6*m+0,6*n+0) << kShear.block<2,2>(2*m,2*n);
-				mSMBending.block<3,3>(6*m+2,6*n+2) << kBending.block<3,3>(3*m,3*n);
+				SMNormal.block<2,2>(6*m+0,6*n+0) << kNormal.block<2,2>(2*m,2*n);
+				SMShear.block<2,2>(6*m+0,6*n+0) << kShear.block<2,2>(2*m,2*n);
+				SMBending.block<3,3>(6*m+2,6*n+2) << kBending.block<3,3>(3*m,3*n);
 			}
 		}
 
 		// compose stiffness matrix out of normal, shear, and bending stiffness matrices
-		mSM = mSMBending + mSMNormal + mSMShear;
+		stiffness_matrix K = SMBending + SMNormal + SMShear;
 
 		// add drilling stiffness to the element
-		mSM(5,5)   = mSM.mean(); // add drilling terms to the 6th dof of the local stiffness matrix
-		mSM(11,11) = mSM(5,5);
-		mSM(17,17) = mSM(5,5);
-		mSM(23,23) = mSM(5,5);
+		K(5,5)   = K.mean(); // add drilling terms to the 6th dof of the local stiffness matrix
+		K(11,11) = K(5,5);
+		K(17,17) = K(5,5);
+		K(23,23) = K(5,5);
 
 		// transform element stiffness matrices to global coordinate system
-		mSM = mT.transpose() * mSM * mT;
-		mOriginalSM = mSM;
+		terms->SM = T.transpose() * K * T;
 
 		// also transform the bending and normal action stiffness amtrices
-		mSMBending = mT.transpose() * mSMBending * mT;
-		mSMNormal  = mT.transpose() * mSMNormal  * mT;
-		mSMShear   = mT.transpose() * mSMShear 	 * mT;
-	}
+		terms->SMBending = T.transpose() * SMBending * T;
+		terms->SMNormal  = T.transpose() * SMNormal  * T;
+		terms->SMShear   = T.transpose() * SMShear 	 * T;
+
+		terms->BAv = (1.0/4) * BSum; // average B-matrix
+		return terms;
+	} // deriveStiffnessTerms()
 	
 	template<class CONTAINER>
 	flat_shell::flat_shell(const unsigned long& ID, const double& E, const double& thickness, const double& poisson,
 												 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/, const double geomTol /* = 1e-3*/)
 	: bso::utilities::geometry::quadrilateral(derived_ptr_to_vertex(l), geomTol),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<24>(ID, E, ERelativeLowerBound)
 	{ // 
 		
 		mIsFlatShell = true;
@@ -277,7 +263,7 @@ namespace bso { namespace structural_design { namespace element {
 	flat_shell::flat_shell(const unsigned long& ID, const double& E, const double& thickness, const double& poisson,
 												 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/, const double geomTol /* = 1e-3*/)
 	: bso::utilities::geometry::quadrilateral(derived_ptr_to_vertex(l), geomTol),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<24>(ID, E, ERelativeLowerBound)
 	{ // 
 		
 		mIsFlatShell = true;
@@ -292,38 +278,23 @@ namespace bso { namespace structural_design { namespace element {
 		
 	} // dtor
 	
-	void flat_shell::computeResponse(load_case lc)
+	void flat_shell::evaluateResponse(const unsigned long& lcIndex)
 	{
-		Eigen::VectorXd elementDisplacements(mSM.rows());
-		elementDisplacements.setZero();
-		auto dispIte = elementDisplacements.data();
+		element_vector elementDisplacements;
+		this->gatherDisplacements(lcIndex,elementDisplacements);
+		mE0K0U.noalias() = this->getFixedOriginalSM() * elementDisplacements; // also used for stress sensitivity
 		
-		for (const auto& i : mNodes)
-		{
-			for (unsigned int j = 0; j < 6; ++j)
-			{
-				if (mEFS(j) == 1)
-				{
-					*dispIte = i->getDisplacements(lc)(j);
-					++dispIte;
-				}
-			}
-		}
-		mDisplacements[lc] = elementDisplacements;
-		mEnergies[lc] = 0.5 * elementDisplacements.transpose() * mSM * elementDisplacements;
-		mTotalEnergy += mEnergies[lc];
-		mSeparatedEnergies[lc]["normal"]  = 0.5 * elementDisplacements.transpose() * mSMNormal  * elementDisplacements;
-		mAxialEnergy += mSeparatedEnergies[lc]["normal"];
-		mSeparatedEnergies[lc]["shear"]   = 0.5 * elementDisplacements.transpose() * mSMShear   * elementDisplacements;
-		mShearEnergy += mSeparatedEnergies[lc]["shear"];
-		mSeparatedEnergies[lc]["bending"] = 0.5 * elementDisplacements.transpose() * mSMBending * elementDisplacements;
-		mBendEnergy += mSeparatedEnergies[lc]["bending"];
+		this->addEnergy(lcIndex, 0.5 * (mE/mE0) * elementDisplacements.dot(mE0K0U));
+		if (mSeparatedEnergies.cols() <= (long)lcIndex) mSeparatedEnergies.conservativeResize(Eigen::NoChange,lcIndex+1);
+		mSeparatedEnergies(0,lcIndex) = 0.5 * elementDisplacements.dot(mTerms->SMNormal  * elementDisplacements);
+		mAxialEnergy += mSeparatedEnergies(0,lcIndex);
+		mSeparatedEnergies(1,lcIndex) = 0.5 * elementDisplacements.dot(mTerms->SMShear   * elementDisplacements);
+		mShearEnergy += mSeparatedEnergies(1,lcIndex);
+		mSeparatedEnergies(2,lcIndex) = 0.5 * elementDisplacements.dot(mTerms->SMBending * elementDisplacements);
+		mBendEnergy += mSeparatedEnergies(2,lcIndex);
 
 		// stress calculation - NOTE: only in-plane stresses are considered (dKQ stresses are ignored) because of the application in topology optimization, in which stress gradients over the thickness of the element cannot be considered in a 2D case
-		Eigen::VectorXd elementDisp24DOF;
-		elementDisp24DOF.setZero(24);
-		elementDisp24DOF = mT * elementDisplacements;
-		melementDisp8DOF.setZero(8);
+		element_vector elementDisp24DOF = mTerms->T * elementDisplacements;
 		for (int i = 0; i < 4; ++i) // for all nodes of this element
 		{
 			for (int j = 0; j < 2; ++j) // for the first two DOF's in local system (disp x & y)
@@ -331,21 +302,14 @@ namespace bso { namespace structural_design { namespace element {
 				melementDisp8DOF(i*2 + j) = elementDisp24DOF(i*6 + j);
 			}
 		}
-		mBAv.setZero(3,8);
-		mBAv = (1.0/4) * (mB1 + mB2 + mB3 + mB4); // average B-matrix
-		Eigen::VectorXd StrainAv;
-		StrainAv.setZero(3);
-		StrainAv = mBAv * melementDisp8DOF; // average strain
-		mStress = mETermSolid * StrainAv; // average stress per element (averaged over 4 integration points)
-
-		mE0K0U.setZero(24);
-		mE0K0U = (mE0 / mE) * mSM * elementDisplacements; // for stress sensitivity
-	} // computeResponse()
+		Eigen::Vector3d StrainAv = mTerms->BAv * melementDisp8DOF; // average strain
+		mStress = mTerms->ETermSolid * StrainAv; // average stress per element (averaged over 4 integration points)
+	} // evaluateResponse()
 	
 	void flat_shell::clearResponse()
 	{
 		element::clearResponse();
-		mSeparatedEnergies.clear();
+		mSeparatedEnergies.setZero(); // keeps the storage for the next solve
 		mTotalEnergy = 0;
 		mShearEnergy = 0;
 		mAxialEnergy = 0;
@@ -370,7 +334,8 @@ namespace bso { namespace structural_design { namespace element {
 			}
 		}
 		
-		if (mSeparatedEnergies.find(lc) == mSeparatedEnergies.end())
+		long lcIndex = this->findLoadCase(lc);
+		if (lcIndex < 0 || lcIndex >= mSeparatedEnergies.cols())
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nError, when retrieving energies from a flat shell element.\n"
@@ -379,7 +344,10 @@ namespace bso { namespace structural_design { namespace element {
 			throw std::invalid_argument(errorMessage.str());
 		}
 		
-		if (mSeparatedEnergies.find(lc)->second.find(type) == mSeparatedEnergies.find(lc)->second.end())
+		if (type == "normal") return mSeparatedEnergies(0,lcIndex);
+		else if (type == "shear") return mSeparatedEnergies(1,lcIndex);
+		else if (type == "bending") return mSeparatedEnergies(2,lcIndex);
+		else
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nError, when retrieving energies from a flat shell element.\n"
@@ -387,8 +355,6 @@ namespace bso { namespace structural_design { namespace element {
 									 << "(bso/structural_design/element/flat_shell.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		
-		return mSeparatedEnergies.find(lc)->second.find(type)->second;
 	} // getEnergy
 	
 	double flat_shell::getTotalEnergy(const std::string& type /*= ""*/) const
@@ -418,7 +384,23 @@ namespace bso { namespace structural_design { namespace element {
 			throw std::invalid_argument(errorMessage.str());
 		}
 	}
-	
+
+	double flat_shell::getStrainEnergy(const Eigen::VectorXd& u, const std::string& type /*= ""*/) const
+	{ // separated as in evaluateResponse()
+		if (type == "") return element::getStrainEnergy(u);
+		else if (type == "axial") return 0.5 * u.dot(mTerms->SMNormal * u);
+		else if (type == "shear") return 0.5 * u.dot(mTerms->SMShear * u);
+		else if (type == "bending") return 0.5 * u.dot(mTerms->SMBending * u);
+		else
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, when computing the energy of displacements of a flat shell element.\n"
+									 << "Could not compute separated strain energy of type: " << type << "\n"
+									 << "(bso/structural_design/element/flat_shell.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+	} // getStrainEnergy()
+
 	double flat_shell::getProperty(std::string var) const
 	{ //
 		if (var == "thickness") return mThickness;
@@ -461,14 +443,14 @@ namespace bso { namespace structural_design { namespace element {
 		w << 1, 1, 0;
 		Eigen::VectorXd W0;
 		W0.setZero(8);
-		W0 = mBAv.transpose() * mETermSolid.transpose() * w;
+		W0 = mTerms->BAv.transpose() * mTerms->ETermSolid.transpose() * w;
 		Eigen::Matrix3d V;
 		V << 1, -0.5, 0,
 			 -0.5, 1, 0,
 			 0, 0, 3;
 		Eigen::MatrixXd M0;
 		M0.setZero(8,8);
-		M0 = mBAv.transpose() * mETermSolid.transpose() * V * mETermSolid * mBAv;
+		M0 = mTerms->BAv.transpose() * mTerms->ETermSolid.transpose() * V * mTerms->ETermSolid * mTerms->BAv;
 
 		Eigen::VectorXd aeloc;
 		aeloc.setZero(8);
@@ -485,7 +467,7 @@ namespace bso { namespace structural_design { namespace element {
 				++counterAeloc;
 			}
 		}
-		ae24DOFt = mT.transpose() * ae24DOF;
+		ae24DOFt = mTerms->T.transpose() * ae24DOF;
 
 		Eigen::VectorXd ae;
 		ae.setZero(freeDOFs);
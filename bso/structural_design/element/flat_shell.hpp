@@ -3,9 +3,19 @@
 
 namespace bso { namespace structural_design { namespace element {
 	
-	class flat_shell : public bso::utilities::geometry::quadrilateral,
-										 public element
+	class flat_shell final : public bso::utilities::geometry::quadrilateral,
+										 public sized_element<24>
 	{
+	public:
+		struct stiffness_terms
+		{ // the terms that only depend on the geometry and the thickness and material parameters
+			Eigen::MatrixXd SM; // the element stiffness matrix in the global coordinate system
+			stiffness_matrix SMNormal, SMShear, SMBending; // its normal, shear and bending parts
+			stiffness_matrix T; // transformation from the global to the local coordinate system
+			Eigen::Matrix3d ETermSolid; // normal- and shear terms
+			Eigen::Matrix<double,3,8> BAv; // average (strain-displacement) matrix for in-plane behaviour
+		};
+		typedef stiffness_cache<stiffness_terms> terms_cache; // shared by congruent flat shells
 	private:
 		double mThickness;
 		double mPoisson;
@@ -14,21 +24,16 @@ namespace bso { namespace structural_design { namespace element {
 		double mAxialEnergy;
 		double mBendEnergy;
 		
-		Eigen::MatrixXd mSMNormal;
-		Eigen::MatrixXd mSMShear;
-		Eigen::MatrixXd mSMBending;
-		
-		Eigen::MatrixXd mT;
-		Eigen::MatrixXd mETermSolid; // 3x3 matrix with normal- and shear terms
-		Eigen::MatrixXd mB1, mB2, mB3, mB4, mBAv; // 3x8 (strain-displacement) matrices for in-plane behaviour
+		std::shared_ptr<const stiffness_terms> mTerms;
 		
-		std::map<load_case, std::map<std::string, double>> mSeparatedEnergies;
-		Eigen::VectorXd melementDisp8DOF;
+		Eigen::Matrix<double,3,Eigen::Dynamic> mSeparatedEnergies; // normal, shear and bending energy, per column of the responses
+		Eigen::Matrix<double,8,1> melementDisp8DOF;
 		Eigen::Vector3d mStress;
-		Eigen::VectorXd mE0K0U;
+		element_vector mE0K0U;
 		
 		template<class CONTAINER>
 		void deriveStiffnessMatrix(CONTAINER& l);
+		std::shared_ptr<const stiffness_terms> deriveStiffnessTerms() const;
 	public:
 		template<class CONTAINER>
 		flat_shell(const unsigned long& ID, const double& E, const double& thickness, const double& poisson,
@@ -37,11 +42,15 @@ namespace bso { namespace structural_design { namespace element {
 							 std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6, const double geomTol = 1e-3);
 		~flat_shell();
 		
-		void computeResponse(load_case lc);
+		void evaluateResponse(const unsigned long& lcIndex);
 		void clearResponse();
 		
 		const double& getEnergy(load_case lc, const std::string& type = "") const;
 		double getTotalEnergy(const std::string& type = "") const;
+		double getStrainEnergy(const Eigen::VectorXd& u, const std::string& type = "") const;
+		const double& getAxialEnergy() const {return mAxialEnergy;}
+		const double& getShearEnergy() const {return mShearEnergy;}
+		const double& getBendingEnergy() const {return mBendEnergy;}
 		
 		double getProperty(std::string var) const;
 		double getVolume() const;
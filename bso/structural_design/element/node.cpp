@@ -1,12 +1,15 @@
 #ifndef SD_NODE_CPP
 #define SD_NODE_CPP
 
+#include <mutex>
+
 namespace bso { namespace structural_design { namespace element {
 
 	void node::initializeVariables()
 	{
 		mConstraints.setZero();
 		mNFS.setZero();
+		mNFT.setConstant(-1);
 	} // initializeVariables
 
 	node::node(const std::initializer_list<double>&& l, const unsigned long& ID) :
@@ -30,6 +33,8 @@ namespace bso { namespace structural_design { namespace element {
 	
 	void node::updateNFS(const Eigen::Vector6i& EFS)
 	{  // updates the nodal freedom signature with that of an element's node
+		static std::mutex NFSMutex; // elements that share this node may be created in parallel
+		std::lock_guard<std::mutex> lock(NFSMutex);
 		for (unsigned int i = 0; i < 6; ++i)
 		{
 			if (EFS[i] == 1)
@@ -63,22 +68,19 @@ namespace bso { namespace structural_design { namespace element {
 	} //
 	
 	void node::addDisplacements(const std::map<component::load_case, Eigen::VectorXd>& displacements)
-	{
-		mDisplacements.clear();
+	{ // the displacements are kept by this node, and take precedence over those of its system
+		auto responses = std::make_shared<response_buffer>();
+		responses->getDisplacements().setZero(6,0);
 		for (const auto& i : displacements)
 		{
-			Eigen::Vector6d tempDisplacements;
-			tempDisplacements.setZero();
+			unsigned long column = responses->addLoadCase(i.first);
 			for (unsigned int j = 0; j < 6; ++j)
 			{
-				if (mNFS(j) == 1 && mConstraints(j) == 0)
-				{
-					tempDisplacements(j) = i.second[mNFT[j]];
-				}
+				if (mNFT(j) >= 0) responses->getDisplacements()(j,column) = i.second[mNFT(j)];
 			}
-			mDisplacements[i.first] = tempDisplacements;
 		}
-	}
+		mOwnResponses = responses;
+	} // addDisplacements()
 	
 	void node::addLoadCase(load_case lc)
 	{
@@ -86,14 +88,15 @@ namespace bso { namespace structural_design { namespace element {
 	} // addLoadCase()
 	
 	void node::clearDisplacements()
-	{ // 
-		mDisplacements.clear();
+	{ // the displacements of a node in a system are cleared by the system
+		mOwnResponses.reset();
 	} // clearDisplacements()
 	
 	Eigen::Vector6d node::getDisplacements(component::load_case lc) const
 	{
-		auto lcSearch = mDisplacements.find(lc);
-		if (lcSearch == mDisplacements.end())
+		const response_buffer* responses = (mOwnResponses) ? mOwnResponses.get() : mResponses;
+		long column = (responses != nullptr) ? responses->findLoadCase(lc) : -1;
+		if (column < 0)
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nError, could not access displacements for load case:\n"
@@ -102,9 +105,21 @@ namespace bso { namespace structural_design { namespace element {
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
-		return lcSearch->second; 
+		if (mOwnResponses) return mOwnResponses->getDisplacements().col(column);
+		return this->getDisplacements((unsigned long)column);
 	}
 	
+	Eigen::Vector6d node::getDisplacements(const unsigned long& lcIndex) const
+	{ // gathers the displacements from the rows of the free DOFs
+		Eigen::Vector6d displacements = Eigen::Vector6d::Zero();
+		const Eigen::MatrixXd& globalDisplacements = mResponses->getDisplacements();
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			if (mNFT(i) >= 0) displacements(i) = globalDisplacements(mNFT(i),lcIndex);
+		}
+		return displacements;
+	} // getDisplacements()
+	
 	Eigen::Vector6d node::getLoads(component::load_case lc) const
 	{
 		auto lcSearch = mLoads.find(lc);
@@ -161,8 +176,9 @@ namespace bso { namespace structural_design { namespace element {
 		{
 			if (mNFS(i) == 1 && mConstraints(i) == 0)
 			{
-				mNFT[i] = NFM++;
+				mNFT(i) = NFM++;
 			}
+			else mNFT(i) = -1;
 		}
 	} // generateNFT()
 	
@@ -185,14 +201,14 @@ namespace bso { namespace structural_design { namespace element {
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		if (mNFT.find(localDOF) == mNFT.end())
+		if (mNFT(localDOF) < 0)
 		{
 			std::stringstream errorMessage;
 			errorMessage << "Error, could not find the global DOF from a node.\n"
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		return mNFT.find(localDOF)->second;
+		return mNFT(localDOF);
 	} //
 	
 	bool node::checkLoad(component::load_case lc, const unsigned int& localDOF, double& load) const
@@ -2,15 +2,18 @@
 #define SD_NODE_HPP
 
 #include <bso/structural_design/component/load.hpp>
+#include <bso/structural_design/element/response_buffer.hpp>
 #include <bso/utilities/geometry.hpp>
 
 #include <Eigen/Dense>
 
 #include <map>
+#include <memory>
 #include <stdexcept>
 
 namespace Eigen {typedef Matrix<int, 6, 1> Vector6i;}
 namespace Eigen {typedef Matrix<double, 6, 1> Vector6d;}
+namespace Eigen {typedef Matrix<long, 6, 1> Vector6l;}
 
 namespace bso { namespace structural_design { namespace element {
 
@@ -18,11 +21,12 @@ namespace bso { namespace structural_design { namespace element {
 	{
 	private:
 		unsigned long mID;
-		std::map<unsigned int, unsigned long> mNFT; // nodal freedom table, contains the global indices of the node's DOFs
+		Eigen::Vector6l mNFT; // nodal freedom table, contains the global indices of the node's DOFs, -1 if a DOF is not free
 		Eigen::Vector6i mNFS; // nodal freedom signature, for each local DOF index, contains info if it is active or not
 		Eigen::Vector6i mConstraints; // constraints, for each local DOF index, contains if it is constrained or not
 		std::map<component::load_case, Eigen::Vector6d> mLoads; // indexe dby load case, contains for each local DOF index, the magnitude of the load
-		std::map<component::load_case, Eigen::Vector6d> mDisplacements; // indexed by load case, contains for each local DOF index, the magnitude of the displacement
+		const response_buffer* mResponses = nullptr; // responses of the system this node is in, its displacements are at the rows of mNFT
+		std::shared_ptr<const response_buffer> mOwnResponses; // displacements added to this node only, at the rows of the local DOFs
 		
 		void initializeVariables();
 	public:
@@ -33,11 +37,13 @@ namespace bso { namespace structural_design { namespace element {
 		void updateNFS(const Eigen::Vector6i& EFS); // updates the nodal freedom signature with that of an element
 		void addConstraint(const unsigned int& localDOF); // adds a constraint to the local DOF
 		void addLoad(const load& l);
-		void addDisplacements(const std::map<component::load_case, Eigen::VectorXd>& displacements);
+		void setResponseBuffer(const response_buffer* responses) {mResponses = responses;}
+		void addDisplacements(const std::map<component::load_case, Eigen::VectorXd>& displacements); // for a node that is not in a system
 		void addLoadCase(load_case lc);
 		void clearDisplacements();
 
 		Eigen::Vector6d getDisplacements(component::load_case lc) const;
+		Eigen::Vector6d getDisplacements(const unsigned long& lcIndex) const; // from column lcIndex of the response buffer
 		Eigen::Vector6d getLoads(component::load_case lc) const;
 		const int& getConstraint(const unsigned int& n) const;
 		const int& getNFS(const unsigned int& n) const;
@@ -20,6 +20,19 @@ namespace bso { namespace structural_design { namespace element {
 			}
 		}
 		
+		// share the stiffness terms of a congruent hexahedron, or derive them
+		terms_cache::key key;
+		for (const auto& i : {mE, mPoisson}) terms_cache::addParameter(key,i);
+		terms_cache::addGeometry(key,mVertices);
+		mTerms = terms_cache::instance().find(key,[this](){return this->deriveStiffnessTerms();});
+		mOriginalSM = std::shared_ptr<const Eigen::MatrixXd>(mTerms,&mTerms->SM);
+	}
+	
+	std::shared_ptr<const quad_hexahedron::stiffness_terms> quad_hexahedron::deriveStiffnessTerms() const
+	{
+		auto terms = std::make_shared<stiffness_terms>();
+		stiffness_matrix& T = terms->T;
+		
 		// create the transformation matrix (this contains the orientations of the flat shell)
 		bso::utilities::geometry::vector vx, vy, vz;
 		vx = (mVertices[1] + mVertices[2] + mVertices[5] + mVertices[6])/4 - this->getCenter();
@@ -29,26 +42,24 @@ namespace bso { namespace structural_design { namespace element {
 		vz = vx.cross(vy).normalized();
 		vy = vz.cross(vx).normalized(); // make vy orthogonal to vx
 
-		mT.setZero(24,24);
+		T.setZero();
 		Eigen::Matrix3d lambda;
 		lambda << vx, vy, vz;
 
 		for (int i = 0; i < 8; i++)
 		{ // for each node
 			// add the transformation term lambda
-			mT.block<3,3>((i)*3,(i)*3) = lambda.transpose();
+			T.block<3,3>((i)*3,(i)*3) = lambda.transpose();
 		}
 		
-		Eigen::MatrixXd locCoords;
-		locCoords.setZero(8,3);
+		Eigen::Matrix<double,8,3> locCoords;
 		
 		for (unsigned int i = 0; i < 8; ++i)
 		{
 			locCoords.row(i) = lambda.transpose() * mVertices[i];
 		}
 		
-		Eigen::MatrixXd ETerm;
-		ETerm.setZero(6,6);
+		Eigen::Matrix<double,6,6> ETerm = Eigen::Matrix<double,6,6>::Zero();
 
 		ETerm(0,0) = mPoisson - 1; 	 ETerm(0,1) = -mPoisson; 			ETerm(0,2) = -mPoisson; // first 3 elements of the first row
 		ETerm(1,0) = -mPoisson;    	 ETerm(1,1) = mPoisson - 1; 	ETerm(1,2) = -mPoisson; // first 3 elements of the second row
@@ -58,11 +69,11 @@ namespace bso { namespace structural_design { namespace element {
 		ETerm = ETerm * (mE / (2 * pow(mPoisson,2) + mPoisson - 1));
 
 		// save elasticity matrix (for a solid element, for stress_based topology optimization)
-		mETermSolid.setZero(6,6);
-		mETermSolid = ETerm * (mE0 / mE);
+		terms->ETermSolid = ETerm * (mE0 / mE);
 
 		// initialise the element stiffness matrices and start numerical integration of the contribution of every node to the element's stiffness
-		mSM.setZero(24,24);
+		stiffness_matrix K = stiffness_matrix::Zero();
+		Eigen::Matrix<double,6,24> BSum = Eigen::Matrix<double,6,24>::Zero();
 		double ksi, eta, zeta;
 		double wKsi, wEta, wZeta;
 		for (int l = 0; l < 2; ++l)
@@ -104,8 +115,7 @@ namespace bso { namespace structural_design { namespace element {
 					}
 
 					// compute the derivatives of the displacements with respect to the natural coordinates (ksi, eta and zeta)
-					Eigen::MatrixXd dN;
-					dN.setZero(3,8);
+					Eigen::Matrix<double,3,8> dN;
 
 					dN(0,0) = (-1.0/8.0)*(1-eta)*(1-zeta);	dN(1,0) = (-1.0/8.0)*(1-ksi)*(1-zeta);	dN(2,0) = (-1.0/8.0)*(1-ksi)*(1-eta);
 					dN(0,1) = ( 1.0/8.0)*(1-eta)*(1-zeta);	dN(1,1) = (-1.0/8.0)*(1+ksi)*(1-zeta);	dN(2,1) = (-1.0/8.0)*(1+ksi)*(1-eta);
@@ -117,13 +127,11 @@ namespace bso { namespace structural_design { namespace element {
 					dN(0,7) = (-1.0/8.0)*(1+eta)*(1+zeta);	dN(1,7) = ( 1.0/8.0)*(1-ksi)*(1+zeta);	dN(2,7) = ( 1.0/8.0)*(1-ksi)*(1+eta);
 
 					// compute the matrix of Jacobi to map between derivatives of the element shape with respect to natural and local coordinates (ksi, eta, zeta versus x_loc, y_loc, z_loc)
-					Eigen::MatrixXd J, JInverse;
-					J = dN * locCoords; // 3 by 3 matrix, matrix of Jacobi
-					JInverse = J.inverse(); // also 3 by 3 matrix, the inverse of the matrix of Jacobi
+					Eigen::Matrix3d J = dN * locCoords; // matrix of Jacobi
+					Eigen::Matrix3d JInverse = J.inverse(); // the inverse of the matrix of Jacobi
 
 					// compute the constitutive relation between strain and nodal displacements in the natural coordinate system (ksi, eta, zeta)
-					Eigen::MatrixXd A;
-					A.setZero(6,9);
+					Eigen::Matrix<double,6,9> A = Eigen::Matrix<double,6,9>::Zero();
 
 					A(0,0) = JInverse(0,0); A(0,1) = JInverse(0,1); A(0,2) = JInverse(0,2); // du/dx --> epsilon[x]
 					A(1,3) = JInverse(1,0); A(1,4) = JInverse(1,1); A(1,5) = JInverse(1,2); // dv/dy --> epsilon[y]
@@ -139,8 +147,7 @@ namespace bso { namespace structural_design { namespace element {
 					A(5,0) = JInverse(2,0); A(5,1) = JInverse(2,1); A(5,2) = JInverse(2,2); // du/dz --> gamma[zx]
 
 					// compute the relation between displacements in the local coordinate system (x_loc, y_loc, z_loc) and the natural coordinate system (ksi, eta, zeta)
-					Eigen::MatrixXd G;
-					G.setZero(9,24);
+					Eigen::Matrix<double,9,24> G = Eigen::Matrix<double,9,24>::Zero();
 
 					for (unsigned int i = 0; i < 8; i++)
 					{ // for each node
@@ -154,35 +161,29 @@ namespace bso { namespace structural_design { namespace element {
 					}
 
 					// compute the derivatives of the displacement with respect to the local coordinates (x_loc, y_loc, z_loc) i.e. the strains in the element
-					Eigen::MatrixXd B;
-					B = A*G; // 6 by 24 matrix
+					Eigen::Matrix<double,6,24> B = A*G;
 
 					// save sum of strain-displacement matrices of each integration points
-					if (l == 0 && m == 0 && n == 0)
-					{
-						mBSum.setZero(6,24);
-					}
-					mBSum += B;
+					BSum += B;
 
-					mSM += wKsi*wEta*wZeta*B.transpose()*ETerm*B*J.determinant(); // sum for all integration points (Gauss Quadrature)
+					K.noalias() += (wKsi*wEta*wZeta*J.determinant())*(B.transpose()*ETerm*B); // sum for all integration points (Gauss Quadrature)
 
 				} // end for n (zeta)
 			} // end for m (eta)
 		} // end for l (ksi)
 
 		// transform the element stiffness matrix from local to global coordinate system
-		mSM = mT.transpose() * mSM * mT;
-		//if (mSM(0,0) < 0) mSM *= -1;
-		mOriginalSM = mSM;
-		
-	}
+		terms->SM = T.transpose() * K * T;
+		terms->BAv = (1.0/8) * BSum; // average B-matrix
+		return terms;
+	} // deriveStiffnessTerms()
 	
 	template<class CONTAINER>
 	quad_hexahedron::quad_hexahedron(const unsigned long& ID, const double& E, const double& poisson,
 																	 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/,
 																	 const double geomTol /* = 1e-3*/)
 	: bso::utilities::geometry::quad_hexahedron(derived_ptr_to_vertex(l), geomTol),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<24>(ID, E, ERelativeLowerBound)
 	{ // 
 		
 		mIsQuadHexahedron = true;
@@ -195,7 +196,7 @@ namespace bso { namespace structural_design { namespace element {
 																	 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/,
 																	 const double geomTol /* = 1e-3*/)
 	: bso::utilities::geometry::quad_hexahedron(derived_ptr_to_vertex(l), geomTol),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<24>(ID, E, ERelativeLowerBound)
 	{ // 
 		
 		mIsQuadHexahedron = true;
@@ -209,18 +210,16 @@ namespace bso { namespace structural_design { namespace element {
 		
 	} // dtor
 
-	void quad_hexahedron::computeResponse(load_case lc)
+	void quad_hexahedron::evaluateResponse(const unsigned long& lcIndex)
 	{ //
-		element::computeResponse(lc);
+		element_vector u;
+		this->gatherDisplacements(lcIndex,u);
+		this->addEnergy(lcIndex, 0.5 * this->getStiffnessFactor() * u.dot(this->getFixedOriginalSM() * u));
 		// calculate stress of solid element at centroid
-		mBAv = (1.0/8) * mBSum; // average B-matrix
-		mDispLoc.setZero(24);
-		mDispLoc = mT * mDisplacements[lc];
-		Eigen::VectorXd StrainAv;
-		StrainAv.setZero(6);
-		StrainAv = mBAv * mDispLoc; // average strain
-		mStress = mETermSolid * StrainAv; // average stress per element (averaged over 2x2x2 integration points)
-	} // computeResponse()
+		mDispLoc = mTerms->T * u;
+		Eigen::Vector6d StrainAv = mTerms->BAv * mDispLoc; // average strain
+		mStress = mTerms->ETermSolid * StrainAv; // average stress per element (averaged over 2x2x2 integration points)
+	} // evaluateResponse()
 
 	double quad_hexahedron::getProperty(std::string var) const
 	{ //
@@ -271,7 +270,7 @@ namespace bso { namespace structural_design { namespace element {
 		w << 1, 1, 1, 0, 0, 0;
 		Eigen::VectorXd W0;
 		W0.setZero(24);
-		W0 = mBAv.transpose() * mETermSolid.transpose() * w;
+		W0 = mTerms->BAv.transpose() * mTerms->ETermSolid.transpose() * w;
 		Eigen::MatrixXd V;
 		V.setZero(6,6);
 		V(0,0) = 1.0;	V(0,1) = -0.5;	V(0,2) = -0.5;
@@ -280,12 +279,12 @@ namespace bso { namespace structural_design { namespace element {
 		V(3,3) = 3.0;	V(4,4) = 3.0;	V(5,5) = 3.0;
 		Eigen::MatrixXd M0;
 		M0.setZero(24,24);
-		M0 = mBAv.transpose() * mETermSolid.transpose() * V * mETermSolid * mBAv;
+		M0 = mTerms->BAv.transpose() * mTerms->ETermSolid.transpose() * V * mTerms->ETermSolid * mTerms->BAv;
 
 		Eigen::VectorXd aeloc, aeglob;
 		aeloc.setZero(24); aeglob.setZero(24);
 		aeloc = (M0.transpose() * mDispLoc) / sqrt(3.0 * mDispLoc.transpose() * M0 * mDispLoc) + alpha * W0;
-		aeglob = mT.transpose() * aeloc;
+		aeglob = mTerms->T.transpose() * aeloc;
 
 		Eigen::VectorXd ae;
 		ae.setZero(freeDOFs);
@@ -307,7 +306,7 @@ namespace bso { namespace structural_design { namespace element {
 	// Sensitivity calculation is based on the theory in:
 	// Luo, Y., & Kang, Z. (2012). Topology optimization of continuum structures with Drucker-Prager yield stress constraints. Computers & Structures, 90-91, pp. 65-75. https://doi.org/10.1016/j.compstruc.2011.10.008
 	{
-		Eigen::VectorXd dKdxU = (-penal / beta) * pow(mDensity,penal - 1) * (mE0 / mE) * mSM * mDispLoc;
+		Eigen::VectorXd dKdxU = (-penal / beta) * pow(mDensity,penal - 1) * (*mOriginalSM) * mDispLoc;
 		Eigen::MatrixXd lamdaloc;
 		lamdaloc.setZero(24,Lamda.cols());
 		Eigen::VectorXd dsx(Lamda.cols()); // dsx = vector with sensitivities for varying constraints, but to same x
@@ -3,20 +3,28 @@
 
 namespace bso { namespace structural_design { namespace element {
 	
-	class quad_hexahedron : public bso::utilities::geometry::quad_hexahedron,
-													public element
+	class quad_hexahedron final : public bso::utilities::geometry::quad_hexahedron,
+													public sized_element<24>
 	{
+	public:
+		struct stiffness_terms
+		{ // the terms that only depend on the geometry and the material parameters
+			Eigen::MatrixXd SM; // the element stiffness matrix in the global coordinate system
+			stiffness_matrix T; // transformation from the global to the local coordinate system
+			Eigen::Matrix<double,6,6> ETermSolid; // normal- and shear elasticity terms
+			Eigen::Matrix<double,6,24> BAv; // average of the strain-displacement matrices in each integration point
+		};
+		typedef stiffness_cache<stiffness_terms> terms_cache; // shared by congruent hexahedra
 	private:
 		double mPoisson;
 		
-		Eigen::MatrixXd mT;
-		Eigen::MatrixXd mETermSolid; // 6x6 matrix with normal- and shear elasticity terms
-		Eigen::MatrixXd mBSum, mBAv; // sum and average of strain-displacement matrices in each integration point
-		Eigen::VectorXd mDispLoc;
+		std::shared_ptr<const stiffness_terms> mTerms;
+		element_vector mDispLoc;
 		Eigen::Vector6d mStress;
 
 		template<class CONTAINER>
 		void deriveStiffnessMatrix(CONTAINER& l);
+		std::shared_ptr<const stiffness_terms> deriveStiffnessTerms() const;
 	public:
 		template<class CONTAINER>
 		quad_hexahedron(const unsigned long& ID, const double& E, const double& poisson,
@@ -27,7 +35,7 @@ namespace bso { namespace structural_design { namespace element {
 										const double geomTol = 1e-3);
 		~quad_hexahedron();
 
-		void computeResponse(load_case lc);
+		void evaluateResponse(const unsigned long& lcIndex);
 
 		double getProperty(std::string var) const;
 		double getVolume() const;
@@ -0,0 +1,48 @@
+#ifndef SD_RESPONSE_BUFFER_CPP
+#define SD_RESPONSE_BUFFER_CPP
+
+namespace bso { namespace structural_design { namespace element {
+
+	response_buffer::response_buffer()
+	{
+
+	} // ctor
+
+	response_buffer::~response_buffer()
+	{
+
+	} // dtor
+
+	void response_buffer::setLoadCases(const std::vector<load_case>& loadCases)
+	{ // the size of the displacements and energies is set by the owner of the buffer
+		mLoadCases = loadCases;
+	} // setLoadCases()
+
+	unsigned long response_buffer::addLoadCase(const load_case& lc)
+	{
+		long column = this->findLoadCase(lc);
+		if (column >= 0) return column;
+
+		mLoadCases.push_back(lc);
+		unsigned long n = mLoadCases.size();
+		mDisplacements.conservativeResize(Eigen::NoChange,n);
+		mDisplacements.col(n-1).setZero();
+		mEnergies.conservativeResize(Eigen::NoChange,n);
+		mEnergies.col(n-1).setZero();
+		return n-1;
+	} // addLoadCase()
+
+	long response_buffer::findLoadCase(const load_case& lc) const
+	{ // there are only a few load cases, a linear search is faster than a map
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
+		{
+			if (mLoadCases[i] == lc) return i;
+		}
+		return -1;
+	} // findLoadCase()
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_RESPONSE_BUFFER_CPP
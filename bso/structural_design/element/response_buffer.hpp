@@ -0,0 +1,46 @@
+#ifndef SD_RESPONSE_BUFFER_HPP
+#define SD_RESPONSE_BUFFER_HPP
+
+#include <bso/structural_design/component/load.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace element {
+
+	/*
+	 * The responses of the nodes and elements of a system, stored contiguously with one column per
+	 * load case. Nodes refer to the rows of the displacements by their global DOFs, and elements
+	 * to the rows of the energies by their index in the system. Post processing a solve then needs
+	 * no lookups per node or element, and repeated solves reuse the same storage.
+	 */
+
+	class response_buffer
+	{
+	private:
+		std::vector<load_case> mLoadCases; // the load case of each column
+		Eigen::MatrixXd mDisplacements; // DOF x load case
+		Eigen::MatrixXd mEnergies; // element x load case
+	public:
+		response_buffer();
+		~response_buffer();
+
+		void setLoadCases(const std::vector<load_case>& loadCases);
+		unsigned long addLoadCase(const load_case& lc); // returns its column, a new load case gets a zero column
+		long findLoadCase(const load_case& lc) const; // returns its column, or -1 if it is not in the buffer
+
+		const std::vector<load_case>& getLoadCases() const {return mLoadCases;}
+		const Eigen::MatrixXd& getDisplacements() const {return mDisplacements;}
+		Eigen::MatrixXd& getDisplacements() {return mDisplacements;}
+		const Eigen::MatrixXd& getEnergies() const {return mEnergies;}
+		Eigen::MatrixXd& getEnergies() {return mEnergies;}
+	};
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/response_buffer.cpp>
+
+#endif // SD_RESPONSE_BUFFER_HPP
@@ -0,0 +1,31 @@
+#ifndef SD_SIZED_ELEMENT_CPP
+#define SD_SIZED_ELEMENT_CPP
+
+namespace bso { namespace structural_design { namespace element {
+	
+	template <unsigned int N>
+	sized_element<N>::sized_element(const unsigned long& ID, const double& E,
+		const double& ERelativeLowerBound /*= 1e-6*/) : element(ID, E, ERelativeLowerBound)
+	{
+		
+	} // ctor
+	
+	template <unsigned int N>
+	sized_element<N>::~sized_element()
+	{
+		
+	} // dtor
+	
+	template <unsigned int N>
+	void sized_element<N>::evaluateResponse(const unsigned long& lcIndex)
+	{ // as element::evaluateResponse(), with fixed size products
+		element_vector u;
+		this->gatherDisplacements(lcIndex,u);
+		this->addEnergy(lcIndex, 0.5 * this->getStiffnessFactor() * u.dot(this->getFixedOriginalSM() * u));
+	} // evaluateResponse()
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_SIZED_ELEMENT_CPP
@@ -0,0 +1,37 @@
+#ifndef SD_SIZED_ELEMENT_HPP
+#define SD_SIZED_ELEMENT_HPP
+
+#include <bso/structural_design/element/element.hpp>
+#include <bso/structural_design/element/stiffness_cache.hpp>
+
+namespace bso { namespace structural_design { namespace element {
+	
+	/*
+	 * Element with N DOFs, known at compile time. The derived elements derive their stiffness
+	 * matrix with fixed size types, and the response is evaluated with a fixed size view on
+	 * mOriginalSM, so neither allocates temporaries on the heap.
+	 */
+	
+	template <unsigned int N>
+	class sized_element : public element
+	{
+	public:
+		typedef Eigen::Matrix<double,N,N> stiffness_matrix;
+		typedef Eigen::Matrix<double,N,1> element_vector;
+		static constexpr unsigned int DOFCount = N;
+	protected:
+		Eigen::Map<const stiffness_matrix> getFixedOriginalSM() const {return Eigen::Map<const stiffness_matrix>(mOriginalSM->data());}
+	public:
+		sized_element(const unsigned long& ID, const double& E, const double& ERelativeLowerBound = 1e-6);
+		virtual ~sized_element();
+		
+		virtual void evaluateResponse(const unsigned long& lcIndex);
+	};
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/sized_element.cpp>
+
+#endif // SD_SIZED_ELEMENT_HPP
@@ -0,0 +1,122 @@
+#ifndef SD_STIFFNESS_CACHE_CPP
+#define SD_STIFFNESS_CACHE_CPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace bso { namespace structural_design { namespace element {
+	
+	template <class TERMS>
+	stiffness_cache<TERMS>::stiffness_cache() : mEnabled(true)
+	{
+		
+	} // ctor
+	
+	template <class TERMS>
+	stiffness_cache<TERMS>& stiffness_cache<TERMS>::instance()
+	{ // one cache per type of terms, shared by all models
+		static stiffness_cache<TERMS> cache;
+		return cache;
+	} // instance()
+	
+	template <class TERMS>
+	void stiffness_cache<TERMS>::addParameter(key& k, const double& value)
+	{ // parameters are compared exactly, by their bit pattern
+		long long bits;
+		std::memcpy(&bits, &value, sizeof(double));
+		k.push_back(bits);
+	} // addParameter()
+	
+	template <class TERMS>
+	template <class CONTAINER>
+	void stiffness_cache<TERMS>::addGeometry(key& k, const CONTAINER& vertices)
+	{ // coordinates relative to the first vertex, so that the key does not depend on the element's position
+		const auto& origin = *std::begin(vertices);
+		for (const auto& i : vertices)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				k.push_back(std::llround((i(j) - origin(j)) / mCoordinateQuantum));
+			}
+		}
+	} // addGeometry()
+	
+	template <class TERMS>
+	template <class DERIVE>
+	std::shared_ptr<const TERMS> stiffness_cache<TERMS>::find(const key& k, DERIVE derive)
+	{
+		if (!mEnabled) return derive();
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto search = mEntries.find(k);
+			if (search != mEntries.end())
+			{
+				if (auto terms = search->second.lock())
+				{
+					this->retain(terms);
+					return terms;
+				}
+			}
+		}
+		
+		// derive outside of the lock, elements are created in parallel
+		std::shared_ptr<const TERMS> terms = derive();
+		
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto& entry = mEntries[k];
+		if (auto other = entry.lock()) return other; // another thread derived the same terms in the mean time
+		entry = terms;
+		this->retain(terms);
+		if (mEntries.size() > mPruneSize)
+		{
+			for (auto i = mEntries.begin(); i != mEntries.end();)
+			{
+				if (i->second.expired()) i = mEntries.erase(i);
+				else ++i;
+			}
+			mPruneSize = std::max(mPruneSize, 2*(unsigned long)mEntries.size());
+		}
+		return terms;
+	} // find()
+	
+	template <class TERMS>
+	void stiffness_cache<TERMS>::retain(const std::shared_ptr<const TERMS>& terms)
+	{ // called with the mutex locked
+		if (mRetainedCount == 0) return;
+		if (!mRetained.empty() && mRetained.back() == terms) return;
+		mRetained.push_back(terms);
+		while (mRetained.size() > mRetainedCount) mRetained.pop_front();
+	} // retain()
+	
+	template <class TERMS>
+	void stiffness_cache<TERMS>::setRetainedCount(const unsigned long& n)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRetainedCount = n;
+		while (mRetained.size() > mRetainedCount) mRetained.pop_front();
+	} // setRetainedCount()
+	
+	template <class TERMS>
+	unsigned long stiffness_cache<TERMS>::size()
+	{ // the number of entries that are still in use
+		std::lock_guard<std::mutex> lock(mMutex);
+		unsigned long count = 0;
+		for (const auto& i : mEntries) if (!i.second.expired()) ++count;
+		return count;
+	} // size()
+	
+	template <class TERMS>
+	void stiffness_cache<TERMS>::clear()
+	{ // elements keep the terms they already share
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEntries.clear();
+		mRetained.clear();
+	} // clear()
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_STIFFNESS_CACHE_CPP
@@ -0,0 +1,64 @@
+#ifndef SD_STIFFNESS_CACHE_HPP
+#define SD_STIFFNESS_CACHE_HPP
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace element {
+	
+	/*
+	 * Content-addressed store of the terms an element type derives from its geometry and its
+	 * material and section parameters. The key holds those parameters exactly and the coordinates
+	 * of the element's vertices relative to its first vertex, rounded to mCoordinateQuantum. The
+	 * relative coordinates capture both the shape and the orientation of the element, so elements
+	 * that only differ by a translation share a single set of terms. Entries are held weakly, they
+	 * are freed with the last element that uses them, unless they are among the mRetainedCount
+	 * entries that were found last. Those outlive the models that use them.
+	 */
+	
+	template <class TERMS>
+	class stiffness_cache
+	{
+	public:
+		typedef std::vector<long long> key;
+	private:
+		std::map<key, std::weak_ptr<const TERMS> > mEntries;
+		std::mutex mMutex;
+		std::atomic<bool> mEnabled;
+		unsigned long mPruneSize = 1024; // expired entries are removed when the cache grows beyond this size
+		std::deque<std::shared_ptr<const TERMS> > mRetained; // the entries that were found last, held strongly
+		unsigned long mRetainedCount = 0;
+		
+		void retain(const std::shared_ptr<const TERMS>& terms);
+		
+		stiffness_cache();
+	public:
+		static constexpr double mCoordinateQuantum = 1e-6;
+		static stiffness_cache& instance();
+		stiffness_cache(const stiffness_cache& rhs) = delete;
+		stiffness_cache& operator = (const stiffness_cache& rhs) = delete;
+		
+		static void addParameter(key& k, const double& value);
+		template <class CONTAINER>
+		static void addGeometry(key& k, const CONTAINER& vertices);
+		template <class DERIVE>
+		std::shared_ptr<const TERMS> find(const key& k, DERIVE derive); // derive() is called on a miss
+		
+		void setEnabled(const bool& enabled) {mEnabled = enabled;}
+		void setRetainedCount(const unsigned long& n);
+		bool isEnabled() const {return mEnabled;}
+		unsigned long size();
+		void clear();
+	};
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/stiffness_cache.cpp>
+
+#endif // SD_STIFFNESS_CACHE_HPP
@@ -20,57 +20,57 @@ namespace bso { namespace structural_design { namespace element {
 		}
 
 		// initialising this elements stiffness matrix:
-		mSM.setZero(6,6);
+		stiffness_matrix K = stiffness_matrix::Zero();
 
 		// generate element stiffness matrix
 		bso::utilities::geometry::vector c = this->getVector().normalized();
 
 		// the geometric terms in the stiffness matrix ()
-		mSM(0,0) =  pow(c(0),2);
-		mSM(0,1) =  c(0)*c(1);
-		mSM(0,2) =  c(0)*c(2);
-		mSM(0,3) = -pow(c(0),2);
-		mSM(0,4) = -c(0)*c(1);
-		mSM(0,5) = -c(0)*c(2);
+		K(0,0) =  pow(c(0),2);
+		K(0,1) =  c(0)*c(1);
+		K(0,2) =  c(0)*c(2);
+		K(0,3) = -pow(c(0),2);
+		K(0,4) = -c(0)*c(1);
+		K(0,5) = -c(0)*c(2);
 
-		mSM(1,1) =  pow(c(1),2);
-		mSM(1,2) =  c(1)*c(2);
-		mSM(1,3) = -c(0)*c(1);
-		mSM(1,4) = -pow(c(1),2);
-		mSM(1,5) = -c(1)*c(2);
+		K(1,1) =  pow(c(1),2);
+		K(1,2) =  c(1)*c(2);
+		K(1,3) = -c(0)*c(1);
+		K(1,4) = -pow(c(1),2);
+		K(1,5) = -c(1)*c(2);
 
-		mSM(2,2) =  pow(c(2),2);
-		mSM(2,3) = -c(0)*c(2);
-		mSM(2,4) = -c(1)*c(2);
-		mSM(2,5) = -pow(c(2),2);
+		K(2,2) =  pow(c(2),2);
+		K(2,3) = -c(0)*c(2);
+		K(2,4) = -c(1)*c(2);
+		K(2,5) = -pow(c(2),2);
 
-		mSM(3,3) =  pow(c(0),2);
-		mSM(3,4) =  c(0)*c(1);
-		mSM(3,5) =  c(0)*c(2);
+		K(3,3) =  pow(c(0),2);
+		K(3,4) =  c(0)*c(1);
+		K(3,5) =  c(0)*c(2);
 
-		mSM(4,4) =  pow(c(1),2);
-		mSM(4,5) =  c(1)*c(2);
+		K(4,4) =  pow(c(1),2);
+		K(4,5) =  c(1)*c(2);
 
-		mSM(5,5) =  pow(c(2),2);
+		K(5,5) =  pow(c(2),2);
 
-		mSM *= ((mA*mE) / this->getLength()); // relate the geometric terms to the stiffness of this element
+		K *= ((mA*mE) / this->getLength()); // relate the geometric terms to the stiffness of this element
 
 		// m_SM is symmetric, this algorithm mirrors the above entries along the matrix diagonal
 		for (unsigned int i = 0; i < 6; ++i)
 		{
 			for (unsigned int j = i + 1; j < 6; ++j)
 			{
-				mSM(j,i) = mSM(i,j);
+				K(j,i) = K(i,j);
 			}
 		}
-		mOriginalSM = mSM;
+		mOriginalSM = std::make_shared<const Eigen::MatrixXd>(K);
 	}
 	
 	template<class CONTAINER>
 	truss::truss(const unsigned long& ID, const double& E, const double& A,
 							 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<6>(ID, E, ERelativeLowerBound)
 	{ // 
 		mA = A;
 		mIsTruss = true;
@@ -81,7 +81,7 @@ namespace bso { namespace structural_design { namespace element {
 	truss::truss(const unsigned long& ID, const double& E, const double& A,
 							 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		sized_element<6>(ID, E, ERelativeLowerBound)
 	{ // 
 		mA = A;
 		mIsTruss = true;
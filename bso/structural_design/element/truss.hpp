@@ -2,12 +2,12 @@
 #define SD_TRUSS_ELEMENT_HPP
 
 #include <bso/utilities/geometry/line_segment.hpp>
-#include <bso/structural_design/element/element.hpp>
+#include <bso/structural_design/element/sized_element.hpp>
 
 namespace bso { namespace structural_design { namespace element {
 	
-	class truss : public bso::utilities::geometry::line_segment,
-							 public element
+	class truss final : public bso::utilities::geometry::line_segment,
+							 public sized_element<6>
 	{
 	private:
 		double mA; // surface area [mm³]
@@ -1,14 +1,342 @@
 #ifndef SD_FEA_CPP
 #define SD_FEA_CPP
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
 
 namespace bso { namespace structural_design {
 	
+	bool fea::hasSamePattern(const Eigen::SparseMatrix<double>& GSM) const
+	{ // both matrices are expected to be compressed
+		if (GSM.rows() != mGSM.rows() || GSM.cols() != mGSM.cols() ||
+				GSM.nonZeros() != mGSM.nonZeros()) return false;
+		return std::equal(GSM.outerIndexPtr(), GSM.outerIndexPtr() + GSM.outerSize() + 1,
+											mGSM.outerIndexPtr()) &&
+					 std::equal(GSM.innerIndexPtr(), GSM.innerIndexPtr() + GSM.nonZeros(),
+											mGSM.innerIndexPtr());
+	} // hasSamePattern()
+	
+	void fea::resetPatternAnalysis()
+	{ // the symbolic factorizations and the preconditioners no longer match the GSM
+		mLLTPatternAnalyzed = false;
+		mLDLTPatternAnalyzed = false;
+		mMixedLDLTPatternAnalyzed = false;
+		mLowRankPatternAnalyzed = false;
+		mOrderingGenerated = false;
+		mBiCGSTABSolver.invalidate();
+		mPCGSolver.invalidate();
+		mAMGPCGSolver.invalidate();
+		mGMGPCGSolver.invalidate();
+	} // resetPatternAnalysis()
+	
+	void fea::generateOrdering()
+	{ // the ordering for the direct solvers, in mode "auto" the one with the least estimated fill
+		if (mOrderingGenerated) return;
+		typedef solver::fill_reducing_ordering ordering;
+		mOrderingGenerated = true;
+		if (mOrderingPreset && mOrdering.size() == mGSM.rows())
+		{
+			mOrderingFill = ordering::estimateFill(mGSM,mOrdering);
+			return;
+		}
+		mOrderingPreset = false;
+		
+		// the node of each row of the GSM, for the orderings of the nodes
+		std::vector<unsigned long> DOFNodes(mGSM.rows(),0);
+		std::vector<Eigen::Vector3d> nodeCoordinates(mNodes.size());
+		for (unsigned long i = 0; i < mNodes.size(); ++i)
+		{
+			nodeCoordinates[i] = *mNodes[i];
+			for (unsigned int j = 0; j < 6; ++j)
+			{
+				if (mNodes[i]->getNFS(j) == 0 || mNodes[i]->getConstraint(j) == 1) continue;
+				long row = mNodes[i]->getGlobalDOF(j);
+				if (mCondensation.isActive()) row = mCondensation.getCondensedIndex()[row];
+				if (row >= 0) DOFNodes[row] = i;
+			}
+		}
+		
+		std::vector<std::string> methods = {mOrderingMethod};
+		if (mOrderingMethod == "auto") methods = {"AMD", "COLAMD", "nested-dissection", "RCM"};
+		for (const auto& i : methods)
+		{
+			ordering::permutation order;
+			if (i == "AMD") order = ordering::AMD(mGSM);
+			else if (i == "COLAMD") order = ordering::COLAMD(mGSM);
+			else if (i == "nested-dissection") order = ordering::nestedDissection(mGSM,DOFNodes,nodeCoordinates);
+			else order = ordering::reverseCuthillMcKee(mGSM,DOFNodes,mNodes.size());
+			unsigned long fill = ordering::estimateFill(mGSM,order);
+			if (i == methods[0] || fill < mOrderingFill)
+			{
+				mOrdering = std::move(order);
+				mOrderingFill = fill;
+				mChosenOrdering = i;
+			}
+		}
+	} // generateOrdering()
+	
+	void fea::generateScatterMaps()
+	{ // fixes the sparsity pattern of the GSM to all the free DOF couplings of the elements, and stores
+		// for each element where the entries of its stiffness matrix are to be added into the GSM's values
+		std::vector<element::triplet> pattern;
+		for (const auto& i : mElements)
+		{
+			const auto& EFT = i->getEFT();
+			const Eigen::MatrixXd& SM = i->getOriginalSM();
+			for (const auto& m : EFT)
+			{
+				for (const auto& n : EFT)
+				{
+					if (SM(m.first,n.first) != 0) pattern.push_back(element::triplet(m.second,n.second,0.0));
+				}
+			}
+		}
+		Eigen::SparseMatrix<double> GSM(mDOFCount,mDOFCount);
+		GSM.setFromTriplets(pattern.begin(),pattern.end());
+		
+		mScatterMaps.clear();
+		mScatterMaps.resize(mElements.size());
+		for (unsigned long i = 0; i < mElements.size(); ++i)
+		{
+			const auto& EFT = mElements[i]->getEFT();
+			const Eigen::MatrixXd& SM = mElements[i]->getOriginalSM();
+			for (const auto& n : EFT)
+			{ // loop column wise, so the element's SM is accessed in storage order
+				const int* colBegin = GSM.innerIndexPtr() + GSM.outerIndexPtr()[n.second];
+				const int* colEnd   = GSM.innerIndexPtr() + GSM.outerIndexPtr()[n.second+1];
+				for (const auto& m : EFT)
+				{
+					if (SM(m.first,n.first) == 0) continue;
+					const int* slot = std::lower_bound(colBegin,colEnd,(int)m.second);
+					mScatterMaps[i].push_back({m.first + n.first*SM.rows(),
+						(unsigned long)(slot - GSM.innerIndexPtr())});
+				}
+			}
+		}
+		
+		if (!this->hasSamePattern(GSM)) this->resetPatternAnalysis();
+		mGSM = std::move(GSM);
+		mBlockGSM.clear();
+		std::vector<unsigned long>().swap(mBlockDOFs);
+		mScatterMapsGenerated = true;
+		mGatherOffsets.clear();
+		mGatherEntries.clear();
+	} // generateScatterMaps()
+	
+	void fea::generateBlockScatterMaps()
+	{ // fixes the pattern of the block GSM to the pairs of nodes that share an element, and stores for each
+		// element where the entries of its stiffness matrix are to be added into the values of the blocks
+		if (mGSM.size() > 0)
+		{ // release the memory of a previous assembly
+			Eigen::SparseMatrix<double>().swap(mGSM);
+			this->resetPatternAnalysis();
+		}
+		mBlockDOFs.assign(mDOFCount,0);
+		for (unsigned long i = 0; i < mNodes.size(); ++i)
+		{
+			for (unsigned int j = 0; j < 6; ++j)
+			{
+				if (mNodes[i]->getNFS(j) == 0 || mNodes[i]->getConstraint(j) == 1) continue;
+				mBlockDOFs[mNodes[i]->getGlobalDOF(j)] = 6*i + j;
+			}
+		}
+		
+		std::vector<std::pair<unsigned long, unsigned long> > pattern;
+		for (const auto& i : mElements)
+		{
+			std::vector<unsigned long> blockRows;
+			for (const auto& j : i->getEFT()) blockRows.push_back(mBlockDOFs[j.second]/6);
+			std::sort(blockRows.begin(),blockRows.end());
+			blockRows.erase(std::unique(blockRows.begin(),blockRows.end()),blockRows.end());
+			for (const auto& m : blockRows)
+			{
+				for (const auto& n : blockRows) pattern.push_back({m,n});
+			}
+		}
+		mBlockGSM.setPattern(mNodes.size(),pattern);
+		
+		mScatterMaps.clear();
+		mScatterMaps.resize(mElements.size());
+		for (unsigned long i = 0; i < mElements.size(); ++i)
+		{
+			const auto& EFT = mElements[i]->getEFT();
+			const Eigen::MatrixXd& SM = mElements[i]->getOriginalSM();
+			for (const auto& n : EFT)
+			{
+				unsigned long col = mBlockDOFs[n.second];
+				for (const auto& m : EFT)
+				{
+					if (SM(m.first,n.first) == 0) continue;
+					unsigned long row = mBlockDOFs[m.second];
+					long block = mBlockGSM.findBlock(row/6,col/6);
+					mScatterMaps[i].push_back({m.first + n.first*SM.rows(), 36*block + row%6 + 6*(col%6)});
+				}
+			}
+		}
+		mScatterMapsGenerated = true;
+		mGatherOffsets.clear();
+		mGatherEntries.clear();
+	} // generateBlockScatterMaps()
+	
+	void fea::generateGatherMaps(const unsigned long& valueCount)
+	{ // inverts the scatter maps, so that each value of the GSM can be summed by one thread, in element order
+		mGatherOffsets.assign(valueCount+1,0);
+		for (const auto& i : mScatterMaps)
+		{
+			for (const auto& j : i) ++mGatherOffsets[j.second+1];
+		}
+		for (unsigned long i = 0; i < valueCount; ++i) mGatherOffsets[i+1] += mGatherOffsets[i];
+		
+		mGatherEntries.resize(mGatherOffsets.back());
+		std::vector<unsigned long> position(mGatherOffsets.begin(), mGatherOffsets.end()-1);
+		for (unsigned long i = 0; i < mScatterMaps.size(); ++i)
+		{
+			for (const auto& j : mScatterMaps[i]) mGatherEntries[position[j.second]++] = {i,j.first};
+		}
+	} // generateGatherMaps()
+	
+	void fea::scatterElementSMs(double* values, const unsigned long& valueCount)
+	{ // adds the scaled element SMs into the values of the GSM with the scatter maps
+		if (this->getThreadCount() == 1)
+		{
+			std::fill(values, values + valueCount, 0.0);
+			for (unsigned long i = 0; i < mElements.size(); ++i)
+			{
+				const double* SMValues = mElements[i]->getOriginalSM().data();
+				double factor = mElements[i]->getStiffnessFactor();
+				for (const auto& j : mScatterMaps[i]) values[j.second] += factor*SMValues[j.first];
+			}
+			return;
+		}
+		
+		// with multiple threads, each value is gathered from its contributions in element order
+		// instead, this sums them in the same order as above and gives bitwise the same GSM
+		if (mGatherOffsets.empty()) this->generateGatherMaps(valueCount);
+		std::vector<const double*> SMValues(mElements.size());
+		std::vector<double> factors(mElements.size());
+		for (unsigned long i = 0; i < mElements.size(); ++i)
+		{
+			SMValues[i] = mElements[i]->getOriginalSM().data();
+			factors[i] = mElements[i]->getStiffnessFactor();
+		}
+		this->parallelFor(0, valueCount, [&](const unsigned long& i)
+		{
+			double value = 0.0;
+			for (unsigned long j = mGatherOffsets[i]; j < mGatherOffsets[i+1]; ++j)
+			{
+				const auto& entry = mGatherEntries[j];
+				value += factors[entry.first]*SMValues[entry.first][entry.second];
+			}
+			values[i] = value;
+		});
+	} // scatterElementSMs()
+	
+	void fea::generateElementColours()
+	{ // greedy colouring of the elements, such that the elements of one colour share no DOFs. Colours
+		// are assigned 64 at a time, the bits of a DOF mark the colours of its elements in that round
+		std::vector<long> colourOf(mElements.size(),-1);
+		unsigned long colouredCount = 0;
+		for (unsigned int round = 0; colouredCount < mElements.size(); ++round)
+		{
+			std::vector<unsigned long long> DOFColours(mDOFCount,0);
+			for (unsigned long i = 0; i < mElements.size(); ++i)
+			{
+				if (colourOf[i] != -1) continue;
+				unsigned long long usedColours = 0;
+				for (const auto& j : mElements[i]->getEFT()) usedColours |= DOFColours[j.second];
+				if (~usedColours == 0) continue;
+				unsigned int colour = 0;
+				while ((usedColours >> colour) & 1) ++colour;
+				for (const auto& j : mElements[i]->getEFT()) DOFColours[j.second] |= (1ULL << colour);
+				colourOf[i] = 64*round + colour;
+				++colouredCount;
+			}
+		}
+		
+		mElementColours.clear();
+		for (unsigned long i = 0; i < mElements.size(); ++i)
+		{
+			if ((unsigned long)colourOf[i] >= mElementColours.size()) mElementColours.resize(colourOf[i]+1);
+			mElementColours[colourOf[i]].push_back(i);
+		}
+		mElementColoursGenerated = true;
+	} // generateElementColours()
+	
+	void fea::multiplyElementByElement(const Eigen::VectorXd& x, Eigen::VectorXd& y)
+	{ // y = GSM * x without the GSM, the elements of one colour are added in parallel, the colours in
+		// order, so the result does not depend on the number of threads
+		typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, 24, 1> elementVector;
+		y.setZero(mDOFCount);
+		for (const auto& i : mElementColours)
+		{
+			this->parallelFor(0, i.size(), [&](const unsigned long& j)
+			{
+				const element::element* ele = mElements[i[j]];
+				const Eigen::MatrixXd& SM = ele->getOriginalSM();
+				elementVector xe = elementVector::Zero(SM.rows());
+				for (const auto& k : ele->getEFT()) xe(k.first) = x(k.second);
+				elementVector ye = SM * xe;
+				double factor = ele->getStiffnessFactor();
+				for (const auto& k : ele->getEFT()) y(k.second) += factor*ye(k.first);
+			});
+		}
+	} // multiplyElementByElement()
+	
+	void fea::multiplyBlocks(const Eigen::VectorXd& x, Eigen::VectorXd& y)
+	{ // y = GSM * x with the block GSM, x and y are moved to and from the layout of six values per node
+		Eigen::VectorXd xBlocks = Eigen::VectorXd::Zero(mBlockGSM.rows());
+		Eigen::VectorXd yBlocks(mBlockGSM.rows());
+		for (unsigned long i = 0; i < mDOFCount; ++i) xBlocks(mBlockDOFs[i]) = x(i);
+		this->parallelFor(0, mBlockGSM.getBlockRows(), [&](const unsigned long& i)
+		{
+			mBlockGSM.multiplyRow(i,xBlocks,yBlocks);
+		});
+		y.resize(mDOFCount);
+		for (unsigned long i = 0; i < mDOFCount; ++i) y(i) = yBlocks(mBlockDOFs[i]);
+	} // multiplyBlocks()
+	
+	template <class FUNC>
+	void fea::parallelFor(const unsigned long& begin, const unsigned long& end, FUNC f) const
+	{
+		if (mThreadPool) mThreadPool->parallel_for(begin,end,f);
+		else for (unsigned long i = begin; i < end; ++i) f(i);
+	} // parallelFor()
+	
+	template <class FUNC>
+	void fea::forEachElement(FUNC f, const bool& parallel /*= false*/) const
+	{ // f is instantiated for each element type, so its calls on the element are not virtual
+		mElementGroups.forEach([&](const auto& group)
+		{
+			auto visit = [&](const unsigned long& i){f(group.elements[i],group.indices[i]);};
+			if (parallel) this->parallelFor(0, group.elements.size(), visit);
+			else for (unsigned long i = 0; i < group.elements.size(); ++i) visit(i);
+		});
+	} // forEachElement()
+	
+	void fea::computeResponses()
+	{
+		unsigned long lcCount = mLoadCases.size();
+		this->forEachElement([&](auto ele, const unsigned long&)
+		{
+			for (unsigned long i = 0; i < lcCount; ++i) ele->evaluateResponse(i);
+		}, true);
+	} // computeResponses()
+	
 	void fea::simplicialLLT()
 	{
-		mLLTSolver.compute(mGSM);
+		if (!mLLTPatternAnalyzed)
+		{
+			this->generateOrdering();
+			solver::preset_ordering<int>::scope ordering(mOrdering);
+			mLLTSolver.analyzePattern(mGSM);
+			mLLTPatternAnalyzed = true;
+		}
+		mLLTSolver.factorize(mGSM);
 		if (mLLTSolver.info() != Eigen::Success)
 		{
 			std::stringstream errorMessage;
@@ -18,30 +346,34 @@ namespace bso { namespace structural_design {
 			throw std::runtime_error(errorMessage.str());
 		}
 		
-		for (auto& lc : mLoadCases)
-		{
-			try
+		try
+		{ // solve all load cases at once
+			mDisplacements = mLLTSolver.solve(mLoads);
+			if (mLLTSolver.info() != Eigen::Success)
 			{
-				mDisplacements[lc] = mLLTSolver.solve(mLoads[lc]);
-				if (mLLTSolver.info() != Eigen::Success)
-				{
-					throw std::runtime_error("Solver failed");
-				}
-			}
-			catch (std::exception& e)
-			{
-				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with SimplicialLLT for load case: " << lc << "\n"
-										 << "received the following error:\n" << e.what() << "\n"
-										 << "(bso/structural_design/fea.cpp)" << std::endl;
-				throw std::runtime_error(errorMessage.str());
+				throw std::runtime_error("Solver failed");
 			}
 		}
+		catch (std::exception& e)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving FEA system with SimplicialLLT for " << mLoadCases.size() << " load cases\n"
+									 << "received the following error:\n" << e.what() << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
 	} // simplicialLLT()
 	
-	void fea::simplicialLDLT()
+	void fea::factorizeLDLT()
 	{
-		mLDLTSolver.compute(mGSM);
+		if (!mLDLTPatternAnalyzed)
+		{
+			this->generateOrdering();
+			solver::preset_ordering<int>::scope ordering(mOrdering);
+			mLDLTSolver.analyzePattern(mGSM);
+			mLDLTPatternAnalyzed = true;
+		}
+		mLDLTSolver.factorize(mGSM);
 		if (mLDLTSolver.info() != Eigen::Success)
 		{
 			std::stringstream errorMessage;
@@ -50,101 +382,280 @@ namespace bso { namespace structural_design {
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
-		
-		for (auto& lc : mLoadCases)
+	} // factorizeLDLT()
+	
+	void fea::simplicialLDLT()
+	{
+		this->factorizeLDLT();
+		try
+		{ // solve all load cases at once
+			mDisplacements = mLDLTSolver.solve(mLoads);
+			if (mLDLTSolver.info() != Eigen::Success)
+			{
+				throw std::runtime_error("Solver failed");
+			}
+		}
+		catch (std::exception& e)
 		{
-			try
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving FEA system with SimplicialLDLT for " << mLoadCases.size() << " load cases\n"
+									 << "received the following error:\n" << e.what() << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+	} // simplicialLDLT()
+	
+	void fea::denseLDLT()
+	{ // for tiny systems, for which the ordering and symbolic factorization of the sparse solvers
+		// take longer than factorizing the dense GSM
+		mDenseLDLTSolver.compute(Eigen::MatrixXd(mGSM));
+		const Eigen::VectorXd& D = mDenseLDLTSolver.vectorD();
+		if (mDenseLDLTSolver.info() != Eigen::Success || !D.allFinite() || (D.array() == 0).any())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving an FEA system with DenseLDLT,\n"
+									 << "Could not decompose the GSM\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		mDisplacements = mDenseLDLTSolver.solve(mLoads);
+	} // denseLDLT()
+	
+	bool fea::refineMixedLDLT(const Eigen::MatrixXd& B, Eigen::MatrixXd& X,
+		std::vector<unsigned long>& refinements, std::vector<double>& residuals) const
+	{ // iterative refinement: the residual of X is computed with the double precision GSM, and the
+		// correction with the single precision factor. Each residual is normalized before it is cast
+		// to float, so that small residuals do not underflow. Returns false if the refinement stalls
+		refinements.assign(B.cols(),0);
+		residuals.assign(B.cols(),0.0);
+		X.resize(B.rows(),B.cols());
+		for (unsigned long i = 0; i < (unsigned long)B.cols(); ++i)
+		{
+			double bNorm = B.col(i).norm();
+			if (bNorm == 0)
 			{
-				mDisplacements[lc] = mLDLTSolver.solve(mLoads[lc]);
-				if (mLDLTSolver.info() != Eigen::Success)
+				X.col(i).setZero();
+				continue;
+			}
+			Eigen::VectorXf correction = mMixedLDLTSolver.solve((B.col(i)/bNorm).cast<float>());
+			if (mMixedLDLTSolver.info() != Eigen::Success) return false;
+			X.col(i) = correction.cast<double>()*bNorm;
+			
+			Eigen::VectorXd r = B.col(i) - mGSM*X.col(i);
+			double error = r.norm()/bNorm;
+			unsigned long refinement = 0;
+			while (!(error <= mRefinementTolerance))
+			{
+				if (refinement == mMaxRefinements || !std::isfinite(error)) return false;
+				double rNorm = r.norm();
+				correction = mMixedLDLTSolver.solve((r/rNorm).cast<float>());
+				X.col(i) += correction.cast<double>()*rNorm;
+				r = B.col(i) - mGSM*X.col(i);
+				double previousError = error;
+				error = r.norm()/bNorm;
+				++refinement;
+				// the refinement converges at a rate of about the condition number of the GSM times the
+				// precision of a float, if it does not halve the residual the GSM is too ill-conditioned
+				if (!(error <= 0.5*previousError) && !(error <= mRefinementTolerance)) return false;
+			}
+			refinements[i] = refinement;
+			residuals[i] = error;
+		}
+		return true;
+	} // refineMixedLDLT()
+	
+	void fea::mixedLDLT()
+	{ // factorizes the GSM in single precision, which halves the memory of the factor and speeds up
+		// the factorization, and refines the solutions to double precision. Falls back to SimplicialLDLT
+		// if the single precision factorization fails or the refinement stalls
+		mMixedLDLTFellBack = false;
+		bool refined = false;
+		{
+			Eigen::SparseMatrix<float> floatGSM = mGSM.cast<float>();
+			if (!mMixedLDLTPatternAnalyzed)
+			{
+				this->generateOrdering();
+				solver::preset_ordering<int>::scope ordering(mOrdering);
+				mMixedLDLTSolver.analyzePattern(floatGSM);
+				mMixedLDLTPatternAnalyzed = true;
+			}
+			mMixedLDLTSolver.factorize(floatGSM);
+		}
+		if (mMixedLDLTSolver.info() == Eigen::Success)
+		{
+			refined = this->refineMixedLDLT(mLoads,mDisplacements,mSolverIterations,mSolverErrors);
+		}
+		if (refined) return;
+		
+		mMixedLDLTFellBack = true;
+		this->simplicialLDLT();
+		mSolverIterations.assign(mLoadCases.size(),0);
+		mSolverErrors.assign(mLoadCases.size(),0.0);
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
+		{
+			double bNorm = mLoads.col(i).norm();
+			if (bNorm > 0) mSolverErrors[i] = (mLoads.col(i) - mGSM*mDisplacements.col(i)).norm()/bNorm;
+		}
+	} // mixedLDLT()
+	
+	Eigen::MatrixXd fea::solveLowRank(const Eigen::MatrixXd& B) const
+	{ // Woodbury identity, with K0 the factorized GSM, P the unit vectors of the changed DOFs and D
+		// the change on those DOFs: (K0 + P*D*P^T)^-1 = K0^-1 - Z*(I + D*P^T*Z)^-1*D*P^T*K0^-1, Z = K0^-1*P
+		Eigen::MatrixXd X = mLowRankSolver.solve(B);
+		if (mLowRankDOFs.empty()) return X;
+		Eigen::MatrixXd XS(mLowRankDOFs.size(),X.cols());
+		for (unsigned long i = 0; i < mLowRankDOFs.size(); ++i) XS.row(i) = X.row(mLowRankDOFs[i]);
+		X -= mLowRankSolutions*mLowRankCapacitance.solve(mLowRankChange*XS);
+		return X;
+	} // solveLowRank()
+	
+	void fea::lowRankLDLT()
+	{ // reuses the factorization of an earlier GSM K0 if the GSM only changed on a few DOFs, e.g.
+		// because the stiffness of a few elements changed. The GSM is factorized again if it changed
+		// on more than a fraction of the DOFs, or if the updated solution is not accurate enough
+		mSolverIterations.assign(mLoadCases.size(),0);
+		mSolverErrors.assign(mLoadCases.size(),0.0);
+		if (mLowRankBaseGSM.rows() == mGSM.rows() && mLowRankBaseGSM.cols() == mGSM.cols() &&
+				mLowRankPatternAnalyzed && mLowRankSolver.info() == Eigen::Success)
+		{
+			Eigen::SparseMatrix<double> change = mGSM - mLowRankBaseGSM;
+			change.prune(mLowRankBaseGSM.diagonal().cwiseAbs().maxCoeff(),
+				std::numeric_limits<double>::epsilon());
+			
+			std::vector<long> changedIndex(mDOFCount,-1);
+			mLowRankDOFs.clear();
+			for (long k = 0; k < change.outerSize(); ++k)
+			{ // the change is symmetric, so its rows contain all changed DOFs
+				for (Eigen::SparseMatrix<double>::InnerIterator it(change,k); it; ++it)
 				{
-					throw std::runtime_error("Solver failed");
+					if (changedIndex[it.row()] < 0)
+					{
+						changedIndex[it.row()] = mLowRankDOFs.size();
+						mLowRankDOFs.push_back(it.row());
+					}
 				}
 			}
-			catch (std::exception& e)
+			
+			unsigned long rank = mLowRankDOFs.size();
+			if (rank <= mMaxUpdateFraction*mDOFCount)
 			{
-				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with SimplicialLDLT for load case: " << lc << "\n"
-										 << "received the following error:\n" << e.what() << "\n"
-										 << "(bso/structural_design/fea.cpp)" << std::endl;
-				throw std::runtime_error(errorMessage.str());
+				mLowRankChange.setZero(rank,rank);
+				for (long k = 0; k < change.outerSize(); ++k)
+				{
+					for (Eigen::SparseMatrix<double>::InnerIterator it(change,k); it; ++it)
+					{
+						mLowRankChange(changedIndex[it.row()],changedIndex[it.col()]) = it.value();
+					}
+				}
+				Eigen::MatrixXd P = Eigen::MatrixXd::Zero(mDOFCount,rank);
+				for (unsigned long i = 0; i < rank; ++i) P(mLowRankDOFs[i],i) = 1;
+				mLowRankSolutions = mLowRankSolver.solve(P);
+				Eigen::MatrixXd solutionsOnDOFs(rank,rank);
+				for (unsigned long i = 0; i < rank; ++i) solutionsOnDOFs.row(i) = mLowRankSolutions.row(mLowRankDOFs[i]);
+				Eigen::MatrixXd capacitance = mLowRankChange*solutionsOnDOFs;
+				capacitance += Eigen::MatrixXd::Identity(rank,rank);
+				mLowRankCapacitance.compute(capacitance);
+				
+				mDisplacements = this->solveLowRank(mLoads);
+				bool accurate = true;
+				for (unsigned long i = 0; i < mLoadCases.size(); ++i)
+				{
+					double bNorm = mLoads.col(i).norm();
+					if (bNorm > 0) mSolverErrors[i] = (mLoads.col(i) - mGSM*mDisplacements.col(i)).norm()/bNorm;
+					if (!(mSolverErrors[i] <= mUpdateTolerance)) accurate = false;
+				}
+				if (accurate) return;
+				mSolverErrors.assign(mLoadCases.size(),0.0);
 			}
 		}
-	} // simplicialLDLT()
+		
+		// factorize the GSM, it becomes the base of the next updates
+		mLowRankDOFs.clear();
+		mLowRankChange.resize(0,0);
+		mLowRankSolutions.resize(0,0);
+		mLowRankBaseGSM = mGSM;
+		if (!mLowRankPatternAnalyzed)
+		{
+			this->generateOrdering();
+			solver::preset_ordering<int>::scope ordering(mOrdering);
+			mLowRankSolver.analyzePattern(mGSM);
+			mLowRankPatternAnalyzed = true;
+		}
+		mLowRankSolver.factorize(mGSM);
+		if (mLowRankSolver.info() != Eigen::Success)
+		{
+			mLowRankBaseGSM.resize(0,0);
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving an FEA system with LowRankLDLT,\n"
+									 << "Could not decompose the GSM\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		mDisplacements = mLowRankSolver.solve(mLoads);
+	} // lowRankLDLT()
 	
 	void fea::BiCGSTAB()
+	{
+		this->iterativeSolve(mBiCGSTABSolver,"BiCGSTAB");
+	} // BiCGSTAB()
+	
+	void fea::scaledBiCGSTAB()
 	{
 		Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::DiagonalPreconditioner<double>> solver;
+		solver.compute(mGSM); // the preconditioner for the rough solutions is set up once for all load cases
+		if (solver.info() != Eigen::Success)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving an FEA system with scaled BiCGSTAB,\n"
+									 << "solver could not decompose matrix GSM\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		solver.setMaxIterations(3);
 		
-		for (auto& lc : mLoadCases)
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
 		{
 			try
 			{
-				solver.compute(mGSM);
-				solver.setTolerance(1e-3);
-				
-				if (solver.info() != Eigen::Success)
-				{
-					throw std::runtime_error("Solver failed decompose matrix GSM");
-				}
-				
-				mDisplacements[lc] = solver.solve(mLoads[lc]);
+				// get a rough solution
+				mDisplacements.col(i) = solver.solve(mLoads.col(i));
 				if (solver.info() != Eigen::Success)
 				{
-					throw std::runtime_error("Solver failed to solve GSM for loads");
+					throw std::runtime_error("Solver failed to roughly solve GSM for loads");
 				}
 			}
 			catch (std::exception& e)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with BiCGSTAB for load case: " << lc << "\n"
+				errorMessage << "\nWhen solving FEA system with scaled BiCGSTAB for load case: " << mLoadCases[i] << "\n"
 										 << "received the following error:\n" << e.what() << "\n"
 										 << "(bso/structural_design/fea.cpp)" << std::endl;
 				throw std::runtime_error(errorMessage.str());
 			}
 		}
-	} // BiCGSTAB()
-	
-	void fea::scaledBiCGSTAB()
-	{
-		Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::DiagonalPreconditioner<double>> solver;
 		
-		for (auto& lc : mLoadCases)
+		Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::DiagonalPreconditioner<double>> scaledSolver;
+		scaledSolver.setMaxIterations(mDOFCount*10);
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
 		{
 			try
 			{
-				solver.compute(mGSM);
-				if (solver.info() != Eigen::Success)
-				{
-					throw std::runtime_error("solver could not decompose matrix GSM");
-				}
-				// get a rough solution
-				solver.setMaxIterations(3);
-				mDisplacements[lc] = solver.solve(mLoads[lc]);
-				
-				if (solver.info() != Eigen::Success)
-				{
-					throw std::runtime_error("Solver failed to roughly solve GSM for loads");
-				}
-				
-				// scale the GSM into a temporary GSM matrix: Could
-				Eigen::VectorXd wInverse = (mDisplacements[lc].array().abs()+1e-6).inverse();
+				// scale the GSM into a temporary GSM matrix, the scaling differs per load case
+				Eigen::VectorXd wInverse = (mDisplacements.col(i).array().abs()+1e-6).inverse();
 				Eigen::SparseMatrix<double> C;
 				C.resize(mDOFCount,mDOFCount);
 				C = mGSM * wInverse.asDiagonal();
 				
-				solver.compute(C);
-				solver.setMaxIterations(mDOFCount*10);
-				
-				if (solver.info() != Eigen::Success)
+				scaledSolver.compute(C);
+				if (scaledSolver.info() != Eigen::Success)
 				{
 					throw std::runtime_error("Solver could not decompose matrix C");
 				}
 				
 				Eigen::VectorXd y(mDOFCount);
-				y = solver.solve(mLoads[lc]);
-				mDisplacements[lc] = wInverse.asDiagonal() * y;
-				if (solver.info() != Eigen::Success)
+				y = scaledSolver.solve(mLoads.col(i));
+				mDisplacements.col(i) = wInverse.asDiagonal() * y;
+				if (scaledSolver.info() != Eigen::Success)
 				{
 					throw std::runtime_error("Solver failed to solver for y");
 				}
@@ -152,7 +663,7 @@ namespace bso { namespace structural_design {
 			catch (std::exception& e)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with scaled BiCGSTAB for load case: " << lc << "\n"
+				errorMessage << "\nWhen solving FEA system with scaled BiCGSTAB for load case: " << mLoadCases[i] << "\n"
 										 << "received the following error:\n" << e.what() << "\n"
 										 << "(bso/structural_design/fea.cpp)" << std::endl;
 				throw std::runtime_error(errorMessage.str());
@@ -160,36 +671,320 @@ namespace bso { namespace structural_design {
 		}
 	} // scaledBiCGSTAB()
 	
-	fea::fea()
+	template <class SOLVER>
+	void fea::iterativeSolve(SOLVER& solver, const std::string& solverName)
+	{ // solves each load case with an iterative solver, of which the preconditioner is set up once,
+		// or reused from a previous solve if that is allowed and its quality has not degraded too much
+		solver.setTolerance(mIterativeTolerance);
+		if (mMaxIterations > 0) solver.setMaxIterations(mMaxIterations);
+		else solver.setMaxIterations(2*mDOFCount); // the default, otherwise a previous setting remains
+		mPreconditionerReused = !solver.update(mGSM,mPreconditionerDegradation);
+		if (solver.info() != Eigen::Success)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving an FEA system with " << solverName << ",\n"
+									 << "could not compute the preconditioner of the GSM\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		
+		mSolverIterations.assign(mLoadCases.size(),0);
+		mSolverErrors.assign(mLoadCases.size(),0.0);
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
+		{
+			try
+			{
+				if (mInitialGuess.size() > 0)
+				{
+					mDisplacements.col(i) = solver.solveWithGuess(mLoads.col(i),mInitialGuess.col(i));
+				}
+				else mDisplacements.col(i) = solver.solve(mLoads.col(i));
+				mSolverIterations[i] = solver.iterations();
+				mSolverErrors[i] = solver.error();
+				solver.addIterations(solver.iterations());
+				if (solver.info() != Eigen::Success)
+				{
+					std::stringstream failMessage;
+					failMessage << "Solver failed to solve GSM for loads, relative residual: "
+											<< solver.error() << " after " << solver.iterations() << " iterations";
+					throw std::runtime_error(failMessage.str());
+				}
+			}
+			catch (std::exception& e)
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nWhen solving FEA system with " << solverName << " for load case: " << mLoadCases[i] << "\n"
+										 << "received the following error:\n" << e.what() << "\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
+				throw std::runtime_error(errorMessage.str());
+			}
+		}
+	} // iterativeSolve()
+	
+	void fea::PCG()
+	{ // conjugate gradients, the GSM is stored completely so both triangles are used in the products
+		this->iterativeSolve(mPCGSolver,"PCG");
+	} // PCG()
+	
+	void fea::AMGPCG()
+	{ // conjugate gradients preconditioned by a smoothed aggregation multigrid cycle
+		std::vector<std::vector<unsigned long> > blocks;
+		Eigen::MatrixXd rigidBodyModes;
+		this->generateNodeBlocks(blocks,rigidBodyModes);
+		mAMGPCGSolver.preconditioner().setNodes(blocks,rigidBodyModes);
+		this->iterativeSolve(mAMGPCGSolver,"PCG-AMG");
+	} // AMGPCG()
+	
+	void fea::GMGPCG()
+	{ // conjugate gradients preconditioned by a geometric multigrid cycle, of which the prolongations
+		// follow from meshing the same model coarser, these only change when the mesh changes
+		if (!mProlongationGenerator)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot solve an FEA system with PCG-GMG, no coarser meshes are known,\n"
+									 << "set a prolongation generator first\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		if (!mProlongationsGenerated)
+		{
+			mGMGPCGSolver.preconditioner().setProlongations(mProlongationGenerator());
+			mGMGPCGSolver.invalidate();
+			mProlongationsGenerated = true;
+		}
+		this->iterativeSolve(mGMGPCGSolver,"PCG-GMG");
+	} // GMGPCG()
+	
+	template <class PRODUCT>
+	void fea::jacobiPCG(PRODUCT multiply, const std::string& solverName)
+	{ // conjugate gradients with a Jacobi preconditioner, of which the products with the GSM are done by
+		// multiply(x,y), the diagonal of the GSM is to be in mGSMDiagonal
+		Eigen::VectorXd inverseDiagonal(mDOFCount);
+		for (unsigned long i = 0; i < mDOFCount; ++i)
+		{
+			inverseDiagonal(i) = (mGSMDiagonal(i) > 0) ? 1.0/mGSMDiagonal(i) : 1.0;
+		}
+		unsigned long maxIterations = (mMaxIterations > 0) ? mMaxIterations : 2*mDOFCount;
+		
+		mSolverIterations.assign(mLoadCases.size(),0);
+		mSolverErrors.assign(mLoadCases.size(),0.0);
+		Eigen::VectorXd x, r, z, p, Ap;
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
+		{
+			const auto& b = mLoads.col(i);
+			double bNorm = b.norm();
+			if (bNorm == 0)
+			{
+				mDisplacements.col(i).setZero();
+				continue;
+			}
+			if (mInitialGuess.size() > 0)
+			{
+				x = mInitialGuess.col(i);
+				multiply(x,Ap);
+				r = b - Ap;
+			}
+			else
+			{
+				x.setZero(mDOFCount);
+				r = b;
+			}
+			z = inverseDiagonal.cwiseProduct(r);
+			p = z;
+			double rz = r.dot(z);
+			double threshold = mIterativeTolerance*mIterativeTolerance*bNorm*bNorm;
+			unsigned long iteration = 0;
+			while (r.squaredNorm() > threshold && iteration < maxIterations)
+			{
+				multiply(p,Ap);
+				double alpha = rz/p.dot(Ap);
+				x += alpha*p;
+				r -= alpha*Ap;
+				z = inverseDiagonal.cwiseProduct(r);
+				double rzNew = r.dot(z);
+				p = z + (rzNew/rz)*p;
+				rz = rzNew;
+				++iteration;
+			}
+			mDisplacements.col(i) = x;
+			mSolverIterations[i] = iteration;
+			mSolverErrors[i] = r.norm()/bNorm;
+			if (!(mSolverErrors[i] <= mIterativeTolerance))
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nWhen solving FEA system with " << solverName << " for load case: " << mLoadCases[i] << "\n"
+										 << "did not converge, relative residual: " << mSolverErrors[i]
+										 << " after " << iteration << " iterations\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
+				throw std::runtime_error(errorMessage.str());
+			}
+		}
+	} // jacobiPCG()
+	
+	void fea::elementByElementPCG()
+	{ // Jacobi preconditioned conjugate gradients of which the products with the GSM are done element by
+		// element, so only the element stiffness matrices and their density scaling are stored
+		if (!mElementColoursGenerated) this->generateElementColours();
+		if (mAssemblyMode != "matrix-free" && mAssemblyMode != "blocks")
+		{ // otherwise it is kept by generateGSM()
+			mGSMDiagonal = mGSM.diagonal();
+		}
+		this->jacobiPCG([this](const Eigen::VectorXd& x, Eigen::VectorXd& y)
+		{
+			this->multiplyElementByElement(x,y);
+		}, "EbE-PCG");
+	} // elementByElementPCG()
+	
+	void fea::blockPCG()
+	{ // Jacobi preconditioned conjugate gradients of which the products are done with the block GSM
+		if (mAssemblyMode != "blocks")
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot solve an FEA system with Block-PCG in assembly mode: " << mAssemblyMode << ",\n"
+									 << "it needs assembly mode \"blocks\"\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		this->jacobiPCG([this](const Eigen::VectorXd& x, Eigen::VectorXd& y)
+		{
+			this->multiplyBlocks(x,y);
+		}, "Block-PCG");
+	} // blockPCG()
+	
+	void fea::registeredSolve(const std::string& solver)
+	{ // a back-end of the solver registry, of which the relative residuals are reported
+		solver::solver_registry::back_end solve = solver::solver_registry::instance().getBackEnd(solver);
+		try
+		{
+			Eigen::MatrixXd displacements;
+			solve(mGSM,mLoads,displacements);
+			if (displacements.rows() != mLoads.rows() || displacements.cols() != mLoads.cols() ||
+					!displacements.allFinite())
+			{
+				throw std::runtime_error("the back-end returned no or a non-finite solution");
+			}
+			mDisplacements = std::move(displacements);
+		}
+		catch (std::exception& e)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving FEA system with " << solver << " for " << mLoadCases.size() << " load cases\n"
+									 << "received the following error:\n" << e.what() << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		mSolverIterations.assign(mLoadCases.size(),0);
+		mSolverErrors.assign(mLoadCases.size(),0.0);
+		for (unsigned long i = 0; i < mLoadCases.size(); ++i)
+		{
+			double bNorm = mLoads.col(i).norm();
+			if (bNorm > 0) mSolverErrors[i] = (mLoads.col(i) - mGSM*mDisplacements.col(i)).norm()/bNorm;
+		}
+	} // registeredSolve()
+	
+	void fea::generateNodeBlocks(std::vector<std::vector<unsigned long> >& blocks,
+		Eigen::MatrixXd& rigidBodyModes) const
+	{ // groups the global DOFs per node, and computes the six rigid body modes of the free DOFs
+		Eigen::Vector3d centroid = Eigen::Vector3d::Zero();
+		for (const auto& i : mNodes) centroid += *i;
+		if (!mNodes.empty()) centroid /= mNodes.size();
+		
+		blocks.clear();
+		rigidBodyModes.setZero(mDOFCount,6);
+		for (const auto& i : mNodes)
+		{
+			Eigen::Vector3d r = *i - centroid;
+			std::vector<unsigned long> block;
+			for (unsigned int j = 0; j < 6; ++j)
+			{
+				if (i->getNFS(j) == 0 || i->getConstraint(j) == 1) continue;
+				unsigned long DOF = i->getGlobalDOF(j);
+				block.push_back(DOF);
+				rigidBodyModes(DOF,j) = 1.0;
+				if (j == 0) {rigidBodyModes(DOF,4) =  r(2); rigidBodyModes(DOF,5) = -r(1);}
+				if (j == 1) {rigidBodyModes(DOF,3) = -r(2); rigidBodyModes(DOF,5) =  r(0);}
+				if (j == 2) {rigidBodyModes(DOF,3) =  r(1); rigidBodyModes(DOF,4) = -r(0);}
+			}
+			if (!block.empty()) blocks.push_back(block);
+		}
+	} // generateNodeBlocks()
+	
+	fea::fea() : mOwnArena(new bso::utilities::arena()), mDisplacements(mResponses.getDisplacements())
+	{
+		mArena = mOwnArena.get();
+	} // ctor
+	
+	fea::fea(bso::utilities::arena* meshArena) : mArena(meshArena), mDisplacements(mResponses.getDisplacements())
 	{
 		
 	} // ctor
 	
 	fea::~fea()
-	{
-		for (auto& i : mNodes) delete i;
-		for (auto& i : mElements) delete i;
+	{ // the nodes and the elements in the arena are destroyed with it
+		for (auto& i : mHeapElements) delete i;
 	} // dtor
 	
 	element::node* fea::addNode(const bso::utilities::geometry::vertex& point)
 	{
-		for (auto i : mNodes)
-		{
-			if (i->isSameAs(point)) 
-			{
-				return i;
-			}
-		}
+		element::node* existingNode = mNodeGrid.find(point);
+		if (existingNode != nullptr) return existingNode;
+
 		unsigned int nodeID = mNodes.size()+1;
-		mNodes.push_back(new element::node(point,nodeID));
+		mNodes.push_back(mArena->create<element::node>(point,nodeID));
+		mNodes.back()->setResponseBuffer(&mResponses);
+		mProlongationsGenerated = false;
+		mNodeGrid.insert(mNodes.back());
 		return mNodes.back();
 	} // addNode()
 	
-	void fea::addElement(element::element* ele)
+	void fea::addElement(element::element* ele, const bool& inArena /*= false*/)
 	{
 		mElements.push_back(ele);
+		mElementGroups.addElement(ele,mElements.size()-1);
+		ele->setResponseBuffer(&mResponses,mElements.size()-1);
+		if (!inArena) mHeapElements.push_back(ele);
+		mScatterMapsGenerated = false;
+		mElementColoursGenerated = false;
+		mProlongationsGenerated = false;
+		mCondensationInitialized = false;
 	} // addElement()
 	
+	void fea::setAssemblyMode(const std::string& mode)
+	{
+		if (mode != "scatter" && mode != "triplets" && mode != "blocks" && mode != "matrix-free")
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nTrying to set unknown assembly mode for FEA system:\n"
+									 << mode << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		if (mode != mAssemblyMode) mScatterMapsGenerated = false;
+		mAssemblyMode = mode;
+	} // setAssemblyMode()
+	
+	void fea::setCondensedGroups(const std::vector<std::vector<unsigned long> >& groups)
+	{ // the DOFs that are only coupled by the elements of a group are condensed out of the GSM, only
+		// groups with such interior DOFs are condensed
+		mCondensedGroups = groups;
+		mCondensationInitialized = false;
+		mCondensation.clear();
+		mScatterMapsGenerated = false; // the GSM is replaced by the condensed GSM, or the other way around
+	} // setCondensedGroups()
+	
+	void fea::setThreadCount(const unsigned int& n)
+	{
+		if (n == 0)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot set the thread count of an FEA system to zero.\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		if (n == 1) mThreadPool.reset();
+		else mThreadPool = std::make_shared<bso::utilities::thread_pool>(n);
+	} // setThreadCount()
+	
 	void fea::generateGSM()
 	{
 		if (!mSystemInitialized)
@@ -211,67 +1006,272 @@ namespace bso { namespace structural_design {
 				}
 			}
 			
-			// create and fill the load vectors
-			for (auto& i : mLoadCases)
+			// create and fill the load matrix, with one column per load case
+			mLoads = Eigen::MatrixXd::Zero(mDOFCount,mLoadCases.size());
+			for (unsigned long i = 0; i < mLoadCases.size(); ++i)
 			{
-				mLoads[i] = Eigen::VectorXd::Zero(mDOFCount);
 				for (auto & j : mNodes)
 				{
 					Eigen::Vector6d nodalLoads;
 					try
 					{
-						Eigen::Vector6d nodalLoads = j->getLoads(i);
+						nodalLoads = j->getLoads(mLoadCases[i]);
 					}
 					catch (std::exception& e)
 					{
 						// this node does not have a load with this load case
-						j->addLoadCase(i);
-						Eigen::Vector6d nodalLoads = j->getLoads(i);
+						j->addLoadCase(mLoadCases[i]);
+						nodalLoads = j->getLoads(mLoadCases[i]);
 					}
 					for (unsigned int k = 0; k < 6; ++k)
 					{
 						if (j->getNFS(k) == 0 || j->getConstraint(k) == 1) continue;
 						unsigned int DOF = j->getGlobalDOF(k);
-						mLoads[i](DOF) = nodalLoads(k);
+						mLoads(DOF,i) = nodalLoads(k);
 					}
 				}
 			}
 			
-			// create the displacement vectors
-			for (auto& i : mLoadCases) mDisplacements[i] = Eigen::VectorXd::Zero(mDOFCount);
+			// create the displacement matrix, the energies are sized with the elements in clearResponse()
+			mDisplacements = Eigen::MatrixXd::Zero(mDOFCount,mLoadCases.size());
+			mResponses.setLoadCases(mLoadCases);
 			
 			mSystemInitialized = true;
 		}
 	
-		mGSM.resize(0,0); // clear it in case there are still any components left
-		mGSM.resize(mDOFCount,mDOFCount); // size it to the numbe rof DOF''s in the system
+		if (!mCondensedGroups.empty())
+		{
+			if (mAssemblyMode == "matrix-free" || mAssemblyMode == "blocks")
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nError, cannot condense groups of elements of an FEA system in assembly mode:\n"
+										 << mAssemblyMode << ", only in assembly mode scatter or triplets\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+			if (!mCondensationInitialized)
+			{
+				mCondensation.initialize(mCondensedGroups,mElements,mDOFCount);
+				mCondensationInitialized = true;
+			}
+		}
+		if (mCondensation.isActive())
+		{ // the GSM couples the DOFs that are not interior to a group, each group is condensed separately
+			this->parallelFor(0, mCondensation.getGroupCount(), [&](const unsigned long& i)
+			{
+				mCondensation.condenseGroup(i,mElements);
+			});
+			Eigen::SparseMatrix<double> GSM = mCondensation.assemble(mElements);
+			if (!this->hasSamePattern(GSM)) this->resetPatternAnalysis();
+			mGSM = std::move(GSM);
+			return;
+		}
+		
+		if (mAssemblyMode == "matrix-free")
+		{ // the GSM is not assembled, only its diagonal is kept for preconditioning
+			if (mGSM.size() > 0 || !mScatterMaps.empty())
+			{ // release the memory of a previous assembly
+				Eigen::SparseMatrix<double>().swap(mGSM);
+				mBlockGSM.clear();
+				std::vector<unsigned long>().swap(mBlockDOFs);
+				std::vector<std::vector<std::pair<unsigned int, unsigned long> > >().swap(mScatterMaps);
+				std::vector<unsigned long>().swap(mGatherOffsets);
+				std::vector<std::pair<unsigned long, unsigned int> >().swap(mGatherEntries);
+				this->resetPatternAnalysis();
+			}
+			if (!mElementColoursGenerated) this->generateElementColours();
+			mGSMDiagonal.setZero(mDOFCount);
+			for (const auto& i : mElements)
+			{
+				const Eigen::MatrixXd& SM = i->getOriginalSM();
+				double factor = i->getStiffnessFactor();
+				for (const auto& j : i->getEFT()) mGSMDiagonal(j.second) += factor*SM(j.first,j.first);
+			}
+			return;
+		}
+		
+		if (mAssemblyMode == "scatter")
+		{ // the pattern is generated once, after that the element SMs are added straight into its values
+			if (!mScatterMapsGenerated) this->generateScatterMaps();
+			this->scatterElementSMs(mGSM.valuePtr(),mGSM.nonZeros());
+			return;
+		}
+		
+		if (mAssemblyMode == "blocks")
+		{ // as scatter, but into the blocks that couple the six DOFs of two nodes, of which the diagonal
+			// is kept for preconditioning
+			if (!mScatterMapsGenerated) this->generateBlockScatterMaps();
+			this->scatterElementSMs(mBlockGSM.data(),mBlockGSM.getValueCount());
+			Eigen::VectorXd blockDiagonal = mBlockGSM.diagonal();
+			mGSMDiagonal.resize(mDOFCount);
+			for (unsigned long i = 0; i < mDOFCount; ++i) mGSMDiagonal(i) = blockDiagonal(mBlockDOFs[i]);
+			return;
+		}
+		
+		Eigen::SparseMatrix<double> GSM(mDOFCount,mDOFCount); // size it to the number of DOF's in the system
+		
+		std::vector<std::vector<element::triplet> > elementTriplets(mElements.size());
+		this->parallelFor(0, mElements.size(), [&](const unsigned long& i)
+		{
+			elementTriplets[i] = mElements[i]->getSMTriplets();
+		});
 		
 		std::vector<element::triplet > triplets;
-		for (const auto& i : mElements)
+		for (const auto& i : elementTriplets)
 		{
-			auto trips = i->getSMTriplets();
-			triplets.insert(triplets.end(), trips.begin(), trips.end());
+			triplets.insert(triplets.end(), i.begin(), i.end());
 		}
 		
-		mGSM.setFromTriplets(triplets.begin(), triplets.end());
+		GSM.setFromTriplets(triplets.begin(), triplets.end());
+		
+		// only the numerical values may change between calls, the symbolic factorization can then be reused
+		if (!this->hasSamePattern(GSM)) this->resetPatternAnalysis();
+		mGSM = std::move(GSM);
+		mBlockGSM.clear();
+		std::vector<unsigned long>().swap(mBlockDOFs);
 	} // generateGSM()
 	
 	void fea::clearResponse()
 	{
 		for (auto& i : mElements) i->clearResponse();
-		for (auto& i : mNodes) i->clearDisplacements();
-		for (auto& i : mDisplacements) i.second.setZero();
+		mDisplacements.setZero();
+		mResponses.getEnergies().setZero(mElements.size(),mLoadCases.size()); // only reallocates if the size changed
 	} // clearResponse()
 	
-	void fea::solve(std::string solver /*= "SimplicialLLT"*/)
+	void fea::setOrdering(const std::string& method)
+	{
+		if (method != "AMD" && method != "COLAMD" && method != "nested-dissection" && method != "RCM" &&
+				method != "auto")
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nTrying to set unknown ordering for the direct solvers of an FEA system:\n"
+									 << method << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mOrderingMethod = method;
+		mOrderingPreset = false;
+		this->resetPatternAnalysis();
+	} // setOrdering()
+	
+	void fea::setOrdering(const solver::fill_reducing_ordering::permutation& order)
+	{ // the ordering is used as long as it has the size of the GSM, after that the method is used again
+		mOrdering = order;
+		mChosenOrdering = "preset";
+		mOrderingPreset = true;
+		this->resetPatternAnalysis();
+	} // setOrdering()
+	
+	void fea::setIterativeSolverSettings(const double& tolerance, const unsigned long& maxIterations /*= 0*/)
+	{
+		if (!(tolerance > 0))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, the tolerance of an iterative solver must be larger than zero,\n"
+									 << "received: " << tolerance << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mIterativeTolerance = tolerance;
+		mMaxIterations = maxIterations;
+	} // setIterativeSolverSettings()
+
+	void fea::setRefinementSettings(const double& tolerance, const unsigned long& maxRefinements /*= 10*/)
+	{
+		if (!(tolerance > 0))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, the tolerance of the iterative refinement must be larger than zero,\n"
+									 << "received: " << tolerance << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mRefinementTolerance = tolerance;
+		mMaxRefinements = maxRefinements;
+	} // setRefinementSettings()
+
+	void fea::setLowRankUpdateSettings(const double& maxFraction, const double& tolerance /*= 1e-8*/)
+	{ // the update solves the factorized GSM once per changed DOF, so it pays off as long as
+		// only a small fraction of the DOFs change
+		if (maxFraction < 0 || maxFraction > 1 || !(tolerance > 0))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, the fraction of changed DOFs for a low rank update must lie\n"
+									 << "between 0 and 1, and its tolerance must be larger than zero, received:\n"
+									 << maxFraction << " and " << tolerance << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mMaxUpdateFraction = maxFraction;
+		mUpdateTolerance = tolerance;
+	} // setLowRankUpdateSettings()
+
+	void fea::setPreconditionerReuse(const double& degradation)
+	{ // a preconditioner is kept while the iterations of a solve stay below the degradation factor
+		// times those of the solve right after it was computed, 0 computes it for every solve
+		if (degradation < 0 || (degradation > 0 && degradation < 1))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, the degradation factor for reusing a preconditioner must be 0,\n"
+									 << "or larger than or equal to 1, received: " << degradation << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mPreconditionerDegradation = degradation;
+	} // setPreconditionerReuse()
+	
+	void fea::setProlongationGenerator(std::function<std::vector<Eigen::SparseMatrix<double> >()> generator)
+	{ // the generator returns the prolongations from each coarser mesh to the next finer one, starting
+		// at this system's DOFs, it is called on the first solve with PCG-GMG after the mesh changed
+		mProlongationGenerator = generator;
+		mProlongationsGenerated = false;
+	} // setProlongationGenerator()
+
+	std::string fea::selectSolver()
+	{ // the properties of the system that is solved, which is the condensed one if condensation is active
+		solver::system_properties properties;
+		properties.DOFCount = (mCondensation.isActive()) ? mCondensation.getCondensedDOFCount() : mDOFCount;
+		properties.nonZeros = mGSM.nonZeros();
+		properties.assemblyMode = mAssemblyMode;
+		properties.condensed = mCondensation.isActive();
+		if (!mNodes.empty())
+		{
+			Eigen::Vector3d lower = *mNodes[0], upper = lower;
+			for (const auto& i : mNodes)
+			{
+				lower = lower.cwiseMin(Eigen::Vector3d(*i));
+				upper = upper.cwiseMax(Eigen::Vector3d(*i));
+			}
+			Eigen::Vector3d extent = upper - lower;
+			for (unsigned int i = 0; i < 3; ++i) if (extent(i) > 1e-6*extent.maxCoeff()) ++properties.dimensions;
+		}
+		if (mAssemblyMode != "matrix-free" && mAssemblyMode != "blocks")
+		{ // the ordering is kept for the direct solvers
+			properties.estimateFill = [this]()
+			{
+				this->generateOrdering();
+				return mOrderingFill;
+			};
+		}
+		mSolverSelection = solver::solver_registry::instance().select(properties);
+		return mSolverSelection.solver;
+	} // selectSolver()
+
+	void fea::runSolver(const std::string& solver)
 	{
-		msolver = solver;
-		// solve the system with the specified solver
-		this->clearResponse();
 		if (solver == "SimplicialLLT") this->simplicialLLT();
 		else if (solver == "SimplicialLDLT") this->simplicialLDLT();
+		else if (solver == "DenseLDLT") this->denseLDLT();
+		else if (solver == "MixedLDLT") this->mixedLDLT();
+		else if (solver == "LowRankLDLT") this->lowRankLDLT();
 		else if (solver == "BiCGSTAB") this->BiCGSTAB();
 		else if (solver == "scaledBiCGSTAB") this->scaledBiCGSTAB();
+		else if (solver == "PCG") this->PCG();
+		else if (solver == "PCG-AMG") this->AMGPCG();
+		else if (solver == "PCG-GMG") this->GMGPCG();
+		else if (solver == "EbE-PCG") this->elementByElementPCG();
+		else if (solver == "Block-PCG") this->blockPCG();
+		else if (solver::solver_registry::instance().isRegistered(solver)) this->registeredSolve(solver);
 		else 
 		{
 			std::stringstream errorMessage;
@@ -280,28 +1280,76 @@ namespace bso { namespace structural_design {
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
+	} // runSolver()
 
-		// add the displacements to the nodes
-		for (auto& i : mNodes) i->addDisplacements(mDisplacements);
+	void fea::solve(std::string solver /*= "SimplicialLLT"*/, const bool& warmStart /*= false*/)
+	{
+		if (solver == "auto") solver = this->selectSolver();
+		msolver = solver;
+		// the iterative solvers start from the previous displacements if warm started
+		if (warmStart && mDisplacements.rows() == (long)mDOFCount && 
+				mDisplacements.cols() == (long)mLoadCases.size()) mInitialGuess = mDisplacements;
+		else mInitialGuess.resize(0,0);
 		
-		// compute the responses for elements for every load case
-		for (auto& i : mElements) 
+		// solve the system with the specified solver
+		this->clearResponse();
+		if ((mAssemblyMode == "matrix-free" && solver != "EbE-PCG") ||
+				(mAssemblyMode == "blocks" && solver != "EbE-PCG" && solver != "Block-PCG"))
 		{
-			for (auto& j : mLoadCases) 
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot solve an FEA system in assembly mode " << mAssemblyMode << " with solver:\n"
+									 << solver << ", only with EbE-PCG" << ((mAssemblyMode == "blocks") ? " or Block-PCG" : "") << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		if (mCondensation.isActive())
+		{ // the solvers see the condensed system: its loads, its number of DOFs and its displacements.
+			// Only those that work on the GSM alone can solve it
+			if (solver == "PCG-AMG" || solver == "PCG-GMG" || solver == "EbE-PCG" || solver == "Block-PCG")
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nCannot solve an FEA system with condensed groups of elements with solver:\n"
+										 << solver << "\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+			Eigen::MatrixXd loads = mCondensation.condenseLoads(mLoads);
+			unsigned long DOFCount = mCondensation.getCondensedDOFCount();
+			if (mInitialGuess.size() > 0) mInitialGuess = mCondensation.restrict(mInitialGuess);
+			std::swap(mLoads,loads);
+			std::swap(mDOFCount,DOFCount);
+			mDisplacements.setZero(mDOFCount,mLoadCases.size());
+			try
 			{
-				i->computeResponse(j);
+				this->runSolver(solver);
 			}
-		}		
+			catch (...)
+			{
+				std::swap(mLoads,loads);
+				std::swap(mDOFCount,DOFCount);
+				mDisplacements.setZero(mDOFCount,mLoadCases.size());
+				throw;
+			}
+			std::swap(mLoads,loads);
+			std::swap(mDOFCount,DOFCount);
+			mDisplacements = mCondensation.recover(mDisplacements,mLoads);
+		}
+		else this->runSolver(solver);
+
+		// compute the responses for elements for every load case, the nodes read
+		// their displacements from the same buffer
+		this->computeResponses();
 	} // solve()
 
 	Eigen::MatrixXd fea::solveAdjoint(Eigen::MatrixXd& ae) // for stress_based topopt
 	{
 		Eigen::MatrixXd Lambda;
+		Eigen::MatrixXd rhs = (mCondensation.isActive()) ? mCondensation.condenseLoads(ae) : ae;
 		if (msolver == "SimplicialLLT")
 		{
 			try
 			{
-				Lambda = mLLTSolver.solve(ae);
+				Lambda = mLLTSolver.solve(rhs);
 				if (mLLTSolver.info() != Eigen::Success)
 				{
 					throw std::runtime_error("Solver failed");
@@ -316,11 +1364,11 @@ namespace bso { namespace structural_design {
 				throw std::runtime_error(errorMessage.str());
 			}
 		}
-		else if (msolver == "SimplicialLDLT")
+		else if (msolver == "SimplicialLDLT" || (msolver == "MixedLDLT" && mMixedLDLTFellBack))
 		{
 			try
 			{
-				Lambda = mLDLTSolver.solve(ae);
+				Lambda = mLDLTSolver.solve(rhs);
 				if (mLDLTSolver.info() != Eigen::Success)
 				{
 					throw std::runtime_error("Solver failed");
@@ -335,6 +1383,29 @@ namespace bso { namespace structural_design {
 				throw std::runtime_error(errorMessage.str());
 			}
 		}
+		else if (msolver == "LowRankLDLT")
+		{
+			Lambda = this->solveLowRank(rhs);
+		}
+		else if (msolver == "DenseLDLT")
+		{
+			Lambda = mDenseLDLTSolver.solve(rhs);
+		}
+		else if (solver::solver_registry::instance().isRegistered(msolver))
+		{
+			solver::solver_registry::instance().getBackEnd(msolver)(mGSM,rhs,Lambda);
+		}
+		else if (msolver == "MixedLDLT")
+		{
+			std::vector<unsigned long> refinements;
+			std::vector<double> residuals;
+			if (!this->refineMixedLDLT(rhs,Lambda,refinements,residuals))
+			{ // the adjoint loads may refine worse than the loads, then the GSM is factorized in double
+				mMixedLDLTFellBack = true;
+				this->factorizeLDLT();
+				Lambda = mLDLTSolver.solve(rhs);
+			}
+		}
 		else
 		{
 			std::stringstream errorMessage;
@@ -342,21 +1413,192 @@ namespace bso { namespace structural_design {
 										<< msolver << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
+		if (mCondensation.isActive()) return mCondensation.recover(Lambda,ae);
 		return Lambda;
 	} // solveAdjoint()
 
-	bool fea::isSingular()
-	{
-		if (mGSM.nonZeros() == 0) return true;
-		Eigen::JacobiSVD<Eigen::MatrixXd> SVD(mGSM);
-		double cond = SVD.singularValues()(0) / SVD.singularValues()(SVD.singularValues().size()-1);
-		return cond > 1e10;
-	}
+	bool fea::isSingular(const double& conditionThreshold /*= 1e10*/)
+	{ // monitors the pivots of a sparse LDLT decomposition of the GSM. Each pivot lies between the
+		// smallest and the largest eigenvalue of the GSM, so the ratio between the largest diagonal
+		// entry and a pivot is a lower bound on the condition number of the GSM
+		if (mAssemblyMode == "matrix-free" || mAssemblyMode == "blocks")
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot check the singularity of an FEA system without an\n"
+									 << "assembled scalar GSM, set another assembly mode first.\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		if (!(conditionThreshold > 1))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot check the singularity of an FEA system with\n"
+									 << "condition number threshold: " << conditionThreshold << ",\n"
+									 << "the threshold must be larger than one.\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+
+		mMechanismDOFs.clear();
+		if (mGSM.nonZeros() == 0)
+		{
+			for (unsigned long i = 0; i < mDOFCount; ++i) mMechanismDOFs.push_back(i);
+			return true;
+		}
+
+		double maxDiagonal = mGSM.diagonal().cwiseAbs().maxCoeff();
+		double pivotThreshold = maxDiagonal / conditionThreshold;
 
+		// the shift keeps the decomposition from breaking down at a pivot that is exactly zero
+		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > LDLT;
+		LDLT.setShift(maxDiagonal * std::numeric_limits<double>::epsilon());
+		LDLT.compute(mGSM);
+
+		// find the first small (or negative) pivot, the pivots after it are not reliable
+		const Eigen::VectorXd& D = LDLT.vectorD();
+		Eigen::Index pivot = -1;
+		for (Eigen::Index i = 0; i < D.size(); ++i)
+		{
+			if (D(i) <= pivotThreshold)
+			{
+				pivot = i;
+				break;
+			}
+		}
+		if (pivot == -1) return false;
+
+		// the mechanism's mode shape v follows from L^T*v = e_pivot, since then only the
+		// small pivot remains in: P*K*P^T*v = L*D*L^T*v = D(pivot)*L*e_pivot
+		Eigen::VectorXd mode = Eigen::VectorXd::Zero(D.size());
+		mode(pivot) = 1.0;
+		if (LDLT.info() == Eigen::Success) LDLT.matrixU().solveInPlace(mode);
+		mode = LDLT.permutationPinv() * mode;
+
+		double maxMode = mode.cwiseAbs().maxCoeff();
+		for (Eigen::Index i = 0; i < mode.size(); ++i)
+		{
+			if (std::abs(mode(i)) <= 1e-6 * maxMode) continue;
+			if (mCondensation.isActive()) mMechanismDOFs.push_back(mCondensation.getCondensedDOFs()[i]);
+			else mMechanismDOFs.push_back(i);
+		}
+		return true;
+	} // isSingular()
+
+	std::vector<element::node*> fea::getMechanismNodes() const
+	{ // returns the nodes that have at least one DOF that is involved in the mechanism
+		std::vector<bool> isMechanismDOF(mDOFCount,false);
+		for (const auto& i : mMechanismDOFs) isMechanismDOF[i] = true;
+
+		std::vector<element::node*> mechanismNodes;
+		for (const auto& i : mNodes)
+		{
+			for (unsigned int j = 0; j < 6; ++j)
+			{
+				if (i->getNFS(j) == 1 && i->getConstraint(j) == 0 &&
+						isMechanismDOF[i->getGlobalDOF(j)])
+				{
+					mechanismNodes.push_back(i);
+					break;
+				}
+			}
+		}
+		return mechanismNodes;
+	} // getMechanismNodes()
+
+	unsigned long fea::getSystemMemoryUsage() const
+	{ // bytes held by the system of equations: the element stiffness matrices, the GSM and the maps to
+		// assemble it, the factors and preconditioners of the solvers, and the element colours
+		auto sparseBytes = [](const auto& A) -> unsigned long
+		{
+			using scalar = typename std::decay_t<decltype(A)>::Scalar;
+			return A.nonZeros()*(sizeof(scalar) + sizeof(int)) + (A.outerSize() + 1)*sizeof(int);
+		};
+		unsigned long bytes = 0;
+		std::unordered_set<const double*> elementSMs; // congruent elements share their stiffness matrix
+		for (const auto& i : mElements)
+		{
+			if (elementSMs.insert(i->getOriginalSM().data()).second) bytes += i->getOriginalSM().size()*sizeof(double);
+		}
+		if (mGSM.size() > 0) bytes += sparseBytes(mGSM);
+		for (const auto& i : mScatterMaps) bytes += i.size()*sizeof(i[0]);
+		bytes += mGatherOffsets.size()*sizeof(unsigned long);
+		bytes += mGatherEntries.size()*sizeof(std::pair<unsigned long, unsigned int>);
+		if (mLLTPatternAnalyzed && mLLTSolver.info() == Eigen::Success)
+		{
+			bytes += sparseBytes(mLLTSolver.matrixL().nestedExpression());
+		}
+		if (mLDLTPatternAnalyzed && mLDLTSolver.info() == Eigen::Success)
+		{
+			bytes += sparseBytes(mLDLTSolver.matrixL().nestedExpression());
+		}
+		if (mMixedLDLTPatternAnalyzed && mMixedLDLTSolver.info() == Eigen::Success)
+		{
+			bytes += sparseBytes(mMixedLDLTSolver.matrixL().nestedExpression());
+		}
+		if (mLowRankPatternAnalyzed && mLowRankSolver.info() == Eigen::Success)
+		{
+			bytes += sparseBytes(mLowRankSolver.matrixL().nestedExpression());
+		}
+		if (mLowRankBaseGSM.size() > 0) bytes += sparseBytes(mLowRankBaseGSM);
+		bytes += (mLowRankChange.size() + mLowRankSolutions.size())*sizeof(double);
+		bytes += mDenseLDLTSolver.rows()*mDenseLDLTSolver.cols()*sizeof(double);
+		bytes += sparseBytes(mPCGSolver.preconditioner().matrixL());
+		bytes += mAMGPCGSolver.preconditioner().getMemoryUsage();
+		bytes += mGMGPCGSolver.preconditioner().getMemoryUsage();
+		bytes += mBlockGSM.getMemoryUsage() + mBlockDOFs.size()*sizeof(unsigned long);
+		bytes += mCondensation.getMemoryUsage();
+		bytes += mOrdering.size()*sizeof(int);
+		for (const auto& i : mElementColours) bytes += i.size()*sizeof(unsigned long);
+		bytes += mGSMDiagonal.size()*sizeof(double);
+		return bytes;
+	} // getSystemMemoryUsage()
+	
+	void fea::updateDensities(const Eigen::VectorXd& x, const double& penal /*= 1*/, const std::string& type /*= "modifiedSIMP"*/)
+	{ // x contains the density of each element
+		if (x.size() != (long)mElements.size() || (type != "modifiedSIMP" && type != "regularSIMP"))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot update the densities of the " << mElements.size() << " elements of an FEA system\n"
+									 << "with " << x.size() << " densities and update type: " << type << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		bool regularSIMP = (type == "regularSIMP");
+		this->forEachElement([&](auto ele, const unsigned long& i){ele->setDensity(x(i),penal,regularSIMP);});
+	} // updateDensities()
+	
+	Eigen::VectorXd fea::getTotalEnergies() const
+	{
+		Eigen::VectorXd energies(mElements.size());
+		this->forEachElement([&](auto ele, const unsigned long& i){energies(i) = ele->getTotalEnergy();});
+		return energies;
+	} // getTotalEnergies()
+	
+	Eigen::VectorXd fea::getEnergySensitivities(const double& penal /*= 1*/) const
+	{
+		Eigen::VectorXd sensitivities(mElements.size());
+		this->forEachElement([&](auto ele, const unsigned long& i){sensitivities(i) = ele->getEnergySensitivity(penal);});
+		return sensitivities;
+	} // getEnergySensitivities()
+	
+	Eigen::VectorXd fea::getVolumes() const
+	{
+		Eigen::VectorXd volumes(mElements.size());
+		this->forEachElement([&](auto ele, const unsigned long& i){volumes(i) = ele->getVolume();});
+		return volumes;
+	} // getVolumes()
+	
+	Eigen::VectorXd fea::getStresses(const double& alpha /*= 0*/, const double& beta /*= 1.0 / sqrt(3)*/) const
+	{ // only defined for systems of flat shells and hexahedra
+		Eigen::VectorXd stresses(mElements.size());
+		this->forEachElement([&](auto ele, const unsigned long& i){stresses(i) = ele->getStressAtCenter(alpha,beta);}, true);
+		return stresses;
+	} // getStresses()
+	
 	Eigen::VectorXd fea::getDisplacements(element::load_case lc) const
 	{
-		auto dispSearch = mDisplacements.find(lc);
-		if (dispSearch == mDisplacements.end())
+		auto lcSearch = std::find(mLoadCases.begin(),mLoadCases.end(),lc);
+		if (lcSearch == mLoadCases.end())
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nRequested displacements for unknown load case:\n"
@@ -364,7 +1606,7 @@ namespace bso { namespace structural_design {
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		return dispSearch->second;
+		return mDisplacements.col(lcSearch - mLoadCases.begin());
 	}
 	
 } // namespace structural_design
@@ -1,55 +1,214 @@
 #ifndef SD_FEA_HPP
 #define SD_FEA_HPP
 
-#include <bso/structural_design/element/elements.hpp>
+#include <bso/structural_design/element/element_groups.hpp>
+#include <bso/structural_design/solver/block_sparse_matrix.hpp>
+#include <bso/structural_design/solver/fill_reducing_ordering.hpp>
+#include <bso/structural_design/solver/multigrid_preconditioner.hpp>
+#include <bso/structural_design/solver/reusable_solver.hpp>
+#include <bso/structural_design/solver/solver_registry.hpp>
+#include <bso/structural_design/solver/static_condensation.hpp>
+#include <bso/utilities/arena.hpp>
+#include <bso/utilities/geometry/vertex_grid.hpp>
+#include <bso/utilities/thread_pool.hpp>
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
 
+#include <functional>
+#include <memory>
+
 namespace bso { namespace structural_design {
 	
 	class fea
 	{
 	private:
+		std::unique_ptr<bso::utilities::arena> mOwnArena; // the arena of the nodes, unless the system shares one
+		bso::utilities::arena* mArena;
 		std::vector<element::node*> mNodes;
 		std::vector<element::element*> mElements;
+		std::vector<element::element*> mHeapElements; // elements that are not in the arena, these are deleted by this system
+		element::element_groups mElementGroups; // mElements grouped by their type, for the loops over all elements
+		bso::utilities::geometry::vertex_grid<element::node*> mNodeGrid; // spatial index to find existing nodes
 		
 		unsigned long mDOFCount = 0;
-		std::vector<element::load_case> mLoadCases;
-		std::map<element::load_case,Eigen::VectorXd> mLoads;
-		std::map<element::load_case,Eigen::VectorXd> mDisplacements;
+		std::vector<element::load_case> mLoadCases; // the order of the load cases is the column order of the load and displacement matrices
+		Eigen::MatrixXd mLoads; // DOF x load case
+		element::response_buffer mResponses; // the displacements and energies of the nodes and elements, per load case
+		Eigen::MatrixXd& mDisplacements; // DOF x load case, held by mResponses
 		
 		Eigen::SparseMatrix<double> mGSM;
 		bool mSystemInitialized = false;
 		
+		std::string mAssemblyMode = "scatter";
+		std::vector<std::vector<std::pair<unsigned int, unsigned long> > > mScatterMaps; // per element: pairs of an index in its SM and an index in the values of the GSM
+		bool mScatterMapsGenerated = false;
+		std::vector<unsigned long> mGatherOffsets; // per value of the GSM: the range of its contributions in mGatherEntries
+		std::vector<std::pair<unsigned long, unsigned int> > mGatherEntries; // per contribution: element index and index in its SM, in element order
+		std::vector<std::vector<unsigned long> > mElementColours; // groups of elements that share no DOFs, for the element by element products
+		bool mElementColoursGenerated = false;
+		Eigen::VectorXd mGSMDiagonal; // diagonal of the GSM, the preconditioner of the element by element solver
+		solver::block_sparse_matrix mBlockGSM; // the GSM in 6x6 blocks per pair of nodes, in assembly mode "blocks"
+		std::vector<unsigned long> mBlockDOFs; // per global DOF, its index in the vectors of the block GSM
+		std::vector<std::vector<unsigned long> > mCondensedGroups; // groups of elements that are condensed to superelements
+		solver::static_condensation mCondensation; // the GSM is the condensed GSM if it is active
+		bool mCondensationInitialized = false;
+		
+		std::shared_ptr<bso::utilities::thread_pool> mThreadPool; // runs the loops over the elements, these run serially if there is none
+		
 		std::string msolver;
-		Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > mLLTSolver;
-		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > mLDLTSolver;
+		solver::solver_selection mSolverSelection; // the decision of the last solve in mode "auto"
+		Eigen::LDLT<Eigen::MatrixXd> mDenseLDLTSolver;
+		solver::simplicial_LLT<Eigen::SparseMatrix<double> > mLLTSolver;
+		solver::simplicial_LDLT<Eigen::SparseMatrix<double> > mLDLTSolver;
+		bool mLLTPatternAnalyzed = false; // the ordering and symbolic factorization of the direct solvers are
+		bool mLDLTPatternAnalyzed = false; // reused as long as the sparsity pattern of the GSM does not change
+		std::string mOrderingMethod = "AMD"; // fill reducing ordering of the direct solvers
+		std::string mChosenOrdering; // the method of mOrdering, e.g. the one picked in mode "auto"
+		solver::fill_reducing_ordering::permutation mOrdering; // the DOFs of the GSM in the order they are eliminated
+		unsigned long mOrderingFill = 0; // estimated nonzeros of the factor with mOrdering
+		bool mOrderingGenerated = false;
+		bool mOrderingPreset = false; // mOrdering is set by setOrdering(), it is kept while it fits the GSM
+		solver::simplicial_LDLT<Eigen::SparseMatrix<float> > mMixedLDLTSolver; // single precision factor of the GSM
+		bool mMixedLDLTPatternAnalyzed = false;
+		bool mMixedLDLTFellBack = false; // the last MixedLDLT solve stalled and was solved in double precision
+		double mRefinementTolerance = 1e-10; // relative residual at which the iterative refinement stops
+		unsigned long mMaxRefinements = 10;
+		solver::simplicial_LDLT<Eigen::SparseMatrix<double> > mLowRankSolver; // factor of the GSM at the last full factorization of LowRankLDLT
+		bool mLowRankPatternAnalyzed = false;
+		Eigen::SparseMatrix<double> mLowRankBaseGSM; // the GSM that is factorized in mLowRankSolver
+		std::vector<unsigned long> mLowRankDOFs; // global DOFs coupled by the change of the GSM since its factorization
+		Eigen::MatrixXd mLowRankChange; // the change of the GSM on mLowRankDOFs
+		Eigen::MatrixXd mLowRankSolutions; // factorized GSM solved for the unit vectors of mLowRankDOFs
+		Eigen::PartialPivLU<Eigen::MatrixXd> mLowRankCapacitance; // capacitance matrix of the Woodbury identity
+		double mMaxUpdateFraction = 0.05; // fraction of the DOFs beyond which LowRankLDLT factorizes the GSM again
+		double mUpdateTolerance = 1e-8; // relative residual beyond which LowRankLDLT factorizes the GSM again
+		std::vector<unsigned long> mMechanismDOFs; // global DOFs involved in the mechanism found by isSingular()
+		double mIterativeTolerance = 1e-3; // relative residual at which the iterative solvers stop
+		unsigned long mMaxIterations = 0; // maximum iterations of the iterative solvers, 0 for their default
+		std::vector<unsigned long> mSolverIterations; // per load case, iterations of the last iterative solve, or refinements of MixedLDLT
+		std::vector<double> mSolverErrors; // per load case, relative residual of the last iterative solve or MixedLDLT
+		Eigen::MatrixXd mInitialGuess; // displacements of the previous solve if it is warm started, empty otherwise
+		double mPreconditionerDegradation = 0; // growth in iterations at which a preconditioner is recomputed, 0 to always recompute it
+		bool mPreconditionerReused = false;
+		solver::reusable_solver<Eigen::BiCGSTAB<Eigen::SparseMatrix<double>,
+			Eigen::DiagonalPreconditioner<double> > > mBiCGSTABSolver;
+		solver::reusable_solver<Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			Eigen::IncompleteCholesky<double> > > mPCGSolver;
+		solver::reusable_solver<Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			solver::multigrid_preconditioner> > mAMGPCGSolver;
+		solver::reusable_solver<Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			solver::multigrid_preconditioner> > mGMGPCGSolver;
+		std::function<std::vector<Eigen::SparseMatrix<double> >()> mProlongationGenerator; // prolongations from the coarser meshes of the same model
+		bool mProlongationsGenerated = false;
 
+		bool hasSamePattern(const Eigen::SparseMatrix<double>& GSM) const;
+		void resetPatternAnalysis();
+		void generateOrdering();
+		void generateScatterMaps();
+		void generateBlockScatterMaps();
+		void generateGatherMaps(const unsigned long& valueCount);
+		void scatterElementSMs(double* values, const unsigned long& valueCount);
+		void generateElementColours();
+		void multiplyElementByElement(const Eigen::VectorXd& x, Eigen::VectorXd& y);
+		void multiplyBlocks(const Eigen::VectorXd& x, Eigen::VectorXd& y);
+		template <class FUNC>
+		void parallelFor(const unsigned long& begin, const unsigned long& end, FUNC f) const;
+		template <class FUNC>
+		void forEachElement(FUNC f, const bool& parallel = false) const; // f(element, index) per element, by type
+		void computeResponses();
+		void generateNodeBlocks(std::vector<std::vector<unsigned long> >& blocks,
+			Eigen::MatrixXd& rigidBodyModes) const;
+		
 		// solvers
+		std::string selectSolver();
+		void runSolver(const std::string& solver);
 		void simplicialLLT();
+		void factorizeLDLT();
 		void simplicialLDLT();
+		void denseLDLT();
+		bool refineMixedLDLT(const Eigen::MatrixXd& B, Eigen::MatrixXd& X,
+			std::vector<unsigned long>& refinements, std::vector<double>& residuals) const;
+		void mixedLDLT();
+		Eigen::MatrixXd solveLowRank(const Eigen::MatrixXd& B) const;
+		void lowRankLDLT();
 		void BiCGSTAB();
 		void scaledBiCGSTAB();
+		template <class SOLVER>
+		void iterativeSolve(SOLVER& solver, const std::string& solverName);
+		void PCG();
+		void AMGPCG();
+		void GMGPCG();
+		template <class PRODUCT>
+		void jacobiPCG(PRODUCT multiply, const std::string& solverName);
+		void elementByElementPCG();
+		void blockPCG();
+		void registeredSolve(const std::string& solver);
 	public:
 		fea();
+		fea(bso::utilities::arena* meshArena); // the nodes are destroyed with meshArena
 		~fea();
 		
 		element::node* addNode(const bso::utilities::geometry::vertex& point);
-		void addElement(element::element* ele);
+		element::node* findNode(const bso::utilities::geometry::vertex& point) const {return mNodeGrid.find(point);}
+		void addElement(element::element* ele, const bool& inArena = false); // takes ownership of ele, unless it is created in getArena()
 		
+		void setAssemblyMode(const std::string& mode);
+		void setThreadCount(const unsigned int& n);
+		void setThreadPool(std::shared_ptr<bso::utilities::thread_pool> threadPool) {mThreadPool = threadPool;}
+		void setCondensedGroups(const std::vector<std::vector<unsigned long> >& groups); // indices in getElements() per group
 		void generateGSM();
 		void clearResponse();
 		
-		void solve(std::string solver = "SimplicialLDLT");
+		void setOrdering(const std::string& method); // "AMD", "COLAMD", "nested-dissection", "RCM" or "auto"
+		void setOrdering(const solver::fill_reducing_ordering::permutation& order); // e.g. one of an earlier system
+		void setIterativeSolverSettings(const double& tolerance, const unsigned long& maxIterations = 0);
+		void setRefinementSettings(const double& tolerance, const unsigned long& maxRefinements = 10);
+		void setLowRankUpdateSettings(const double& maxFraction, const double& tolerance = 1e-8);
+		void setPreconditionerReuse(const double& degradation);
+		void setProlongationGenerator(std::function<std::vector<Eigen::SparseMatrix<double> >()> generator);
+		void solve(std::string solver = "SimplicialLDLT", const bool& warmStart = false); // "auto" selects one by the solver registry
 		Eigen::MatrixXd solveAdjoint(Eigen::MatrixXd& ae);
-		bool isSingular();
+		bool isSingular(const double& conditionThreshold = 1e10);
+		const std::vector<unsigned long>& getMechanismDOFs() const {return mMechanismDOFs;}
+		const std::vector<unsigned long>& getSolverIterations() const {return mSolverIterations;}
+		const std::vector<double>& getSolverErrors() const {return mSolverErrors;}
+		const bool& getPreconditionerReused() const {return mPreconditionerReused;}
+		const std::string& getSolver() const {return msolver;}
+		const solver::solver_selection& getSolverSelection() const {return mSolverSelection;}
+		const solver::fill_reducing_ordering::permutation& getOrdering() const {return mOrdering;}
+		const std::string& getChosenOrdering() const {return mChosenOrdering;}
+		const unsigned long& getOrderingFill() const {return mOrderingFill;}
+		const solver::static_condensation& getCondensation() const {return mCondensation;}
+		const bool& getMixedPrecisionFallback() const {return mMixedLDLTFellBack;}
+		unsigned long getLowRankUpdateRank() const {return mLowRankDOFs.size();} // 0 if the last LowRankLDLT solve factorized the GSM
+		std::vector<element::node*> getMechanismNodes() const;
+		
+		// operations on all elements, the results are in the order of getElements()
+		void updateDensities(const Eigen::VectorXd& x, const double& penal = 1, const std::string& type = "modifiedSIMP");
+		Eigen::VectorXd getTotalEnergies() const;
+		Eigen::VectorXd getEnergySensitivities(const double& penal = 1) const;
+		Eigen::VectorXd getVolumes() const;
+		Eigen::VectorXd getStresses(const double& alpha = 0, const double& beta = 1.0 / sqrt(3)) const;
 		
 		Eigen::VectorXd getDisplacements(element::load_case lc) const;
+		const Eigen::MatrixXd& getDisplacements() const {return mDisplacements;}
+		const Eigen::MatrixXd& getEnergies() const {return mResponses.getEnergies();} // element x load case
+		const element::response_buffer& getResponses() const {return mResponses;}
+		const Eigen::MatrixXd& getLoads() const {return mLoads;}
+		const std::vector<element::load_case>& getLoadCases() const {return mLoadCases;}
+		bso::utilities::arena* getArena() const {return mArena;}
 		const std::vector<element::node*>& getNodes() const {return mNodes;}
 		std::vector<element::node*>& getNodes() {return mNodes;}
 		const std::vector<element::element*>& getElements() const {return mElements;}
 		std::vector<element::element*>& getElements() {return mElements;}
+		const element::element_groups& getElementGroups() const {return mElementGroups;}
 		const unsigned long& getDOFCount() const {return mDOFCount;}
+		const std::string& getAssemblyMode() const {return mAssemblyMode;}
+		unsigned int getThreadCount() const {return (mThreadPool) ? mThreadPool->size() : 1;}
+		const Eigen::SparseMatrix<double>& getGSM() const {return mGSM;}
+		const solver::block_sparse_matrix& getBlockGSM() const {return mBlockGSM;}
+		const std::vector<unsigned long>& getBlockDOFs() const {return mBlockDOFs;}
+		unsigned long getSystemMemoryUsage() const;
 	};
 	
 } // namespace structural_design
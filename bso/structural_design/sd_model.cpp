@@ -3,31 +3,50 @@
 
 #include <bso/structural_design/topology_optimization/topology_optimization.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
 namespace bso { namespace structural_design {
 	
 	void sd_model::clearMesh()
-	{
-		if (mIsMeshed)
-		{
-			mIsMeshed = false;
-			for (auto& i : mGeometries) i->clearMesh();
-			for (auto& i : mMeshedPoints) delete i;
-			delete mFEA;
-			mFEA = new fea();
-			mMeshedPoints.clear();
-		}
+	{ // also cleans up after a mesh that failed halfway
+		mIsMeshed = false;
+		for (auto& i : mGeometries) i->clearMesh();
+		delete mFEA;
+		mFEA = nullptr;
+		mMeshedPoints.clear();
+		mMeshArena->release(); // destroys all points, nodes and elements of the mesh at once
 	} // clearMesh()
 
 	sd_model::sd_model() 
+	: mMeshArena(new bso::utilities::arena()), mMeshedPoints(mMeshArena.get())
 	{
 		mTopOptStreamBuffer = nullptr;
 	} // ctor()
 	
 	sd_model::sd_model(const sd_model& rhs)
+	: mMeshArena(new bso::utilities::arena()), mMeshedPoints(mMeshArena.get())
 	{
+		mTopOptStreamBuffer = nullptr;
+		*this = rhs;
+	} // copy ctor
+	
+	void sd_model::copyComponents(const sd_model& rhs)
+	{ // copies the model and its settings, but not its mesh nor its threads
+		this->clearMesh();
+		for (auto& i : mPoints) delete i;
+		for (auto& i : mGeometries) delete i;
+		mPoints.clear();
+		mGeometries.clear();
+		
 		for (const auto& i : rhs.mPoints)
 		{
-			this->addPoint(*i);
+			auto newPoint = this->addPoint(*i);
+			for (const auto& j : i->getLoads()) newPoint->addLoad(j);
+			for (const auto& j : i->getConstraints()) newPoint->addConstraint(j);
 		}
 		for (const auto& i : rhs.mGeometries)
 		{
@@ -63,14 +82,27 @@ namespace bso { namespace structural_design {
 		}
 		mMeshSize = rhs.mMeshSize;
 		mTopOptStreamBuffer = rhs.mTopOptStreamBuffer;
-	}
+		mTopOptSolver = rhs.mTopOptSolver;
+		mTopOptWarmStart = rhs.mTopOptWarmStart;
+		mAssemblyMode = rhs.mAssemblyMode;
+		mStaticCondensation = rhs.mStaticCondensation;
+		mLoadCombinations = rhs.mLoadCombinations;
+		mStabilityChecked = false;
+	} // copyComponents()
+	
+	sd_model& sd_model::operator = (const sd_model& rhs)
+	{ // copies the model, but not its mesh
+		if (this == &rhs) return *this;
+		this->copyComponents(rhs);
+		this->setThreadCount(rhs.getThreadCount());
+		return *this;
+	} // operator =
 
 	sd_model::~sd_model()
 	{
 		for (auto& i : mPoints) delete i;
 		for (auto& i : mGeometries) delete i;
-		for (auto& i : mMeshedPoints) delete i;
-		if (mIsMeshed) delete mFEA;
+		delete mFEA;
 	} // //dtor()
 
 	component::point* sd_model::addPoint(bso::utilities::geometry::vertex p)
@@ -84,6 +116,7 @@ namespace bso { namespace structural_design {
 		}
 		unsigned int pointID = mPoints.size();
 		mPoints.push_back(new component::point(pointID, p));
+		++mRevision;
 		return mPoints.back();
 	} // addPoint()
 
@@ -98,6 +131,7 @@ namespace bso { namespace structural_design {
 			}
 		}
 		mGeometries.push_back(new component::line_segment(g));
+		++mRevision;
 		return mGeometries.back();
 	} // addGeometry(line_segment)
 	
@@ -112,6 +146,7 @@ namespace bso { namespace structural_design {
 			}
 		}
 		mGeometries.push_back(new component::quadrilateral(g));
+		++mRevision;
 		return mGeometries.back();
 	} // addGeometry(line_segment)
 	
@@ -126,6 +161,7 @@ namespace bso { namespace structural_design {
 			}
 		}
 		mGeometries.push_back(new component::quad_hexahedron(g));
+		++mRevision;
 		return mGeometries.back();
 	} // addGeometry(line_segment)
 	
@@ -141,6 +177,79 @@ namespace bso { namespace structural_design {
 		mMeshSize = n;
 	} // setMeshSize()
 	
+	void sd_model::setThreadCount(const unsigned int& n)
+	{ // sets the number of threads used to create the elements and in the loops over them in the FEA system
+		if (n == 0)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot set the thread count of a structural model to zero.\n"
+									 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		if (n == 1) mThreadPool.reset();
+		else mThreadPool = std::make_shared<bso::utilities::thread_pool>(n);
+		if (mIsMeshed) mFEA->setThreadPool(mThreadPool);
+	} // setThreadCount()
+	
+	void sd_model::setAssemblyMode(const std::string& mode)
+	{ // the assembly mode of the FEA system, "blocks" keeps the GSM in 6x6 blocks per pair of nodes,
+		// "matrix-free" only keeps the element stiffness matrices
+		if (mode != "scatter" && mode != "triplets" && mode != "blocks" && mode != "matrix-free")
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, trying to set unknown assembly mode for a structural model:\n"
+									 << mode << "\n"
+									 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mAssemblyMode = mode;
+		if (mIsMeshed)
+		{
+			mFEA->setAssemblyMode(mode);
+			mFEA->generateGSM();
+		}
+	} // setAssemblyMode()
+	
+	void sd_model::setStaticCondensation(const bool& condense)
+	{ // the interior nodes of each meshed quadrilateral only connect to the rest of the structure
+		// through its boundary, they are condensed out of the FEA system and recovered after a solve
+		mStaticCondensation = condense;
+		if (mIsMeshed)
+		{
+			if (condense) mFEA->setCondensedGroups(this->generateCondensedGroups());
+			else mFEA->setCondensedGroups({});
+			mFEA->generateGSM();
+		}
+	} // setStaticCondensation()
+	
+	std::vector<std::vector<unsigned long> > sd_model::generateCondensedGroups() const
+	{ // one group per quadrilateral, of its elements' indices in the FEA system
+		std::unordered_map<const element::element*, unsigned long> elementIndices;
+		for (unsigned long i = 0; i < mFEA->getElements().size(); ++i) elementIndices[mFEA->getElements()[i]] = i;
+		std::vector<std::vector<unsigned long> > groups;
+		for (const auto& i : mGeometries)
+		{
+			if (!i->isQuadrilateral() || i->getElements().size() < 2) continue;
+			groups.emplace_back();
+			for (const auto& j : i->getElements()) groups.back().push_back(elementIndices.at(j));
+		}
+		return groups;
+	} // generateCondensedGroups()
+	
+	unsigned long sd_model::getRevision() const
+	{ // the revisions only grow, so their sum changes with any of them
+		unsigned long revision = mRevision;
+		for (const auto& i : mPoints) revision += i->getRevision();
+		for (const auto& i : mGeometries) revision += i->getRevision();
+		return revision;
+	} // getRevision()
+	
+	bool sd_model::isMeshCurrent(const unsigned int& n, const bool& meshLoadPanels /*= true*/) const
+	{
+		return mIsMeshed && n == mMeshedSize && meshLoadPanels == mMeshedLoadPanels &&
+			this->getRevision() == mMeshedRevision;
+	} // isMeshCurrent()
+	
 	void sd_model::mesh()
 	{
 		this->mesh(mMeshSize);
@@ -148,15 +257,28 @@ namespace bso { namespace structural_design {
 
 	void sd_model::mesh(const unsigned int& n, bool meshLoadPanels /* = true */)
 	{
+		if (this->isMeshCurrent(n,meshLoadPanels))
+		{ // the model did not change since it was meshed, its elements are reset to how they were
+			// created: without responses, and with the densities of a new mesh
+			bool densitiesChanged = false;
+			for (auto& i : mFEA->getElements())
+			{
+				if (i->getDensity() == 1.0 && i->getStiffnessFactor() == 1.0) continue;
+				i->resetDensity();
+				densitiesChanged = true;
+			}
+			mFEA->clearResponse();
+			if (densitiesChanged) mFEA->generateGSM();
+			return;
+		}
+		
 		// intiialize a new FEA system
 		this->clearMesh();
 
 		// mesh the points
 		for (auto& i : mPoints)
 		{
-			unsigned long pointID = mMeshedPoints.size();
-			mMeshedPoints.push_back(new component::point(pointID, *i));
-			auto meshedPoint = mMeshedPoints.back();
+			auto meshedPoint = mMeshedPoints.addPoint(*i);
 			for (const auto& j : i->getLoads())
 			{
 				meshedPoint->addLoad(j);
@@ -176,7 +298,13 @@ namespace bso { namespace structural_design {
 		// create the nodes in the fea system and add loads and constraints to them
 		std::map<component::point*, element::node*> nodeMap;
 		element::node* nodePtr;
-		mFEA = new fea();
+		mFEA = new fea(mMeshArena.get());
+		mFEA->setThreadPool(mThreadPool);
+		mFEA->setAssemblyMode(mAssemblyMode);
+		mFEA->setProlongationGenerator([this](){return this->generateProlongations();});
+		mMeshedSize = n;
+		mMeshedLoadPanels = meshLoadPanels;
+		mMeshedRevision = this->getRevision();
 		for (auto& i : mMeshedPoints)
 		{
 			nodePtr = mFEA->addNode(*i);
@@ -195,9 +323,10 @@ namespace bso { namespace structural_design {
 			}
 		}
 
-		// create the elements
+		// collect the elements that are to be created, in order
+		std::vector<std::function<element::element*()> > elementFactories;
+		std::vector<std::pair<component::geometry*, component::structure> > elementOrigins;
 		unsigned long elementID = 0;
-		element::element* elePtr;
 		for (auto& i : mGeometries)
 		{
 			if (i->hasTruss())
@@ -227,13 +356,12 @@ namespace bso { namespace structural_design {
 							throw std::runtime_error(errorMessage.str());
 						}
 
-						elePtr = new element::truss(elementID++,j.E(), j.A(),
-													{firstNodeSearch->second,secondNodeSearch->second},
-													ERelativeLowerBound);
-						mFEA->addElement(elePtr);
-						i->addElement(elePtr);
-						if (j.isGhostComponent()) elePtr->isActiveInCompliance() = false;
-						if (!j.isVisible()) elePtr->visualize() = false;
+						std::vector<element::node*> trussNodes = {firstNodeSearch->second, secondNodeSearch->second};
+						elementFactories.push_back([=]() mutable ->element::element*{
+							return mMeshArena->create<element::truss>(elementID,j.E(), j.A(),
+								trussNodes, ERelativeLowerBound);});
+						elementOrigins.push_back({i,j});
+						++elementID;
 					}
 				}
 			}
@@ -263,23 +391,23 @@ namespace bso { namespace structural_design {
 					if (k.type() == "truss"){ continue; }// do nothing, these are meshed by one element already
 					else if (k.type() == "beam")
 					{
-						elePtr = new element::beam(elementID++,
-													k.E(), k.width(), k.height(), 
-													k.poisson(), elementNodes, ERelativeLowerBound);
-						mFEA->addElement(elePtr);
+						elementFactories.push_back([=]() mutable ->element::element*{
+							return mMeshArena->create<element::beam>(elementID,
+								k.E(), k.width(), k.height(), 
+								k.poisson(), elementNodes, ERelativeLowerBound);});
 					}
 					else if (k.type() == "flat_shell")
 					{
-						elePtr = new element::flat_shell(elementID++,
-													k.E(), k.thickness(), k.poisson(), 
-													elementNodes, ERelativeLowerBound);
-						mFEA->addElement(elePtr);
+						elementFactories.push_back([=]() mutable ->element::element*{
+							return mMeshArena->create<element::flat_shell>(elementID,
+								k.E(), k.thickness(), k.poisson(), 
+								elementNodes, ERelativeLowerBound);});
 					}
 					else if (k.type() == "quad_hexahedron")
 					{
-						elePtr = new element::quad_hexahedron(elementID++,
-													k.E(), k.poisson(), elementNodes, ERelativeLowerBound);
-						mFEA->addElement(elePtr);
+						elementFactories.push_back([=]() mutable ->element::element*{
+							return mMeshArena->create<element::quad_hexahedron>(elementID,
+								k.E(), k.poisson(), elementNodes, ERelativeLowerBound);});
 					}
 					else
 					{
@@ -290,19 +418,33 @@ namespace bso { namespace structural_design {
 												 << "(bso/structural_design/sd_model.cpp)" << std::endl;
 						throw std::runtime_error(errorMessage.str());
 					}
-					if (k.isGhostComponent()) elePtr->isActiveInCompliance() = false;
-					if (!k.isVisible()) elePtr->visualize() = false;
-					i->addElement(elePtr);
+					elementOrigins.push_back({i,k});
+					++elementID;
 				}
 			}
 		}
+		
+		// create the elements in the mesh arena, which derives their stiffness matrices, possibly in parallel
+		// if this throws, the elements that were created are destroyed by the next clearMesh()
+		std::vector<element::element*> elements(elementFactories.size(),nullptr);
+		auto createElement = [&](const unsigned long& i){elements[i] = elementFactories[i]();};
+		if (mThreadPool) mThreadPool->parallel_for(0,elements.size(),createElement);
+		else for (unsigned long i = 0; i < elements.size(); ++i) createElement(i);
+		for (unsigned long i = 0; i < elements.size(); ++i)
+		{
+			mFEA->addElement(elements[i],true);
+			elementOrigins[i].first->addElement(elements[i]);
+			if (elementOrigins[i].second.isGhostComponent()) elements[i]->isActiveInCompliance() = false;
+			if (!elementOrigins[i].second.isVisible()) elements[i]->visualize() = false;
+		}
 
 		// generate the fea system
+		if (mStaticCondensation) mFEA->setCondensedGroups(this->generateCondensedGroups());
 		mFEA->generateGSM();
 		mIsMeshed = true;
 	} // mesh()
 
-	void sd_model::analyze(std::string solver /*= : SimplicialLLT*/)
+	void sd_model::analyze(std::string solver /*= : SimplicialLLT*/, const bool& warmStart /*= false*/)
 	{
 		if (!mIsMeshed)
 		{
@@ -322,7 +464,7 @@ namespace bso { namespace structural_design {
 		}
 		try
 		{
-			mFEA->solve(solver);
+			mFEA->solve(solver,warmStart);
 		}
 		catch (std::exception& e)
 		{
@@ -334,15 +476,133 @@ namespace bso { namespace structural_design {
 		}
 	} // analyze()
 	
-	bool sd_model::isStable()
-	{
-		bool preMeshed = mIsMeshed;
-		mesh(1,false);
-		mIsMeshed = false;
-		bool isStable = !mFEA->isSingular();
-		if (preMeshed) this->mesh(); // mesh it back to original mesh size
-		return isStable;
-	}
+	Eigen::SparseMatrix<double> sd_model::generateProlongation(const sd_model& fine, const sd_model& coarse)
+	{ // interpolates the DOFs of the coarse model to those of the fine model, which is meshed with twice
+		// the mesh size. Each coarse element is split in halves along each of its directions, and each DOF
+		// of the fine node at a point of the resulting lattice is interpolated (bi/tri)linearly from the same
+		// DOF at the element's corners. The index of a corner holds its side along direction a in bit a.
+		const fea* fineFEA = fine.getFEA();
+		const fea* coarseFEA = coarse.getFEA();
+		std::vector<Eigen::Triplet<double> > triplets;
+		std::vector<bool> interpolated(fineFEA->getNodes().size(),false);
+		for (unsigned long i = 0; i < coarse.mGeometries.size(); ++i)
+		{
+			for (const auto& j : coarse.mGeometries[i]->getElementPoints())
+			{
+				unsigned int dimension = 0, latticeSize = 1;
+				while ((1u << dimension) < j.size()) {++dimension; latticeSize *= 3;}
+				std::vector<element::node*> coarseNodes;
+				for (const auto& k : j) coarseNodes.push_back(coarseFEA->findNode(*k));
+				
+				for (unsigned int k = 0; k < latticeSize; ++k)
+				{ // position k along direction a is (k/3^a)%3 half steps
+					std::vector<double> weights(j.size(),1.0);
+					bso::utilities::geometry::vertex location;
+					for (unsigned int l = 0; l < j.size(); ++l)
+					{
+						for (unsigned int a = 0, position = k; a < dimension; ++a, position /= 3)
+						{
+							double t = (position % 3)/2.0;
+							weights[l] *= ((l >> a) & 1) ? t : 1.0 - t;
+						}
+						location += weights[l] * (*j[l]);
+					}
+					element::node* fineNode = fineFEA->findNode(location);
+					if (fineNode == nullptr)
+					{
+						std::stringstream errorMessage;
+						errorMessage << "\nError, when generating the prolongation between two meshes,\n"
+												 << "could not find a node of the fine mesh at:\n" << location.transpose() << "\n"
+												 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+						throw std::runtime_error(errorMessage.str());
+					}
+					if (interpolated[fineNode->ID()-1]) continue;
+					interpolated[fineNode->ID()-1] = true;
+					
+					for (unsigned int m = 0; m < 6; ++m)
+					{
+						if (fineNode->getNFS(m) == 0 || fineNode->getConstraint(m) == 1) continue;
+						for (unsigned int l = 0; l < j.size(); ++l)
+						{
+							if (weights[l] == 0 || coarseNodes[l] == nullptr) continue;
+							if (coarseNodes[l]->getNFS(m) == 0 || coarseNodes[l]->getConstraint(m) == 1) continue;
+							triplets.push_back(Eigen::Triplet<double>(fineNode->getGlobalDOF(m),
+								coarseNodes[l]->getGlobalDOF(m),weights[l]));
+						}
+					}
+				}
+			}
+		}
+		Eigen::SparseMatrix<double> P(fineFEA->getDOFCount(),coarseFEA->getDOFCount());
+		P.setFromTriplets(triplets.begin(),triplets.end());
+		
+		// remove the coarse DOFs that do not interpolate any fine DOF, as they would make the coarse system singular
+		std::vector<Eigen::Triplet<double> > selection;
+		Eigen::VectorXi columnCounts = Eigen::VectorXi::Zero(P.cols());
+		for (int i = 0; i < P.outerSize(); ++i) columnCounts(i) = P.col(i).nonZeros();
+		for (int i = 0; i < P.cols(); ++i)
+		{
+			if (columnCounts(i) > 0) selection.push_back(Eigen::Triplet<double>(i,selection.size(),1.0));
+		}
+		if (selection.size() == (unsigned long)P.cols()) return P;
+		Eigen::SparseMatrix<double> S(P.cols(),selection.size());
+		S.setFromTriplets(selection.begin(),selection.end());
+		return P*S;
+	} // generateProlongation()
+	
+	std::vector<Eigen::SparseMatrix<double> > sd_model::generateProlongations() const
+	{ // meshes copies of this model at half, a quarter, etc. of its mesh size, for as long as that
+		// size is even, and returns the prolongations from each of those meshes to the next finer one
+		std::vector<Eigen::SparseMatrix<double> > prolongations;
+		if (!mIsMeshed) return prolongations;
+		std::unique_ptr<sd_model> finer, coarser;
+		for (unsigned int n = mMeshedSize; n % 2 == 0; n /= 2)
+		{
+			coarser.reset(new sd_model(*this));
+			coarser->mesh(n/2,mMeshedLoadPanels);
+			prolongations.push_back(generateProlongation((finer) ? *finer : *this,*coarser));
+			finer = std::move(coarser);
+		}
+		return prolongations;
+	} // generateProlongations()
+	
+	bool sd_model::isStable(const double& conditionThreshold /*= 1e10*/)
+	{ // checks the singularity of the model meshed at size 1 without its load panels. That is the mesh
+		// of the model itself if it is meshed so, otherwise a copy of the model is meshed, which keeps
+		// the mesh of the model. The result is reused until the model changes
+		unsigned long revision = this->getRevision();
+		if (mStabilityChecked && mStabilityRevision == revision && mStabilityThreshold == conditionThreshold)
+		{
+			return mIsStable;
+		}
+		bool hasLoadPanels = false;
+		for (const auto& i : mGeometries)
+		{
+			for (const auto& j : i->getStructures()) if (j.isGhostComponent()) hasLoadPanels = true;
+		}
+		
+		fea* checkedFEA = mFEA;
+		std::unique_ptr<sd_model> coarse;
+		if (!(this->isMeshCurrent(1,false) || (!hasLoadPanels && this->isMeshCurrent(1,true))) ||
+				mAssemblyMode == "blocks" || mAssemblyMode == "matrix-free")
+		{ // the singularity check needs the assembled GSM of the coarse mesh
+			coarse.reset(new sd_model());
+			coarse->copyComponents(*this);
+			coarse->mThreadPool = mThreadPool;
+			coarse->mAssemblyMode = "scatter";
+			coarse->mStaticCondensation = false;
+			coarse->mesh(1,false);
+			checkedFEA = coarse->mFEA;
+		}
+		mIsStable = !checkedFEA->isSingular(conditionThreshold);
+		mMechanismVertices.clear();
+		for (const auto& i : checkedFEA->getMechanismNodes()) mMechanismVertices.push_back(*i);
+		
+		mStabilityChecked = true;
+		mStabilityRevision = revision;
+		mStabilityThreshold = conditionThreshold;
+		return mIsStable;
+	} // isStable()
 	
 	void sd_model::rescaleStructuralVolume(const double& scaleFactor)
 	{
@@ -374,101 +634,359 @@ namespace bso { namespace structural_design {
 		mTopOptStreamBuffer = out.rdbuf();
 	}
 	
+	void sd_model::setTopOptSolver(const std::string& solver, const bool& warmStart /*= false*/)
+	{ // warm starts only affect the iterative solvers, the densities change little between iterations
+		mTopOptSolver = solver;
+		mTopOptWarmStart = warmStart;
+	} // setTopOptSolver()
+	
 	sd_results sd_model::getTotalResults()
-	{
+	{ // loops over the elements by type, only flat shells have separated energies
 		sd_results results;
-		for (const auto& i : mFEA->getElements())
+		mFEA->getElementGroups().forEach([&](const auto& group)
 		{
-			if (i->isActiveInCompliance())
+			for (const auto& i : group.elements)
 			{
-				results.mTotalStrainEnergy += i->getTotalEnergy();
-				if (i->isFlatShell())
+				if (i->isActiveInCompliance())
 				{
-					results.mShearStrainEnergy += i->getTotalEnergy("shear");
-					results.mAxialStrainEnergy += i->getTotalEnergy("axial");
-					results.mBendStrainEnergy  += i->getTotalEnergy("bending");
+					results.mTotalStrainEnergy += i->getTotalEnergy();
+					if constexpr (std::is_same<std::decay_t<decltype(*i)>, element::flat_shell>::value)
+					{
+						results.mShearStrainEnergy += i->getShearEnergy();
+						results.mAxialStrainEnergy += i->getAxialEnergy();
+						results.mBendStrainEnergy  += i->getBendingEnergy();
+					}
+					results.mTotalStructuralVolume += i->getVolume();
+				}
+				else
+				{
+					results.mGhostStrainEnergy += i->getTotalEnergy();
+					results.mGhostStructuralVolume += i->getVolume();
 				}
-				results.mTotalStructuralVolume += i->getVolume();
 			}
-			else
+		});
+		const Eigen::MatrixXd& energies = mFEA->getEnergies();
+		const auto& elements = mFEA->getElements();
+		for (unsigned long i = 0; i < mFEA->getLoadCases().size() && i < (unsigned long)energies.cols(); ++i)
+		{
+			double energy = 0;
+			for (unsigned long j = 0; j < elements.size(); ++j)
 			{
-				results.mGhostStrainEnergy += i->getTotalEnergy();
-				results.mGhostStructuralVolume += i->getVolume();
+				if (elements[j]->isActiveInCompliance()) energy += energies(j,i);
 			}
+			results.mStrainEnergyPerLoadCase[mFEA->getLoadCases()[i]] = energy;
 		}
 		return results;
 	} // getTotalResults()
 	
 	sd_results sd_model::getPartialResults(bso::utilities::geometry::polygon* geom)
 	{
-		sd_results results;
+		return this->getPartialResults(std::vector<bso::utilities::geometry::polygon*>({geom})).front();
+	} // getPartialResults()
+	
+	sd_results sd_model::getPartialResults(bso::utilities::geometry::polyhedron* geom)
+	{
+		return this->getPartialResults(std::vector<bso::utilities::geometry::polyhedron*>({geom})).front();
+	} // getPartialResults()
+	
+	std::vector<sd_results> sd_model::getPartialResults(
+		const std::vector<bso::utilities::geometry::polygon*>& geoms, const double& tol /*= 1e-3*/)
+	{
+		return this->collectPartialResults(geoms,tol);
+	} // getPartialResults()
+	
+	std::vector<sd_results> sd_model::getPartialResults(
+		const std::vector<bso::utilities::geometry::polyhedron*>& geoms, const double& tol /*= 1e-3*/)
+	{
+		return this->collectPartialResults(geoms,tol);
+	} // getPartialResults()
+	
+	template <class REGION>
+	std::vector<sd_results> sd_model::collectPartialResults(const std::vector<REGION*>& regions,
+		const double& tol) const
+	{ // the element centroids are binned in a uniform grid, a region only visits the cells that its
+		// bounding box overlaps. An element of which the bounding box is not inside that of the region
+		// is rejected, one that is, is accepted if the region is an axis-aligned box (or rectangle),
+		// and is otherwise tested node by node as before. Only polygons separate the flat shell energies.
+		typedef Eigen::Vector3d box_corner;
+		const auto& elements = mFEA->getElements();
+		unsigned long nElements = elements.size();
+		std::vector<std::pair<box_corner, box_corner> > elementBoxes(nElements);
+		box_corner modelMin = box_corner::Constant( std::numeric_limits<double>::max());
+		box_corner modelMax = box_corner::Constant(-std::numeric_limits<double>::max());
+		for (unsigned long i = 0; i < nElements; ++i)
+		{
+			auto& box = elementBoxes[i];
+			box.first  = box_corner::Constant( std::numeric_limits<double>::max());
+			box.second = box_corner::Constant(-std::numeric_limits<double>::max());
+			for (const auto& j : elements[i]->getNodes())
+			{
+				box.first  = box.first.cwiseMin(*j);
+				box.second = box.second.cwiseMax(*j);
+			}
+			modelMin = modelMin.cwiseMin(box.first);
+			modelMax = modelMax.cwiseMax(box.second);
+		}
 		
-		for (const auto& i : mFEA->getElements())
+		// about one element per cell, flat directions of the model get a single layer of cells
+		Eigen::Vector3i cellCount = Eigen::Vector3i::Ones();
+		box_corner cellSize = box_corner::Ones();
+		unsigned int divisions = std::max(1,(int)std::round(std::cbrt((double)nElements)));
+		for (unsigned int i = 0; i < 3 && nElements > 0; ++i)
+		{
+			if (modelMax(i) - modelMin(i) <= tol) continue;
+			cellCount(i) = divisions;
+			cellSize(i) = (modelMax(i) - modelMin(i))/divisions;
+		}
+		auto cellOf = [&](const double& coordinate, const unsigned int& axis)
+		{
+			int cell = std::floor((coordinate - modelMin(axis))/cellSize(axis));
+			return std::min(std::max(cell,0),cellCount(axis) - 1);
+		};
+		std::vector<std::vector<unsigned long> > cells(cellCount.prod());
+		for (unsigned long i = 0; i < nElements; ++i)
 		{
-			bool allPointsInsideOrOn = true;
-			for (const auto& j : i->getNodes())
+			box_corner centroid = (elementBoxes[i].first + elementBoxes[i].second)/2.0;
+			cells[(cellOf(centroid(2),2)*cellCount(1) + cellOf(centroid(1),1))*cellCount(0) +
+				cellOf(centroid(0),0)].push_back(i);
+		}
+		
+		std::vector<sd_results> results(regions.size());
+		std::vector<unsigned long> accepted;
+		for (unsigned long r = 0; r < regions.size(); ++r)
+		{
+			const auto& region = regions[r];
+			box_corner regionMin = box_corner::Constant( std::numeric_limits<double>::max());
+			box_corner regionMax = box_corner::Constant(-std::numeric_limits<double>::max());
+			for (const auto& i : *region)
+			{
+				regionMin = regionMin.cwiseMin(i);
+				regionMax = regionMax.cwiseMax(i);
+			}
+			
+			// the region is its bounding box if its vertices are all the distinct corners of that box
+			std::vector<unsigned int> corners;
+			unsigned int dimensions = 0;
+			bool isBox = true;
+			for (unsigned int i = 0; i < 3; ++i) if (regionMax(i) - regionMin(i) > tol) ++dimensions;
+			for (const auto& i : *region)
 			{
-				auto vertexPtr = dynamic_cast<bso::utilities::geometry::vertex*>(j);
-				if (!geom->isInsideOrOn(*vertexPtr))
+				unsigned int corner = 0;
+				for (unsigned int j = 0; j < 3 && isBox; ++j)
 				{
-					allPointsInsideOrOn = false;
-					break;
+					if (regionMax(j) - regionMin(j) <= tol) continue;
+					if (std::abs(i(j) - regionMax(j)) <= tol) corner |= (1 << j);
+					else if (std::abs(i(j) - regionMin(j)) > tol) isBox = false;
 				}
+				corners.push_back(corner);
 			}
-			if (!allPointsInsideOrOn) continue;
+			std::sort(corners.begin(),corners.end());
+			isBox = isBox && (dimensions == (std::is_same<REGION, bso::utilities::geometry::polygon>::value ? 2 : 3)) &&
+				corners.size() == (1u << dimensions) &&
+				std::unique(corners.begin(),corners.end()) == corners.end();
 			
-			if (i->isActiveInCompliance())
+			regionMin.array() -= tol;
+			regionMax.array() += tol;
+			accepted.clear();
+			if (nElements == 0 || (regionMin.array() > modelMax.array()).any() ||
+					(regionMax.array() < modelMin.array()).any()) continue;
+			Eigen::Vector3i first, last;
+			for (unsigned int i = 0; i < 3; ++i)
 			{
-				results.mTotalStrainEnergy += i->getTotalEnergy();
-				if (i->isFlatShell())
+				first(i) = cellOf(regionMin(i),i);
+				last(i)  = cellOf(regionMax(i),i);
+			}
+			for (int z = first(2); z <= last(2); ++z)
+			{
+				for (int y = first(1); y <= last(1); ++y)
 				{
-					results.mShearStrainEnergy += i->getTotalEnergy("shear");
-					results.mAxialStrainEnergy += i->getTotalEnergy("axial");
-					results.mBendStrainEnergy  += i->getTotalEnergy("bending");
+					for (int x = first(0); x <= last(0); ++x)
+					{
+						for (const auto& i : cells[(z*cellCount(1) + y)*cellCount(0) + x])
+						{
+							if ((elementBoxes[i].first.array() < regionMin.array()).any() ||
+									(elementBoxes[i].second.array() > regionMax.array()).any()) continue;
+							bool allPointsInsideOrOn = true;
+							if (!isBox)
+							{
+								for (const auto& j : elements[i]->getNodes())
+								{
+									if (!region->isInsideOrOn(*j,tol))
+									{
+										allPointsInsideOrOn = false;
+										break;
+									}
+								}
+							}
+							if (allPointsInsideOrOn) accepted.push_back(i);
+						}
+					}
 				}
-				results.mTotalStructuralVolume += i->getVolume();
 			}
-			else
+			
+			// summed in the order of the FEA system, as when each element is tested
+			std::sort(accepted.begin(),accepted.end());
+			for (const auto& i : accepted)
 			{
-				results.mGhostStrainEnergy += i->getTotalEnergy();
-				results.mGhostStructuralVolume += i->getVolume();
+				const auto& e = elements[i];
+				if (e->isActiveInCompliance())
+				{
+					results[r].mTotalStrainEnergy += e->getTotalEnergy();
+					if (std::is_same<REGION, bso::utilities::geometry::polygon>::value && e->isFlatShell())
+					{
+						results[r].mShearStrainEnergy += e->getTotalEnergy("shear");
+						results[r].mAxialStrainEnergy += e->getTotalEnergy("axial");
+						results[r].mBendStrainEnergy  += e->getTotalEnergy("bending");
+					}
+					results[r].mTotalStructuralVolume += e->getVolume();
+				}
+				else
+				{
+					results[r].mGhostStrainEnergy += e->getTotalEnergy();
+					results[r].mGhostStructuralVolume += e->getVolume();
+				}
 			}
 		}
 		return results;
-	} // getPartialResults()
+	} // collectPartialResults()
 	
-	sd_results sd_model::getPartialResults(bso::utilities::geometry::polyhedron* geom)
+	void sd_model::addLoadCombination(const std::string& name,
+		const std::vector<std::pair<component::load_case, double> >& factors)
+	{ // replaces a combination with the same name
+		if (name.empty() || factors.empty())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot add a load combination without a name or load cases\n"
+									 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mLoadCombinations[name] = factors;
+	} // addLoadCombination()
+	
+	void sd_model::removeLoadCombination(const std::string& name)
 	{
+		mLoadCombinations.erase(name);
+	} // removeLoadCombination()
+	
+	Eigen::VectorXd sd_model::getCombinationFactors(const std::string& name) const
+	{ // a load case that has no loads in this model contributes nothing, e.g. wind from a direction
+		// the model is not loaded from
+		auto combination = mLoadCombinations.find(name);
+		if (combination == mLoadCombinations.end() || mFEA == nullptr ||
+				mFEA->getDisplacements().cols() != (long)mFEA->getLoadCases().size() ||
+				mFEA->getDisplacements().rows() != (long)mFEA->getDOFCount())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot superpose load combination: " << name << ",\n"
+									 << "it does not exist, or the model is not analyzed\n"
+									 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		const auto& loadCases = mFEA->getLoadCases();
+		Eigen::VectorXd factors = Eigen::VectorXd::Zero(loadCases.size());
+		for (const auto& i : combination->second)
+		{
+			auto search = std::find(loadCases.begin(),loadCases.end(),i.first);
+			if (search != loadCases.end()) factors(search - loadCases.begin()) += i.second;
+		}
+		return factors;
+	} // getCombinationFactors()
+	
+	template <class ENERGY>
+	sd_results sd_model::collectResults(ENERGY energy) const
+	{ // as getTotalResults(), for the energy of a single load case or combination
 		sd_results results;
-		
 		for (const auto& i : mFEA->getElements())
 		{
-			bool allPointsInsideOrOn = true;
-			for (const auto& j : i->getNodes())
+			if (i->isActiveInCompliance())
 			{
-				auto vertexPtr = dynamic_cast<bso::utilities::geometry::vertex*>(j);
-				if (!geom->isInsideOrOn(*vertexPtr))
+				results.mTotalStrainEnergy += energy(i,"");
+				if (i->isFlatShell())
 				{
-					allPointsInsideOrOn = false;
-					break;
+					results.mShearStrainEnergy += energy(i,"shear");
+					results.mAxialStrainEnergy += energy(i,"axial");
+					results.mBendStrainEnergy  += energy(i,"bending");
 				}
-			}
-			if (!allPointsInsideOrOn) continue;
-
-			if (i->isActiveInCompliance())
-			{
-				results.mTotalStrainEnergy += i->getTotalEnergy();
 				results.mTotalStructuralVolume += i->getVolume();
 			}
 			else
 			{
-				results.mGhostStrainEnergy += i->getTotalEnergy();
+				results.mGhostStrainEnergy += energy(i,"");
 				results.mGhostStructuralVolume += i->getVolume();
 			}
 		}
 		return results;
-	} // getPartialResults()
+	} // collectResults()
 	
+	sd_results sd_model::getLoadCaseResults(const component::load_case& lc) const
+	{ // from the energies computed by the last analysis
+		long column = -1;
+		if (mFEA != nullptr && mFEA->getEnergies().cols() == (long)mFEA->getLoadCases().size())
+		{
+			const auto& loadCases = mFEA->getLoadCases();
+			auto search = std::find(loadCases.begin(),loadCases.end(),lc);
+			if (search != loadCases.end()) column = search - loadCases.begin();
+		}
+		if (column < 0)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot retrieve the results of load case: " << lc << ",\n"
+									 << "it has no loads, or the model is not analyzed\n"
+									 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		const Eigen::MatrixXd& energies = mFEA->getEnergies();
+		std::unordered_map<const element::element*, unsigned long> rows;
+		for (unsigned long i = 0; i < mFEA->getElements().size(); ++i) rows[mFEA->getElements()[i]] = i;
+		sd_results results = this->collectResults([&](const element::element* ele, const std::string& type)
+		{
+			if (type == "") return energies(rows[ele],column);
+			return ele->getEnergy(lc,(type == "axial") ? "normal" : type);
+		});
+		results.mStrainEnergyPerLoadCase[lc] = results.mTotalStrainEnergy;
+		return results;
+	} // getLoadCaseResults()
+	
+	Eigen::VectorXd sd_model::getCombinationDisplacements(const std::string& name) const
+	{ // the solution is linear in the loads, so the displacements of a combination are the factored
+		// sum of those of its load cases, without solving the system again
+		return mFEA->getDisplacements() * this->getCombinationFactors(name);
+	} // getCombinationDisplacements()
+	
+	std::vector<Eigen::VectorXd> sd_model::getCombinationForces(const std::string& name) const
+	{
+		Eigen::VectorXd U = this->getCombinationDisplacements(name);
+		std::vector<Eigen::VectorXd> forces;
+		forces.reserve(mFEA->getElements().size());
+		for (const auto& i : mFEA->getElements()) forces.push_back(i->getForces(i->extractDisplacements(U)));
+		return forces;
+	} // getCombinationForces()
+	
+	sd_results sd_model::getCombinationResults(const std::string& name) const
+	{ // the energies are quadratic in the displacements, they are computed from the superposed
+		// displacements of each element rather than superposed themselves
+		Eigen::VectorXd factors = this->getCombinationFactors(name);
+		Eigen::VectorXd U = mFEA->getDisplacements() * factors;
+		const element::element* current = nullptr;
+		Eigen::VectorXd u;
+		sd_results results = this->collectResults([&](const element::element* ele, const std::string& type)
+		{
+			if (ele != current)
+			{
+				u = ele->extractDisplacements(U);
+				current = ele;
+			}
+			return ele->getStrainEnergy(u,type);
+		});
+		return results;
+	} // getCombinationResults()
+	
+	std::map<std::string, sd_results> sd_model::getCombinationResults() const
+	{
+		std::map<std::string, sd_results> results;
+		for (const auto& i : mLoadCombinations) results[i.first] = this->getCombinationResults(i.first);
+		return results;
+	} // getCombinationResults()
 
 } // namespace structural_design
 } // namespace bso
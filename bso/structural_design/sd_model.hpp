@@ -1,10 +1,14 @@
 #ifndef SD_MODEL_HPP
 #define SD_MODEL_HPP
 
+#include <functional>
+#include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <bso/structural_design/fea.hpp>
 #include <bso/structural_design/component/point.hpp>
+#include <bso/structural_design/component/point_store.hpp>
 #include <bso/structural_design/component/line_segment.hpp>
 #include <bso/structural_design/component/quadrilateral.hpp>
 #include <bso/structural_design/component/quad_hexahedron.hpp>
@@ -18,17 +22,42 @@ namespace bso { namespace structural_design {
 	private:
 		std::vector<component::point*> mPoints;
 		std::vector<component::geometry*> mGeometries;
-		std::vector<component::point*> mMeshedPoints;
+		std::unique_ptr<bso::utilities::arena> mMeshArena; // holds the meshed points, and the nodes and elements of the FEA system
+		component::point_store mMeshedPoints;
 		
-		fea* mFEA;
+		fea* mFEA = nullptr;
 		std::streambuf* mTopOptStreamBuffer;
+		std::string mTopOptSolver = "SimplicialLDLT"; // solver used in the iterations of the SIMP family
+		bool mTopOptWarmStart = false; // warm start the iterative solvers from the previous iteration's displacements
 		
 		unsigned int mMeshSize = 1;
+		unsigned int mMeshedSize = 0; // the mesh size and whether the load panels are meshed,
+		bool mMeshedLoadPanels = true; // as used in the last call to mesh()
+		std::string mAssemblyMode = "scatter"; // assembly mode of the FEA system, set when it is meshed
+		bool mStaticCondensation = false; // condense each meshed quadrilateral to its boundary DOFs
 		bool mIsMeshed = false;
+		unsigned long mRevision = 0; // counts the points and geometries added to the model
+		unsigned long mMeshedRevision = 0; // revision of the model when it was last meshed
+		bool mStabilityChecked = false; // the result of the last call to isStable(), which is reused
+		bool mIsStable = false; // as long as the revision and the threshold do not change
+		unsigned long mStabilityRevision = 0;
+		double mStabilityThreshold = 0;
+		std::vector<bso::utilities::geometry::vertex> mMechanismVertices; // nodes of the mechanism found by isStable()
+		std::map<std::string, std::vector<std::pair<component::load_case, double> > > mLoadCombinations; // the factored load cases of each combination
+		std::shared_ptr<bso::utilities::thread_pool> mThreadPool; // shared with the FEA system, none if single threaded
 		void clearMesh();
+		void copyComponents(const sd_model& rhs);
+		std::vector<std::vector<unsigned long> > generateCondensedGroups() const;
+		static Eigen::SparseMatrix<double> generateProlongation(const sd_model& fine, const sd_model& coarse);
+		Eigen::VectorXd getCombinationFactors(const std::string& name) const; // per load case of the FEA system
+		template <class ENERGY>
+		sd_results collectResults(ENERGY energy) const; // energy(element, type) of each element
+		template <class REGION>
+		std::vector<sd_results> collectPartialResults(const std::vector<REGION*>& regions, const double& tol) const;
 	public:
 		sd_model();
 		sd_model(const sd_model& rhs);
+		sd_model& operator = (const sd_model& rhs);
 		~sd_model();
 		
 		component::point* addPoint(bso::utilities::geometry::vertex p);
@@ -37,10 +66,17 @@ namespace bso { namespace structural_design {
 		component::geometry* addGeometry(const bso::utilities::geometry::quad_hexahedron& g);
 		
 		void setMeshSize(const unsigned int& n);
+		void setThreadCount(const unsigned int& n);
+		void setAssemblyMode(const std::string& mode);
+		void setStaticCondensation(const bool& condense);
+		unsigned int getThreadCount() const {return (mThreadPool) ? mThreadPool->size() : 1;}
+		unsigned long getRevision() const; // changes whenever a component of the model changes
+		bool isMeshCurrent(const unsigned int& n, const bool& meshLoadPanels = true) const;
 		void mesh();
 		void mesh(const unsigned int& n, bool meshLoadPanels = true);
-		void analyze(std::string solver = "SimplicialLDLT");
-		bool isStable();
+		void analyze(std::string solver = "SimplicialLDLT", const bool& warmStart = false);
+		bool isStable(const double& conditionThreshold = 1e10);
+		std::vector<Eigen::SparseMatrix<double> > generateProlongations() const;
 		
 		void rescaleStructuralVolume(const double& scaleFactor);
 		void setElementDensities(const double& volumeFraction, const double& penalty);
@@ -48,14 +84,30 @@ namespace bso { namespace structural_design {
 		template <typename T, typename...ARGS>
 		void topologyOptimization(const ARGS&...);
 		void setTopOptOutputStream(std::ostream& out);
+		void setTopOptSolver(const std::string& solver, const bool& warmStart = false);
 		
 		sd_results getTotalResults();
 		sd_results getPartialResults(bso::utilities::geometry::polygon* geom);
 		sd_results getPartialResults(bso::utilities::geometry::polyhedron* geom);
+		// of the elements inside or on each of the regions, in a single pass over a spatial index of the elements
+		std::vector<sd_results> getPartialResults(const std::vector<bso::utilities::geometry::polygon*>& geoms, const double& tol = 1e-3);
+		std::vector<sd_results> getPartialResults(const std::vector<bso::utilities::geometry::polyhedron*>& geoms, const double& tol = 1e-3);
+		
+		// load combinations, of which the responses are superposed from those of the solved load cases
+		void addLoadCombination(const std::string& name, const std::vector<std::pair<component::load_case, double> >& factors);
+		void removeLoadCombination(const std::string& name);
+		void clearLoadCombinations() {mLoadCombinations.clear();}
+		const std::map<std::string, std::vector<std::pair<component::load_case, double> > >& getLoadCombinations() const {return mLoadCombinations;}
+		sd_results getLoadCaseResults(const component::load_case& lc) const;
+		sd_results getCombinationResults(const std::string& name) const;
+		std::map<std::string, sd_results> getCombinationResults() const; // of all load combinations
+		Eigen::VectorXd getCombinationDisplacements(const std::string& name) const; // per global DOF
+		std::vector<Eigen::VectorXd> getCombinationForces(const std::string& name) const; // nodal forces per element, in the order of the FEA system
 		
 		fea* getFEA() {return mFEA;}
 		fea* const getFEA() const {return mFEA;}
 		const std::vector<component::point*>& getPoints() const {return mPoints;}
+		const std::vector<bso::utilities::geometry::vertex>& getMechanismVertices() const {return mMechanismVertices;}
 		const std::vector<component::geometry*> getGeometries() const {return mGeometries;}
 	};
 	
@@ -68,7 +120,7 @@ namespace bso { namespace structural_design {
 		double mTotalStructuralVolume = 0.0;
 		double mGhostStrainEnergy = 0.0;
 		double mGhostStructuralVolume = 0.0;
-		// std::map<element::load_case,double> strainEnergyPerLoadCase = {};
+		std::map<element::load_case,double> mStrainEnergyPerLoadCase = {}; // of the elements active in compliance
 	};
 	
 } // namespace structural_design
@@ -0,0 +1,131 @@
+#ifndef SD_BLOCK_SPARSE_MATRIX_CPP
+#define SD_BLOCK_SPARSE_MATRIX_CPP
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	block_sparse_matrix::block_sparse_matrix()
+	{
+		
+	} // ctor
+	
+	block_sparse_matrix::~block_sparse_matrix()
+	{
+		
+	} // dtor
+	
+	void block_sparse_matrix::setPattern(const unsigned long& blockRows,
+		std::vector<std::pair<unsigned long, unsigned long> > blockEntries)
+	{ // block entries are pairs of a block row and column, they may occur more than once
+		for (const auto& i : blockEntries)
+		{
+			if (i.first >= blockRows || i.second >= blockRows)
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nError, block (" << i.first << "," << i.second << ") is outside of a\n"
+										 << "block sparse matrix with " << blockRows << " block rows.\n"
+										 << "(bso/structural_design/solver/block_sparse_matrix.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+		}
+		std::sort(blockEntries.begin(),blockEntries.end());
+		blockEntries.erase(std::unique(blockEntries.begin(),blockEntries.end()),blockEntries.end());
+		
+		mBlockRows = blockRows;
+		mRowOffsets.assign(blockRows+1,0);
+		mColumns.resize(blockEntries.size());
+		for (unsigned long i = 0; i < blockEntries.size(); ++i)
+		{
+			++mRowOffsets[blockEntries[i].first+1];
+			mColumns[i] = blockEntries[i].second;
+		}
+		for (unsigned long i = 0; i < blockRows; ++i) mRowOffsets[i+1] += mRowOffsets[i];
+		mBlocks.assign(blockEntries.size(),block::Zero());
+	} // setPattern()
+	
+	void block_sparse_matrix::setZero()
+	{
+		for (auto& i : mBlocks) i.setZero();
+	} // setZero()
+	
+	void block_sparse_matrix::clear()
+	{ // releases the pattern and the values
+		mBlockRows = 0;
+		std::vector<unsigned long>().swap(mRowOffsets);
+		std::vector<unsigned long>().swap(mColumns);
+		std::vector<block, Eigen::aligned_allocator<block> >().swap(mBlocks);
+	} // clear()
+	
+	long block_sparse_matrix::findBlock(const unsigned long& row, const unsigned long& col) const
+	{ // returns the index of the block, or -1 if it is not in the pattern
+		if (row >= mBlockRows) return -1;
+		auto rowBegin = mColumns.begin() + mRowOffsets[row];
+		auto rowEnd   = mColumns.begin() + mRowOffsets[row+1];
+		auto search = std::lower_bound(rowBegin,rowEnd,col);
+		if (search == rowEnd || *search != col) return -1;
+		return search - mColumns.begin();
+	} // findBlock()
+	
+	void block_sparse_matrix::multiply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const
+	{ // y = A*x
+		y.resize(this->rows());
+		for (unsigned long i = 0; i < mBlockRows; ++i) this->multiplyRow(i,x,y);
+	} // multiply()
+	
+	void block_sparse_matrix::multiplyRow(const unsigned long& row, const Eigen::VectorXd& x,
+		Eigen::VectorXd& y) const
+	{ // the six values of y of one block row, block rows can be computed in parallel on a sized y
+		Eigen::Matrix<double,6,1> sum = Eigen::Matrix<double,6,1>::Zero();
+		for (unsigned long i = mRowOffsets[row]; i < mRowOffsets[row+1]; ++i)
+		{
+			sum.noalias() += mBlocks[i] * x.segment<6>(6*mColumns[i]);
+		}
+		y.segment<6>(6*row) = sum;
+	} // multiplyRow()
+	
+	Eigen::VectorXd block_sparse_matrix::diagonal() const
+	{
+		Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(this->rows());
+		for (unsigned long i = 0; i < mBlockRows; ++i)
+		{
+			long index = this->findBlock(i,i);
+			if (index >= 0) diagonal.segment<6>(6*i) = mBlocks[index].diagonal();
+		}
+		return diagonal;
+	} // diagonal()
+	
+	Eigen::SparseMatrix<double> block_sparse_matrix::toSparse() const
+	{ // the same matrix in Eigen's storage, without the zeros in the blocks
+		std::vector<Eigen::Triplet<double> > triplets;
+		for (unsigned long i = 0; i < mBlockRows; ++i)
+		{
+			for (unsigned long j = mRowOffsets[i]; j < mRowOffsets[i+1]; ++j)
+			{
+				for (unsigned int n = 0; n < 6; ++n)
+				{
+					for (unsigned int m = 0; m < 6; ++m)
+					{
+						if (mBlocks[j](m,n) == 0) continue;
+						triplets.push_back(Eigen::Triplet<double>(6*i+m,6*mColumns[j]+n,mBlocks[j](m,n)));
+					}
+				}
+			}
+		}
+		Eigen::SparseMatrix<double> A(this->rows(),this->rows());
+		A.setFromTriplets(triplets.begin(),triplets.end());
+		return A;
+	} // toSparse()
+	
+	unsigned long block_sparse_matrix::getMemoryUsage() const
+	{ // bytes of the values and the indices
+		return mBlocks.size()*(sizeof(block) + sizeof(unsigned long)) + mRowOffsets.size()*sizeof(unsigned long);
+	} // getMemoryUsage()
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_BLOCK_SPARSE_MATRIX_CPP
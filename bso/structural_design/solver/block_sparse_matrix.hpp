@@ -0,0 +1,59 @@
+#ifndef SD_BLOCK_SPARSE_MATRIX_HPP
+#define SD_BLOCK_SPARSE_MATRIX_HPP
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	/*
+	 * Sparse matrix in block compressed row storage, with 6x6 blocks that couple the six DOFs
+	 * of two nodes. One column index is stored per block instead of one per value, and the
+	 * products are done per block with fixed size (vectorized) operations. The vectors it is
+	 * multiplied with hold six values per node, in the order of the local DOFs of the nodes.
+	 */
+	
+	class block_sparse_matrix
+	{
+	public:
+		typedef Eigen::Matrix<double,6,6> block;
+	private:
+		unsigned long mBlockRows = 0;
+		std::vector<unsigned long> mRowOffsets; // per block row, the range of its blocks in mColumns and mBlocks
+		std::vector<unsigned long> mColumns; // per block, its block column, sorted within a block row
+		std::vector<block, Eigen::aligned_allocator<block> > mBlocks; // column major values of each block
+	public:
+		block_sparse_matrix();
+		~block_sparse_matrix();
+		
+		void setPattern(const unsigned long& blockRows,
+			std::vector<std::pair<unsigned long, unsigned long> > blockEntries);
+		void setZero();
+		void clear();
+		long findBlock(const unsigned long& row, const unsigned long& col) const;
+		
+		void multiply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+		void multiplyRow(const unsigned long& row, const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+		Eigen::VectorXd diagonal() const;
+		Eigen::SparseMatrix<double> toSparse() const;
+		
+		double* data() {return mBlocks.empty() ? nullptr : mBlocks[0].data();}
+		const double* data() const {return mBlocks.empty() ? nullptr : mBlocks[0].data();}
+		const block& getBlock(const unsigned long& index) const {return mBlocks[index];}
+		unsigned long rows() const {return 6*mBlockRows;}
+		const unsigned long& getBlockRows() const {return mBlockRows;}
+		unsigned long getBlockCount() const {return mBlocks.size();}
+		unsigned long getValueCount() const {return 36*mBlocks.size();}
+		unsigned long getMemoryUsage() const;
+	};
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/block_sparse_matrix.cpp>
+
+#endif // SD_BLOCK_SPARSE_MATRIX_HPP
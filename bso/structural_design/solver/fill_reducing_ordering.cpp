@@ -0,0 +1,247 @@
+#ifndef SD_FILL_REDUCING_ORDERING_CPP
+#define SD_FILL_REDUCING_ORDERING_CPP
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	void fill_reducing_ordering::generateNodeGraph(const Eigen::SparseMatrix<double>& A,
+		const std::vector<unsigned long>& DOFNodes, const unsigned long& nodeCount,
+		std::vector<std::vector<unsigned long> >& adjacency)
+	{ // two nodes are adjacent if the system couples one of their DOFs
+		if (DOFNodes.size() != (unsigned long)A.rows())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot order a system of " << A.rows() << " DOFs by its nodes,\n"
+									 << "received the nodes of " << DOFNodes.size() << " DOFs\n"
+									 << "(bso/structural_design/solver/fill_reducing_ordering.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		adjacency.assign(nodeCount,{});
+		for (long k = 0; k < A.outerSize(); ++k)
+		{
+			for (Eigen::SparseMatrix<double>::InnerIterator it(A,k); it; ++it)
+			{
+				unsigned long n1 = DOFNodes[it.row()], n2 = DOFNodes[it.col()];
+				if (n1 != n2) adjacency[n1].push_back(n2);
+			}
+		}
+		for (auto& i : adjacency)
+		{
+			std::sort(i.begin(),i.end());
+			i.erase(std::unique(i.begin(),i.end()),i.end());
+		}
+	} // generateNodeGraph()
+
+	fill_reducing_ordering::permutation fill_reducing_ordering::expandNodeOrder(
+		const std::vector<unsigned long>& nodeOrder, const std::vector<unsigned long>& DOFNodes,
+		const unsigned long& nodeCount)
+	{ // the DOFs of each node in the order of the nodes, and in their own order within a node
+		std::vector<unsigned long> offsets(nodeCount+1,0);
+		for (const auto& i : DOFNodes) ++offsets[i+1];
+		for (unsigned long i = 0; i < nodeCount; ++i) offsets[i+1] += offsets[i];
+		std::vector<unsigned long> nodeDOFs(DOFNodes.size());
+		std::vector<unsigned long> next(offsets.begin(),offsets.end()-1);
+		for (unsigned long i = 0; i < DOFNodes.size(); ++i) nodeDOFs[next[DOFNodes[i]]++] = i;
+
+		permutation order(DOFNodes.size());
+		unsigned long k = 0;
+		for (const auto& i : nodeOrder)
+		{
+			for (unsigned long j = offsets[i]; j < offsets[i+1]; ++j) order.indices()(k++) = nodeDOFs[j];
+		}
+		return order;
+	} // expandNodeOrder()
+
+	fill_reducing_ordering::permutation fill_reducing_ordering::AMD(const Eigen::SparseMatrix<double>& A)
+	{
+		permutation order;
+		Eigen::AMDOrdering<int>()(A,order);
+		return order;
+	} // AMD()
+
+	fill_reducing_ordering::permutation fill_reducing_ordering::COLAMD(const Eigen::SparseMatrix<double>& A)
+	{ // Eigen's COLAMD returns the position of each column, its inverse is the elimination order
+		Eigen::SparseMatrix<double> compressed = A;
+		compressed.makeCompressed();
+		permutation positions;
+		Eigen::COLAMDOrdering<int>()(compressed,positions);
+		return positions.inverse();
+	} // COLAMD()
+
+	fill_reducing_ordering::permutation fill_reducing_ordering::nestedDissection(
+		const Eigen::SparseMatrix<double>& A, const std::vector<unsigned long>& DOFNodes,
+		const std::vector<Eigen::Vector3d>& nodeCoordinates, const unsigned long& leafSize /*= 8*/)
+	{ // splits the nodes at the median of the longest side of their bounding box. The nodes of the
+		// first half that are adjacent to the second half separate the two halves, they are eliminated
+		// after both halves, which are dissected in turn
+		unsigned long nodeCount = nodeCoordinates.size();
+		std::vector<std::vector<unsigned long> > adjacency;
+		generateNodeGraph(A,DOFNodes,nodeCount,adjacency);
+
+		std::vector<bool> hasDOFs(nodeCount,false);
+		for (const auto& i : DOFNodes) hasDOFs[i] = true;
+		std::vector<unsigned long> nodes;
+		for (unsigned long i = 0; i < nodeCount; ++i) if (hasDOFs[i]) nodes.push_back(i);
+
+		std::vector<int> side(nodeCount,-1);
+		std::vector<unsigned long> nodeOrder;
+		std::function<void(std::vector<unsigned long>&)> dissect;
+		dissect = [&](std::vector<unsigned long>& part)
+		{
+			if (part.size() <= std::max(leafSize,(unsigned long)1))
+			{
+				nodeOrder.insert(nodeOrder.end(),part.begin(),part.end());
+				return;
+			}
+			Eigen::Vector3d lower = nodeCoordinates[part[0]], upper = lower;
+			for (const auto& i : part)
+			{
+				lower = lower.cwiseMin(nodeCoordinates[i]);
+				upper = upper.cwiseMax(nodeCoordinates[i]);
+			}
+			Eigen::Index axis;
+			(upper - lower).maxCoeff(&axis);
+			auto middle = part.begin() + part.size()/2;
+			std::nth_element(part.begin(),middle,part.end(),[&](const unsigned long& a, const unsigned long& b)
+			{
+				return nodeCoordinates[a](axis) < nodeCoordinates[b](axis) ||
+					(nodeCoordinates[a](axis) == nodeCoordinates[b](axis) && a < b);
+			});
+
+			std::vector<unsigned long> first(part.begin(),middle), second(middle,part.end()), separator;
+			for (const auto& i : second) side[i] = 1;
+			auto isSeparator = [&](const unsigned long& n)
+			{
+				for (const auto& j : adjacency[n]) if (side[j] == 1) return true;
+				return false;
+			};
+			for (const auto& i : first) if (isSeparator(i)) separator.push_back(i);
+			for (const auto& i : second) side[i] = -1;
+			if (separator.size() == first.size())
+			{ // the halves cannot be separated, e.g. when all nodes are coupled
+				nodeOrder.insert(nodeOrder.end(),part.begin(),part.end());
+				return;
+			}
+			for (const auto& i : separator) side[i] = 2;
+			first.erase(std::remove_if(first.begin(),first.end(),[&](const unsigned long& n){return side[n] == 2;}),
+				first.end());
+			for (const auto& i : separator) side[i] = -1;
+
+			std::vector<unsigned long>().swap(part);
+			dissect(first);
+			dissect(second);
+			nodeOrder.insert(nodeOrder.end(),separator.begin(),separator.end());
+		};
+		dissect(nodes);
+		return expandNodeOrder(nodeOrder,DOFNodes,nodeCount);
+	} // nestedDissection()
+
+	fill_reducing_ordering::permutation fill_reducing_ordering::reverseCuthillMcKee(
+		const Eigen::SparseMatrix<double>& A, const std::vector<unsigned long>& DOFNodes,
+		const unsigned long& nodeCount)
+	{ // breadth first search from a pseudo-peripheral node of each connected component, visiting
+		// the neighbours of a node by increasing degree, reversed
+		std::vector<std::vector<unsigned long> > adjacency;
+		generateNodeGraph(A,DOFNodes,nodeCount,adjacency);
+		std::vector<bool> hasDOFs(nodeCount,false);
+		for (const auto& i : DOFNodes) hasDOFs[i] = true;
+
+		std::vector<long> level(nodeCount,-1);
+		std::vector<unsigned long> visited; // the nodes visited by the last search
+		auto search = [&](const unsigned long& root, std::vector<unsigned long>& order)
+		{ // returns the last node of the last level with the smallest degree
+			for (const auto& i : visited) level[i] = -1;
+			visited.clear();
+			order.clear();
+			level[root] = 0;
+			visited.push_back(root);
+			std::deque<unsigned long> queue = {root};
+			std::vector<unsigned long> neighbours;
+			while (!queue.empty())
+			{
+				unsigned long n = queue.front();
+				queue.pop_front();
+				order.push_back(n);
+				neighbours.clear();
+				for (const auto& j : adjacency[n]) if (level[j] < 0) neighbours.push_back(j);
+				std::sort(neighbours.begin(),neighbours.end(),[&](const unsigned long& a, const unsigned long& b)
+				{
+					return adjacency[a].size() < adjacency[b].size() || (adjacency[a].size() == adjacency[b].size() && a < b);
+				});
+				for (const auto& j : neighbours)
+				{
+					level[j] = level[n] + 1;
+					visited.push_back(j);
+					queue.push_back(j);
+				}
+			}
+			unsigned long last = order.back();
+			for (const auto& i : order)
+			{
+				if (level[i] == level[last] && adjacency[i].size() < adjacency[last].size()) last = i;
+			}
+			return last;
+		};
+
+		std::vector<bool> ordered(nodeCount,false);
+		std::vector<unsigned long> nodeOrder, order;
+		for (unsigned long i = 0; i < nodeCount; ++i)
+		{
+			if (!hasDOFs[i] || ordered[i]) continue;
+			unsigned long root = i;
+			for (const auto& j : adjacency[i]) if (adjacency[j].size() < adjacency[root].size()) root = j;
+			long eccentricity = -1;
+			for (unsigned int j = 0; j < 5; ++j)
+			{ // move to the far end of the component while its eccentricity grows
+				unsigned long last = search(root,order);
+				if (level[last] <= eccentricity) break;
+				eccentricity = level[last];
+				root = last;
+			}
+			search(root,order);
+			for (const auto& j : order)
+			{
+				ordered[j] = true;
+				if (hasDOFs[j]) nodeOrder.push_back(j);
+			}
+		}
+		std::reverse(nodeOrder.begin(),nodeOrder.end());
+		return expandNodeOrder(nodeOrder,DOFNodes,nodeCount);
+	} // reverseCuthillMcKee()
+
+	unsigned long fill_reducing_ordering::estimateFill(const Eigen::SparseMatrix<double>& A, const permutation& order)
+	{ // symbolic factorization of the permuted system, along its elimination tree, as Eigen's
+		// simplicial solvers do before they factorize. It takes time in the order of the nonzeros of L
+		long n = A.rows();
+		std::vector<long> position(n), parent(n), flag(n);
+		for (long i = 0; i < n; ++i) position[order.indices()(i)] = i;
+		unsigned long fill = n;
+		for (long k = 0; k < n; ++k)
+		{
+			parent[k] = -1;
+			flag[k] = k;
+			for (Eigen::SparseMatrix<double>::InnerIterator it(A,order.indices()(k)); it; ++it)
+			{
+				long i = position[it.index()];
+				if (i >= k) continue;
+				for (; flag[i] != k; i = parent[i])
+				{
+					if (parent[i] == -1) parent[i] = k;
+					++fill;
+					flag[i] = k;
+				}
+			}
+		}
+		return fill;
+	} // estimateFill()
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_FILL_REDUCING_ORDERING_CPP
@@ -0,0 +1,83 @@
+#ifndef SD_FILL_REDUCING_ORDERING_HPP
+#define SD_FILL_REDUCING_ORDERING_HPP
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+#include <Eigen/OrderingMethods>
+
+#include <string>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	/*
+	 * Orderings of the DOFs of a symmetric system that reduce the fill of its Cholesky factor. All
+	 * are returned as the order in which the DOFs are eliminated: index k of the permutation is the
+	 * DOF that is eliminated k-th, which is the inverse permutation Eigen's ordering functors return.
+	 * Nested dissection and reverse Cuthill-McKee order the nodes, whose DOFs are the rows of the
+	 * system that share a node index, and keep the DOFs of a node together.
+	 */
+
+	class fill_reducing_ordering
+	{
+	public:
+		typedef Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,int> permutation;
+	private:
+		static void generateNodeGraph(const Eigen::SparseMatrix<double>& A, const std::vector<unsigned long>& DOFNodes,
+			const unsigned long& nodeCount, std::vector<std::vector<unsigned long> >& adjacency);
+		static permutation expandNodeOrder(const std::vector<unsigned long>& nodeOrder,
+			const std::vector<unsigned long>& DOFNodes, const unsigned long& nodeCount);
+	public:
+		static permutation AMD(const Eigen::SparseMatrix<double>& A);
+		static permutation COLAMD(const Eigen::SparseMatrix<double>& A);
+		static permutation nestedDissection(const Eigen::SparseMatrix<double>& A,
+			const std::vector<unsigned long>& DOFNodes, const std::vector<Eigen::Vector3d>& nodeCoordinates,
+			const unsigned long& leafSize = 8);
+		static permutation reverseCuthillMcKee(const Eigen::SparseMatrix<double>& A,
+			const std::vector<unsigned long>& DOFNodes, const unsigned long& nodeCount);
+		static unsigned long estimateFill(const Eigen::SparseMatrix<double>& A, const permutation& order); // nonzeros of the factor L
+	};
+
+	/*
+	 * Ordering functor for Eigen's simplicial Cholesky solvers, which construct it themselves. It
+	 * hands them the ordering that is set with a scope on the same thread, or orders by AMD if none
+	 * is set.
+	 */
+
+	template <typename STORAGE_INDEX>
+	class preset_ordering
+	{
+	public:
+		typedef Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,STORAGE_INDEX> PermutationType;
+	private:
+		static inline thread_local const PermutationType* mPreset = nullptr;
+	public:
+		class scope
+		{ // sets the ordering for the solvers that analyze a pattern during its lifetime
+		private:
+			const PermutationType* mPrevious;
+		public:
+			scope(const PermutationType& order) : mPrevious(mPreset) {mPreset = &order;}
+			~scope() {mPreset = mPrevious;}
+		};
+
+		template <typename MATRIX>
+		void operator()(const MATRIX& A, PermutationType& order)
+		{
+			if (mPreset != nullptr && mPreset->size() == A.rows()) order = *mPreset;
+			else Eigen::AMDOrdering<STORAGE_INDEX>()(A,order);
+		}
+	};
+
+	template <class MATRIX>
+	using simplicial_LLT = Eigen::SimplicialLLT<MATRIX, Eigen::Lower, preset_ordering<typename MATRIX::StorageIndex> >;
+	template <class MATRIX>
+	using simplicial_LDLT = Eigen::SimplicialLDLT<MATRIX, Eigen::Lower, preset_ordering<typename MATRIX::StorageIndex> >;
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/fill_reducing_ordering.cpp>
+
+#endif // SD_FILL_REDUCING_ORDERING_HPP
@@ -0,0 +1,310 @@
+#ifndef SD_MULTIGRID_PRECONDITIONER_CPP
+#define SD_MULTIGRID_PRECONDITIONER_CPP
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	void multigrid_preconditioner::aggregate(const Eigen::SparseMatrix<double>& A,
+		const std::vector<std::vector<unsigned long> >& blocks,
+		std::vector<std::vector<unsigned long> >& aggregates) const
+	{ // greedy aggregation of the graph of the blocks, an aggregate is a root block and its neighbours
+		std::vector<long> blockOf(A.rows(),-1);
+		for (unsigned long i = 0; i < blocks.size(); ++i)
+		{
+			for (const auto& j : blocks[i]) blockOf[j] = i;
+		}
+		std::vector<std::vector<unsigned long> > neighbours(blocks.size());
+		for (unsigned long i = 0; i < blocks.size(); ++i)
+		{
+			for (const auto& j : blocks[i])
+			{
+				for (Eigen::SparseMatrix<double>::InnerIterator it(A,j); it; ++it)
+				{
+					if (it.value() == 0) continue;
+					long k = blockOf[it.row()];
+					if (k >= 0 && (unsigned long)k != i) neighbours[i].push_back(k);
+				}
+			}
+			std::sort(neighbours[i].begin(),neighbours[i].end());
+			neighbours[i].erase(std::unique(neighbours[i].begin(),neighbours[i].end()),neighbours[i].end());
+		}
+		
+		aggregates.clear();
+		std::vector<long> aggregateOf(blocks.size(),-1);
+		for (unsigned long i = 0; i < blocks.size(); ++i)
+		{ // first pass: blocks of which no neighbour has been aggregated yet become a root
+			if (aggregateOf[i] != -1) continue;
+			bool isFree = true;
+			for (const auto& j : neighbours[i])
+			{
+				if (aggregateOf[j] != -1) {isFree = false; break;}
+			}
+			if (!isFree) continue;
+			aggregateOf[i] = aggregates.size();
+			aggregates.push_back({i});
+			for (const auto& j : neighbours[i])
+			{
+				aggregateOf[j] = aggregateOf[i];
+				aggregates.back().push_back(j);
+			}
+		}
+		std::vector<long> rootAggregateOf = aggregateOf;
+		for (unsigned long i = 0; i < blocks.size(); ++i)
+		{ // second pass: remaining blocks join an aggregate of the first pass that they neighbour
+			if (aggregateOf[i] != -1) continue;
+			for (const auto& j : neighbours[i])
+			{
+				if (rootAggregateOf[j] == -1) continue;
+				aggregateOf[i] = rootAggregateOf[j];
+				aggregates[aggregateOf[i]].push_back(i);
+				break;
+			}
+		}
+		for (unsigned long i = 0; i < blocks.size(); ++i)
+		{ // third pass: the blocks that are left form aggregates with their remaining neighbours
+			if (aggregateOf[i] != -1) continue;
+			aggregateOf[i] = aggregates.size();
+			aggregates.push_back({i});
+			for (const auto& j : neighbours[i])
+			{
+				if (aggregateOf[j] != -1) continue;
+				aggregateOf[j] = aggregateOf[i];
+				aggregates.back().push_back(j);
+			}
+		}
+	} // aggregate()
+	
+	bool multigrid_preconditioner::generateAggregationLevel(const Eigen::SparseMatrix<double>& A,
+		std::vector<std::vector<unsigned long> >& blocks, Eigen::MatrixXd& nearNullSpace,
+		Eigen::SparseMatrix<double>& P) const
+	{ // generates the smoothed prolongation from the next coarser level to this one, and the blocks
+		// and near null space of that coarser level. Returns false if the level cannot be coarsened.
+		std::vector<std::vector<unsigned long> > aggregates;
+		this->aggregate(A,blocks,aggregates);
+		if (aggregates.size() == blocks.size()) return false;
+		
+		// tentative prolongation: the near null space restricted to each aggregate, orthonormalized
+		unsigned int k = nearNullSpace.cols();
+		std::vector<Eigen::Triplet<double> > tentativeTriplets;
+		std::vector<std::vector<unsigned long> > coarseBlocks;
+		Eigen::MatrixXd coarseNearNullSpace(aggregates.size()*k,k);
+		unsigned long coarseSize = 0;
+		for (const auto& i : aggregates)
+		{
+			std::vector<unsigned long> DOFs;
+			for (const auto& j : i) DOFs.insert(DOFs.end(),blocks[j].begin(),blocks[j].end());
+			Eigen::MatrixXd localNullSpace(DOFs.size(),k);
+			for (unsigned long j = 0; j < DOFs.size(); ++j)
+			{
+				localNullSpace.row(j) = nearNullSpace.row(DOFs[j]);
+			}
+			Eigen::ColPivHouseholderQR<Eigen::MatrixXd> QR(localNullSpace);
+			QR.setThreshold(1e-8);
+			unsigned int rank = QR.rank();
+			if (rank == 0) continue;
+			Eigen::MatrixXd Q = QR.householderQ() * Eigen::MatrixXd::Identity(DOFs.size(),rank);
+			Eigen::MatrixXd R = QR.matrixR().topRows(rank).template triangularView<Eigen::Upper>();
+			coarseNearNullSpace.middleRows(coarseSize,rank) = R * QR.colsPermutation().transpose();
+			coarseBlocks.push_back({});
+			for (unsigned int j = 0; j < rank; ++j)
+			{
+				for (unsigned long m = 0; m < DOFs.size(); ++m)
+				{
+					tentativeTriplets.push_back(Eigen::Triplet<double>(DOFs[m],coarseSize+j,Q(m,j)));
+				}
+				coarseBlocks.back().push_back(coarseSize+j);
+			}
+			coarseSize += rank;
+		}
+		if (coarseSize >= (unsigned long)A.rows()) return false;
+		Eigen::SparseMatrix<double> tentativeP(A.rows(),coarseSize);
+		tentativeP.setFromTriplets(tentativeTriplets.begin(),tentativeTriplets.end());
+		
+		// smooth the prolongation with a damped Jacobi step: P = (I - w*D^-1*A)*tentativeP
+		Eigen::VectorXd inverseDiagonal = A.diagonal();
+		for (unsigned long i = 0; i < inverseDiagonal.size(); ++i)
+		{
+			inverseDiagonal(i) = (inverseDiagonal(i) > 0) ? 1.0/inverseDiagonal(i) : 0.0;
+		}
+		Eigen::VectorXd x(A.rows());
+		for (unsigned long i = 0; i < x.size(); ++i) x(i) = std::sin(i+1.0); // deterministic start vector
+		double spectralRadius = 0;
+		for (unsigned int i = 0; i < 20; ++i)
+		{ // estimate the spectral radius of D^-1*A by power iteration
+			x.normalize();
+			x = inverseDiagonal.asDiagonal() * (A * x);
+			spectralRadius = x.norm();
+		}
+		if (!(spectralRadius > 0)) return false;
+		double omega = 4.0/(3.0*spectralRadius);
+		Eigen::SparseMatrix<double> AP = A * tentativeP;
+		Eigen::SparseMatrix<double> DAP = inverseDiagonal.asDiagonal() * AP;
+		P = tentativeP - omega * DAP;
+		P.prune(0.0);
+		
+		blocks = coarseBlocks;
+		coarseNearNullSpace.conservativeResize(coarseSize,k);
+		nearNullSpace = coarseNearNullSpace;
+		return true;
+	} // generateAggregationLevel()
+	
+	void multigrid_preconditioner::smooth(const unsigned int& level, Eigen::VectorXd& x,
+		const Eigen::VectorXd& b, const bool& forward) const
+	{ // Gauss-Seidel sweeps, the operators are symmetric so a column holds the coefficients of a row
+		const Eigen::SparseMatrix<double>& A = mOperators[level];
+		Eigen::Index n = A.rows();
+		for (unsigned int step = 0; step < mSmoothingSteps; ++step)
+		{
+			for (Eigen::Index j = 0; j < n; ++j)
+			{
+				Eigen::Index i = (forward) ? j : n-1-j;
+				double diagonal = 0;
+				double sum = b(i);
+				for (Eigen::SparseMatrix<double>::InnerIterator it(A,i); it; ++it)
+				{
+					if (it.row() == i) diagonal = it.value();
+					else sum -= it.value() * x(it.row());
+				}
+				if (diagonal > 0) x(i) = sum/diagonal;
+			}
+		}
+	} // smooth()
+	
+	void multigrid_preconditioner::vCycle(const unsigned int& level, Eigen::VectorXd& x,
+		const Eigen::VectorXd& b) const
+	{
+		if (level+1 == mOperators.size())
+		{
+			x = mCoarseSolver.solve(b);
+			return;
+		}
+		this->smooth(level,x,b,true);
+		Eigen::VectorXd coarseResidual = mProlongations[level].transpose() * (b - mOperators[level]*x);
+		Eigen::VectorXd coarseCorrection = Eigen::VectorXd::Zero(coarseResidual.size());
+		this->vCycle(level+1,coarseCorrection,coarseResidual);
+		x += mProlongations[level] * coarseCorrection;
+		this->smooth(level,x,b,false);
+	} // vCycle()
+	
+	void multigrid_preconditioner::generateHierarchy(const Eigen::SparseMatrix<double>& A)
+	{
+		mOperators.clear();
+		mProlongations.clear();
+		mOperators.push_back(A);
+		mOperators.back().makeCompressed();
+		
+		if (!mGivenProlongations.empty())
+		{
+			for (const auto& i : mGivenProlongations)
+			{
+				if (i.rows() != mOperators.back().rows())
+				{
+					std::stringstream errorMessage;
+					errorMessage << "\nError, prolongation operator of size " << i.rows() << "x" << i.cols()
+											 << " does not match a level of size " << mOperators.back().rows() << ".\n"
+											 << "(bso/structural_design/solver/multigrid_preconditioner.cpp)" << std::endl;
+					throw std::invalid_argument(errorMessage.str());
+				}
+				mProlongations.push_back(i);
+				mOperators.push_back(Eigen::SparseMatrix<double>(i.transpose()) * (mOperators.back() * i));
+			}
+		}
+		else
+		{
+			std::vector<std::vector<unsigned long> > blocks = mBlocks;
+			Eigen::MatrixXd nearNullSpace = mNearNullSpace;
+			if (blocks.empty())
+			{ // without node information, each DOF is a block and the near null space is constant
+				for (unsigned long i = 0; i < (unsigned long)A.rows(); ++i) blocks.push_back({i});
+				nearNullSpace = Eigen::MatrixXd::Ones(A.rows(),1);
+			}
+			unsigned long blockDOFCount = 0;
+			for (const auto& i : blocks) blockDOFCount += i.size();
+			if (blockDOFCount != (unsigned long)A.rows() || nearNullSpace.rows() != A.rows())
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nError, the DOF blocks and near null space of the multigrid preconditioner\n"
+										 << "do not match the size of the matrix: " << A.rows() << ".\n"
+										 << "(bso/structural_design/solver/multigrid_preconditioner.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+			
+			while (mOperators.size() < mMaxLevels &&
+						 (unsigned long)mOperators.back().rows() > mCoarsestSize)
+			{
+				Eigen::SparseMatrix<double> P;
+				if (!this->generateAggregationLevel(mOperators.back(),blocks,nearNullSpace,P)) break;
+				mProlongations.push_back(P);
+				mOperators.push_back(Eigen::SparseMatrix<double>(P.transpose()) * (mOperators.back() * P));
+			}
+		}
+		
+		mCoarseSolver.compute(mOperators.back());
+		mInfo = mCoarseSolver.info();
+	} // generateHierarchy()
+	
+	multigrid_preconditioner::multigrid_preconditioner()
+	{
+		
+	} // ctor
+	
+	template <typename MatrixType>
+	multigrid_preconditioner::multigrid_preconditioner(const MatrixType& A)
+	{
+		this->compute(A);
+	} // ctor
+	
+	multigrid_preconditioner::~multigrid_preconditioner()
+	{
+		
+	} // dtor
+	
+	void multigrid_preconditioner::setNodes(const std::vector<std::vector<unsigned long> >& blocks,
+		const Eigen::MatrixXd& nearNullSpace)
+	{ // blocks contain the DOFs of each node, the near null space contains the rigid body modes
+		mBlocks = blocks;
+		mNearNullSpace = nearNullSpace;
+		mGivenProlongations.clear();
+	} // setNodes()
+	
+	void multigrid_preconditioner::setProlongations(const std::vector<Eigen::SparseMatrix<double> >& prolongations)
+	{ // prolongations from level l+1 to level l, from fine to coarse
+		mGivenProlongations = prolongations;
+	} // setProlongations()
+	
+	template <typename MatrixType>
+	multigrid_preconditioner& multigrid_preconditioner::factorize(const MatrixType& A)
+	{
+		this->generateHierarchy(Eigen::SparseMatrix<double>(A));
+		return *this;
+	} // factorize()
+	
+	Eigen::VectorXd multigrid_preconditioner::solve(const Eigen::VectorXd& b) const
+	{ // applies one V-cycle to b, starting from zero
+		Eigen::VectorXd x = Eigen::VectorXd::Zero(b.size());
+		this->vCycle(0,x,b);
+		return x;
+	} // solve()
+	
+	unsigned long multigrid_preconditioner::getMemoryUsage() const
+	{ // bytes of the operators and prolongations, without the factorization of the coarsest level
+		unsigned long bytes = 0;
+		for (const auto& i : {&mOperators, &mProlongations})
+		{
+			for (const auto& j : *i)
+			{
+				bytes += j.nonZeros()*(sizeof(double) + sizeof(int)) + (j.outerSize() + 1)*sizeof(int);
+			}
+		}
+		return bytes;
+	} // getMemoryUsage()
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_MULTIGRID_PRECONDITIONER_CPP
@@ -0,0 +1,78 @@
+#ifndef SD_MULTIGRID_PRECONDITIONER_HPP
+#define SD_MULTIGRID_PRECONDITIONER_HPP
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	/*
+	 * Multigrid V-cycle that can be used as the preconditioner of Eigen's iterative solvers.
+	 * The coarse levels follow from prolongation operators P by the Galerkin product P^T*A*P.
+	 * These operators are either generated by smoothed aggregation, from the DOFs grouped per
+	 * node and the near null space (rigid body modes) of the system, or they are given.
+	 * Smoothing is done by symmetric Gauss-Seidel, so the V-cycle is symmetric.
+	 */
+	
+	class multigrid_preconditioner
+	{
+	private:
+		std::vector<Eigen::SparseMatrix<double> > mOperators; // per level, from fine to coarse
+		std::vector<Eigen::SparseMatrix<double> > mProlongations; // from level l+1 to level l
+		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > mCoarseSolver;
+		
+		std::vector<std::vector<unsigned long> > mBlocks; // the DOFs of each node on the finest level
+		Eigen::MatrixXd mNearNullSpace; // the rigid body modes on the finest level
+		std::vector<Eigen::SparseMatrix<double> > mGivenProlongations;
+		
+		unsigned long mCoarsestSize = 500; // maximum number of DOFs on the coarsest level
+		unsigned int mMaxLevels = 10;
+		unsigned int mSmoothingSteps = 1;
+		Eigen::ComputationInfo mInfo = Eigen::Success;
+		
+		void aggregate(const Eigen::SparseMatrix<double>& A,
+			const std::vector<std::vector<unsigned long> >& blocks,
+			std::vector<std::vector<unsigned long> >& aggregates) const;
+		bool generateAggregationLevel(const Eigen::SparseMatrix<double>& A,
+			std::vector<std::vector<unsigned long> >& blocks, Eigen::MatrixXd& nearNullSpace,
+			Eigen::SparseMatrix<double>& P) const;
+		void smooth(const unsigned int& level, Eigen::VectorXd& x, const Eigen::VectorXd& b,
+			const bool& forward) const;
+		void vCycle(const unsigned int& level, Eigen::VectorXd& x, const Eigen::VectorXd& b) const;
+		void generateHierarchy(const Eigen::SparseMatrix<double>& A);
+	public:
+		multigrid_preconditioner();
+		template <typename MatrixType>
+		explicit multigrid_preconditioner(const MatrixType& A);
+		~multigrid_preconditioner();
+		
+		void setNodes(const std::vector<std::vector<unsigned long> >& blocks,
+			const Eigen::MatrixXd& nearNullSpace);
+		void setProlongations(const std::vector<Eigen::SparseMatrix<double> >& prolongations);
+		void setCoarsestSize(const unsigned long& n) {mCoarsestSize = n;}
+		void setSmoothingSteps(const unsigned int& n) {mSmoothingSteps = n;}
+		
+		// interface of Eigen's preconditioners
+		template <typename MatrixType>
+		multigrid_preconditioner& analyzePattern(const MatrixType& A) {return *this;}
+		template <typename MatrixType>
+		multigrid_preconditioner& factorize(const MatrixType& A);
+		template <typename MatrixType>
+		multigrid_preconditioner& compute(const MatrixType& A) {return this->factorize(A);}
+		Eigen::VectorXd solve(const Eigen::VectorXd& b) const;
+		Eigen::ComputationInfo info() const {return mInfo;}
+		
+		unsigned int getLevelCount() const {return mOperators.size();}
+		unsigned long getLevelSize(const unsigned int& level) const {return mOperators.at(level).rows();}
+		unsigned long getMemoryUsage() const;
+	};
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/multigrid_preconditioner.cpp>
+
+#endif // SD_MULTIGRID_PRECONDITIONER_HPP
@@ -0,0 +1,51 @@
+#ifndef SD_REUSABLE_SOLVER_CPP
+#define SD_REUSABLE_SOLVER_CPP
+
+#include <algorithm>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	template <class SOLVER>
+	reusable_solver<SOLVER>::reusable_solver()
+	{
+		
+	} // ctor
+	
+	template <class SOLVER>
+	reusable_solver<SOLVER>::~reusable_solver()
+	{
+		
+	} // dtor
+	
+	template <class SOLVER>
+	template <class MATRIX>
+	bool reusable_solver<SOLVER>::update(const MATRIX& A, const double& degradation)
+	{ // sets the matrix to solve for, returns true if the preconditioner has been recomputed for it
+		if (!mPreconditionerComputed || degradation <= 0 || A.rows() != this->rows() ||
+				mLastIterations > degradation * std::max(mReferenceIterations,(unsigned long)1))
+		{
+			this->compute(A);
+			mPreconditionerComputed = (this->info() == Eigen::Success);
+			mPreconditionerFresh = true;
+			mReferenceIterations = 0;
+			mLastIterations = 0;
+			return true;
+		}
+		this->grab(A); // only replaces the matrix, the preconditioner remains as it is
+		mPreconditionerFresh = false;
+		mLastIterations = 0;
+		return false;
+	} // update()
+	
+	template <class SOLVER>
+	void reusable_solver<SOLVER>::addIterations(const unsigned long& iterations)
+	{ // adds the iterations of a solve, the most iterations of all solves since update() are kept
+		if (mPreconditionerFresh) mReferenceIterations = std::max(mReferenceIterations,iterations);
+		mLastIterations = std::max(mLastIterations,iterations);
+	} // addIterations()
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_REUSABLE_SOLVER_CPP
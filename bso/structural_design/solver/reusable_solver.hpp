@@ -0,0 +1,36 @@
+#ifndef SD_REUSABLE_SOLVER_HPP
+#define SD_REUSABLE_SOLVER_HPP
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	/*
+	 * Eigen iterative solver of which the preconditioner can be kept while the matrix changes.
+	 * The preconditioner is recomputed when the iterations of a solve grow beyond a factor
+	 * (the degradation) of the iterations of the solves right after it was computed.
+	 */
+	
+	template <class SOLVER>
+	class reusable_solver : public SOLVER
+	{
+	private:
+		bool mPreconditionerComputed = false;
+		bool mPreconditionerFresh = false; // the preconditioner has been computed at the last update
+		unsigned long mReferenceIterations = 0; // most iterations of the solves after the preconditioner was computed
+		unsigned long mLastIterations = 0; // most iterations of the solves after the last update
+	public:
+		reusable_solver();
+		~reusable_solver();
+		
+		template <class MATRIX>
+		bool update(const MATRIX& A, const double& degradation);
+		void addIterations(const unsigned long& iterations);
+		void invalidate() {mPreconditionerComputed = false;}
+	};
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/reusable_solver.cpp>
+
+#endif // SD_REUSABLE_SOLVER_HPP
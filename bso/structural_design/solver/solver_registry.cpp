@@ -0,0 +1,259 @@
+#ifndef SD_SOLVER_REGISTRY_CPP
+#define SD_SOLVER_REGISTRY_CPP
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+namespace bso { namespace structural_design { namespace solver {
+
+	unsigned long system_properties::getFactorFill()
+	{
+		if (factorFill == 0 && estimateFill) factorFill = estimateFill();
+		return factorFill;
+	} // getFactorFill()
+
+	solver_registry& solver_registry::instance()
+	{
+		static solver_registry registry;
+		return registry;
+	} // instance()
+
+	const std::vector<std::string>& solver_registry::getBuiltInSolvers()
+	{
+		static const std::vector<std::string> solvers = {"SimplicialLLT", "SimplicialLDLT", "DenseLDLT",
+			"MixedLDLT", "LowRankLDLT", "BiCGSTAB", "scaledBiCGSTAB", "PCG", "PCG-AMG", "PCG-GMG", "EbE-PCG",
+			"Block-PCG"};
+		return solvers;
+	} // getBuiltInSolvers()
+
+	unsigned long solver_registry::queryAvailableMemory()
+	{
+#if defined(__unix__) && defined(_SC_AVPHYS_PAGES)
+		long pages = sysconf(_SC_AVPHYS_PAGES);
+		long pageSize = sysconf(_SC_PAGESIZE);
+		if (pages > 0 && pageSize > 0) return (unsigned long)pages*(unsigned long)pageSize;
+#endif
+		return 0;
+	} // queryAvailableMemory()
+
+	solver_registry::solver_registry()
+	{
+		this->addDefaultRules();
+	} // ctor
+
+	solver_registry::~solver_registry()
+	{
+
+	} // dtor
+
+	void solver_registry::addDefaultRules()
+	{ // added from the lowest to the highest priority
+		mRules.push_back({"sparse", [](system_properties& p, std::string& reason)
+		{
+			reason = "the sparse factor fits in memory";
+			return std::string("SimplicialLDLT");
+		}});
+		mRules.push_back({"memory", [this](system_properties& p, std::string& reason)
+		{ // a value and an index per nonzero of the factor
+			double fraction;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				fraction = mLimits.memoryFraction;
+			}
+			if (p.availableMemory == 0) return std::string();
+			double bytes = (double)p.getFactorFill()*(sizeof(double) + sizeof(int));
+			if (bytes <= fraction*p.availableMemory) return std::string();
+			std::stringstream s;
+			s << "the sparse factor takes " << bytes << " bytes, more than " << fraction << " of the available memory";
+			reason = s.str();
+			return std::string("PCG");
+		}});
+		mRules.push_back({"size", [this](system_properties& p, std::string& reason)
+		{
+			selection_limits limits = this->getLimits();
+			std::stringstream s;
+			if (p.DOFCount <= limits.denseDOFs)
+			{
+				s << "at most " << limits.denseDOFs << " DOFs";
+				reason = s.str();
+				return std::string("DenseLDLT");
+			}
+			if (p.DOFCount >= limits.largeDOFs)
+			{
+				s << "at least " << limits.largeDOFs << " DOFs";
+				reason = s.str();
+				return std::string("PCG");
+			}
+			if (p.dimensions == 3 && p.DOFCount >= limits.large3DDOFs)
+			{ // the fill of a sparse factor grows faster in 3D than in 2D
+				s << "a 3D system of at least " << limits.large3DDOFs << " DOFs";
+				reason = s.str();
+				return std::string("PCG");
+			}
+			return std::string();
+		}});
+		mRules.push_back({"assembly", [](system_properties& p, std::string& reason)
+		{ // without an assembled GSM only the solvers of the element or block products remain
+			if (p.assemblyMode != "matrix-free" && p.assemblyMode != "blocks") return std::string();
+			reason = "assembly mode " + p.assemblyMode;
+			return std::string((p.assemblyMode == "blocks") ? "Block-PCG" : "EbE-PCG");
+		}});
+	} // addDefaultRules()
+
+	void solver_registry::registerSolver(const std::string& name, back_end solve)
+	{
+		const auto& builtIn = getBuiltInSolvers();
+		if (name.empty() || name == "auto" || !solve ||
+				std::find(builtIn.begin(),builtIn.end(),name) != builtIn.end())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot register a solver with name: \"" << name << "\",\n"
+									 << "it is empty, \"auto\", built in, or has no back-end\n"
+									 << "(bso/structural_design/solver/solver_registry.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		std::lock_guard<std::mutex> lock(mMutex);
+		mBackEnds[name] = solve;
+	} // registerSolver()
+
+	void solver_registry::unregisterSolver(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mBackEnds.erase(name);
+	} // unregisterSolver()
+
+	bool solver_registry::isRegistered(const std::string& name) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mBackEnds.find(name) != mBackEnds.end();
+	} // isRegistered()
+
+	bool solver_registry::isKnown(const std::string& name) const
+	{
+		const auto& builtIn = getBuiltInSolvers();
+		return std::find(builtIn.begin(),builtIn.end(),name) != builtIn.end() || this->isRegistered(name);
+	} // isKnown()
+
+	solver_registry::back_end solver_registry::getBackEnd(const std::string& name) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto search = mBackEnds.find(name);
+		if (search == mBackEnds.end())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, no solver back-end is registered with name: " << name << "\n"
+									 << "(bso/structural_design/solver/solver_registry.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		return search->second;
+	} // getBackEnd()
+
+	void solver_registry::addRule(const std::string& name, selection_rule rule)
+	{
+		if (name.empty() || !rule)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot add a solver selection rule without a name or a function\n"
+									 << "(bso/structural_design/solver/solver_registry.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRules.erase(std::remove_if(mRules.begin(),mRules.end(),
+			[&](const auto& r){return r.first == name;}),mRules.end());
+		mRules.push_back({name,rule});
+	} // addRule()
+
+	void solver_registry::removeRule(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRules.erase(std::remove_if(mRules.begin(),mRules.end(),
+			[&](const auto& r){return r.first == name;}),mRules.end());
+	} // removeRule()
+
+	std::vector<std::string> solver_registry::getRules() const
+	{ // in the order they are evaluated
+		std::lock_guard<std::mutex> lock(mMutex);
+		std::vector<std::string> names;
+		for (auto it = mRules.rbegin(); it != mRules.rend(); ++it) names.push_back(it->first);
+		return names;
+	} // getRules()
+
+	void solver_registry::setLimits(const selection_limits& limits)
+	{
+		if (!(limits.memoryFraction > 0) || limits.largeDOFs <= limits.denseDOFs ||
+				limits.large3DDOFs <= limits.denseDOFs)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, invalid solver selection limits, the memory fraction must be positive,\n"
+									 << "and the large systems must be larger than the dense ones\n"
+									 << "(bso/structural_design/solver/solver_registry.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		std::lock_guard<std::mutex> lock(mMutex);
+		mLimits = limits;
+	} // setLimits()
+
+	solver_registry::selection_limits solver_registry::getLimits() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mLimits;
+	} // getLimits()
+
+	void solver_registry::setLog(std::ostream* log)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mLog = log;
+	} // setLog()
+
+	solver_selection solver_registry::select(system_properties properties) const
+	{ // the rules are copied, so that they may use the registry themselves
+		std::vector<std::pair<std::string, selection_rule> > rules;
+		std::ostream* log;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			rules = mRules;
+			log = mLog;
+			if (properties.availableMemory == 0) properties.availableMemory = mLimits.availableMemory;
+		}
+		if (properties.availableMemory == 0) properties.availableMemory = queryAvailableMemory();
+
+		solver_selection selection;
+		for (auto it = rules.rbegin(); it != rules.rend() && selection.solver.empty(); ++it)
+		{
+			selection.solver = it->second(properties,selection.reason);
+			selection.rule = it->first;
+		}
+		if (selection.solver.empty() || !this->isKnown(selection.solver))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, the solver selection rules chose an unknown solver: \""
+									 << selection.solver << "\" (rule: " << selection.rule << ")\n"
+									 << "(bso/structural_design/solver/solver_registry.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		properties.estimateFill = nullptr; // it refers to the system that is solved
+		selection.properties = properties;
+
+		if (log != nullptr)
+		{
+			*log << "solver selection: " << selection.solver << " by rule " << selection.rule
+					 << " (" << selection.reason << "), DOFs: " << properties.DOFCount
+					 << ", nonzeros: " << properties.nonZeros << ", dimensions: " << properties.dimensions
+					 << ", assembly mode: " << properties.assemblyMode << ", condensed: " << properties.condensed
+					 << ", available memory: " << properties.availableMemory;
+			if (properties.factorFill > 0) *log << ", factor nonzeros: " << properties.factorFill;
+			*log << std::endl;
+		}
+		return selection;
+	} // select()
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_SOLVER_REGISTRY_CPP
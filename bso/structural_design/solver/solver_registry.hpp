@@ -0,0 +1,104 @@
+#ifndef SD_SOLVER_REGISTRY_HPP
+#define SD_SOLVER_REGISTRY_HPP
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	/*
+	 * The solvers of fea, and the rules by which fea::solve("auto") picks one of them. Besides the
+	 * solvers that are built into fea, back-ends can be registered by name, these solve the GSM for
+	 * the loads and are then available to fea::solve() like the built-in solvers. The rules are
+	 * evaluated from the last registered to the first, the first that names a solver decides. The
+	 * default rules choose dense LDLT for tiny systems, PCG for very large ones, large 3D ones, and
+	 * ones of which the sparse factor would not fit in memory, and sparse LDLT otherwise.
+	 */
+
+	struct system_properties
+	{
+		unsigned long DOFCount = 0;
+		unsigned long nonZeros = 0; // of the GSM, 0 if it is not assembled
+		unsigned int dimensions = 0; // number of axes along which the nodes are spread
+		std::string assemblyMode;
+		bool condensed = false;
+		unsigned long availableMemory = 0; // bytes, 0 if unknown
+		std::function<unsigned long()> estimateFill; // nonzeros of the sparse factor, its ordering is reused by fea
+		unsigned long factorFill = 0; // set once a rule calls getFactorFill()
+
+		unsigned long getFactorFill();
+	};
+
+	struct solver_selection
+	{
+		std::string solver;
+		std::string rule;
+		std::string reason;
+		system_properties properties;
+	};
+
+	class solver_registry
+	{
+	public:
+		typedef std::function<void(const Eigen::SparseMatrix<double>& GSM, const Eigen::MatrixXd& loads,
+			Eigen::MatrixXd& displacements)> back_end;
+		typedef std::function<std::string(system_properties& properties, std::string& reason)> selection_rule; // returns an empty name to pass
+		struct selection_limits
+		{
+			unsigned long denseDOFs = 300; // up to which a system is solved with dense LDLT
+			unsigned long largeDOFs = 500000; // from which a system is solved with PCG
+			unsigned long large3DDOFs = 100000; // from which a 3D system is solved with PCG
+			double memoryFraction = 0.5; // of the available memory that the sparse factor may use
+			unsigned long availableMemory = 0; // bytes, 0 to query the system
+		};
+
+		struct registration
+		{ // registers a back-end on construction, e.g. as a static object in the file that defines it
+			registration(const std::string& name, back_end solve) {instance().registerSolver(name,solve);}
+		};
+	private:
+		std::map<std::string, back_end> mBackEnds;
+		std::vector<std::pair<std::string, selection_rule> > mRules;
+		selection_limits mLimits;
+		std::ostream* mLog = nullptr;
+		mutable std::mutex mMutex;
+
+		void addDefaultRules();
+	public:
+		static solver_registry& instance();
+		static const std::vector<std::string>& getBuiltInSolvers(); // solvers that fea implements itself
+		static unsigned long queryAvailableMemory(); // bytes, 0 if unknown
+
+		solver_registry();
+		~solver_registry();
+
+		void registerSolver(const std::string& name, back_end solve);
+		void unregisterSolver(const std::string& name);
+		bool isRegistered(const std::string& name) const;
+		bool isKnown(const std::string& name) const; // built in or registered
+		back_end getBackEnd(const std::string& name) const;
+
+		void addRule(const std::string& name, selection_rule rule); // replaces the rule with the same name
+		void removeRule(const std::string& name);
+		std::vector<std::string> getRules() const;
+		void setLimits(const selection_limits& limits);
+		selection_limits getLimits() const;
+		void setLog(std::ostream* log); // nullptr to stop logging
+
+		solver_selection select(system_properties properties) const;
+	};
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/solver_registry.cpp>
+
+#endif // SD_SOLVER_REGISTRY_HPP
@@ -0,0 +1,248 @@
+#ifndef SD_STATIC_CONDENSATION_CPP
+#define SD_STATIC_CONDENSATION_CPP
+
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	static_condensation::terms_cache& static_condensation::cache()
+	{ // the terms of the groups that were condensed last are retained, so that the next model
+		// reuses those of the components it has in common with the previous one
+		terms_cache& c = terms_cache::instance();
+		static const bool retained = (c.setRetainedCount(64), true);
+		(void)retained;
+		return c;
+	} // cache()
+
+	static_condensation::static_condensation()
+	{
+
+	} // ctor
+
+	static_condensation::~static_condensation()
+	{
+
+	} // dtor
+
+	void static_condensation::initialize(const std::vector<std::vector<unsigned long> >& groups,
+		const std::vector<element::element*>& elements, const unsigned long& DOFCount)
+	{ // determines the interior DOFs of each group, groups without interior DOFs are not condensed
+		this->clear();
+		std::vector<long> elementGroup(elements.size(),-1);
+		for (unsigned long i = 0; i < groups.size(); ++i)
+		{
+			for (const auto& j : groups[i])
+			{
+				if (j >= elements.size() || (elementGroup[j] >= 0 && elementGroup[j] != (long)i))
+				{
+					std::stringstream errorMessage;
+					errorMessage << "\nError, cannot condense element " << j << " of an FEA system with\n"
+											 << elements.size() << " elements, it does not exist or is in more than one group\n"
+											 << "(bso/structural_design/solver/static_condensation.cpp)" << std::endl;
+					throw std::invalid_argument(errorMessage.str());
+				}
+				elementGroup[j] = i;
+			}
+		}
+
+		// the group that owns each DOF: -3 if no element couples it, -2 if it is shared
+		std::vector<long> owner(DOFCount,-3);
+		for (unsigned long i = 0; i < elements.size(); ++i)
+		{
+			long g = (elementGroup[i] >= 0) ? elementGroup[i] : -2;
+			for (const auto& j : elements[i]->getEFT())
+			{
+				long& o = owner[j.second];
+				if (o == -3) o = g;
+				else if (o != g) o = -2;
+			}
+		}
+
+		mCondensedElements.assign(elements.size(),false);
+		std::vector<long> localIndex(DOFCount,-1);
+		for (unsigned long i = 0; i < groups.size(); ++i)
+		{
+			group g;
+			g.elements = groups[i];
+			for (const auto& j : g.elements)
+			{
+				for (const auto& k : elements[j]->getEFT())
+				{
+					if (localIndex[k.second] >= 0) continue;
+					localIndex[k.second] = 0;
+					if (owner[k.second] == (long)i) g.interiorDOFs.push_back(k.second);
+					else g.boundaryDOFs.push_back(k.second);
+				}
+			}
+			unsigned long nb = g.boundaryDOFs.size();
+			for (unsigned long j = 0; j < nb; ++j) localIndex[g.boundaryDOFs[j]] = j;
+			for (unsigned long j = 0; j < g.interiorDOFs.size(); ++j) localIndex[g.interiorDOFs[j]] = nb + j;
+			for (const auto& j : g.elements)
+			{
+				g.localEFTs.emplace_back();
+				for (const auto& k : elements[j]->getEFT()) g.localEFTs.back().push_back({k.first,(unsigned int)localIndex[k.second]});
+			}
+			for (const auto& j : g.boundaryDOFs) localIndex[j] = -1;
+			for (const auto& j : g.interiorDOFs) localIndex[j] = -1;
+
+			if (g.interiorDOFs.empty()) continue;
+			for (const auto& j : g.elements) mCondensedElements[j] = true;
+			mGroups.push_back(std::move(g));
+		}
+		if (mGroups.empty())
+		{
+			this->clear();
+			return;
+		}
+
+		mCondensedIndex.assign(DOFCount,-1);
+		for (unsigned long i = 0; i < DOFCount; ++i)
+		{ // the interior DOFs of the condensed groups are not in the condensed system
+			if (owner[i] >= 0 && mCondensedElements[groups[owner[i]][0]]) continue;
+			mCondensedIndex[i] = mCondensedDOFs.size();
+			mCondensedDOFs.push_back(i);
+		}
+	} // initialize()
+
+	void static_condensation::clear()
+	{
+		mGroups.clear();
+		mCondensedElements.clear();
+		mCondensedIndex.clear();
+		mCondensedDOFs.clear();
+	} // clear()
+
+	void static_condensation::condenseGroup(const unsigned long& index, const std::vector<element::element*>& elements)
+	{ // the groups are independent of each other, so they can be condensed in parallel
+		group& g = mGroups[index];
+		unsigned long nb = g.boundaryDOFs.size();
+		unsigned long ni = g.interiorDOFs.size();
+		Eigen::MatrixXd K = Eigen::MatrixXd::Zero(nb+ni,nb+ni);
+		for (unsigned long i = 0; i < g.elements.size(); ++i)
+		{
+			const element::element* e = elements[g.elements[i]];
+			const Eigen::MatrixXd& SM = e->getOriginalSM();
+			double factor = e->getStiffnessFactor();
+			for (const auto& j : g.localEFTs[i])
+			{
+				for (const auto& k : g.localEFTs[i]) K(j.second,k.second) += factor*SM(j.first,k.first);
+			}
+		}
+
+		terms_cache::key k;
+		k.reserve(2 + (nb+ni)*(nb+ni+1)/2);
+		terms_cache::addParameter(k,nb);
+		terms_cache::addParameter(k,ni);
+		for (unsigned long j = 0; j < nb+ni; ++j)
+		{
+			for (unsigned long i = j; i < nb+ni; ++i) terms_cache::addParameter(k,K(i,j));
+		}
+		g.terms = cache().find(k,[&]()
+		{
+			auto terms = std::make_shared<condensed_terms>();
+			terms->interiorFactor.compute(K.bottomRightCorner(ni,ni));
+			if (terms->interiorFactor.info() != Eigen::Success || !terms->interiorFactor.isPositive())
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nError, could not condense a group of " << g.elements.size() << " elements,\n"
+										 << "the stiffness matrix of its interior DOFs is singular\n"
+										 << "(bso/structural_design/solver/static_condensation.cpp)" << std::endl;
+				throw std::runtime_error(errorMessage.str());
+			}
+			terms->recovery = terms->interiorFactor.solve(K.bottomLeftCorner(ni,nb));
+			Eigen::MatrixXd boundarySM = K.topLeftCorner(nb,nb) - K.topRightCorner(nb,ni)*terms->recovery;
+			terms->boundarySM = 0.5*(boundarySM + boundarySM.transpose());
+			return std::shared_ptr<const condensed_terms>(terms);
+		});
+	} // condenseGroup()
+
+	Eigen::SparseMatrix<double> static_condensation::assemble(const std::vector<element::element*>& elements) const
+	{ // the SMs of the elements that are not condensed, and the condensed SMs of the groups
+		std::vector<element::triplet> triplets;
+		for (unsigned long i = 0; i < elements.size(); ++i)
+		{
+			if (mCondensedElements[i]) continue;
+			for (const auto& j : elements[i]->getSMTriplets())
+			{
+				triplets.push_back(element::triplet(mCondensedIndex[j.row()],mCondensedIndex[j.col()],j.value()));
+			}
+		}
+		for (const auto& g : mGroups)
+		{
+			const Eigen::MatrixXd& S = g.terms->boundarySM;
+			for (unsigned long j = 0; j < g.boundaryDOFs.size(); ++j)
+			{
+				for (unsigned long i = 0; i < g.boundaryDOFs.size(); ++i)
+				{
+					if (S(i,j) == 0) continue;
+					triplets.push_back(element::triplet(mCondensedIndex[g.boundaryDOFs[i]],
+						mCondensedIndex[g.boundaryDOFs[j]],S(i,j)));
+				}
+			}
+		}
+		Eigen::SparseMatrix<double> GSM(mCondensedDOFs.size(),mCondensedDOFs.size());
+		GSM.setFromTriplets(triplets.begin(),triplets.end());
+		return GSM;
+	} // assemble()
+
+	Eigen::MatrixXd static_condensation::condenseLoads(const Eigen::MatrixXd& F) const
+	{ // the interior loads of each group are moved to its boundary: F_b - K_bi*K_ii^-1*F_i
+		Eigen::MatrixXd condensedF = this->restrict(F);
+		for (const auto& g : mGroups)
+		{
+			Eigen::MatrixXd interiorF(g.interiorDOFs.size(),F.cols());
+			for (unsigned long i = 0; i < g.interiorDOFs.size(); ++i) interiorF.row(i) = F.row(g.interiorDOFs[i]);
+			Eigen::MatrixXd boundaryF = g.terms->recovery.transpose()*interiorF;
+			for (unsigned long i = 0; i < g.boundaryDOFs.size(); ++i)
+			{
+				condensedF.row(mCondensedIndex[g.boundaryDOFs[i]]) -= boundaryF.row(i);
+			}
+		}
+		return condensedF;
+	} // condenseLoads()
+
+	Eigen::MatrixXd static_condensation::restrict(const Eigen::MatrixXd& U) const
+	{ // the rows of the DOFs that are in the condensed system
+		Eigen::MatrixXd condensedU(mCondensedDOFs.size(),U.cols());
+		for (unsigned long i = 0; i < mCondensedDOFs.size(); ++i) condensedU.row(i) = U.row(mCondensedDOFs[i]);
+		return condensedU;
+	} // restrict()
+
+	Eigen::MatrixXd static_condensation::recover(const Eigen::MatrixXd& condensedU, const Eigen::MatrixXd& F) const
+	{ // the interior displacements of each group: K_ii^-1*F_i - K_ii^-1*K_ib*U_b
+		Eigen::MatrixXd U = Eigen::MatrixXd::Zero(mCondensedIndex.size(),condensedU.cols());
+		for (unsigned long i = 0; i < mCondensedDOFs.size(); ++i) U.row(mCondensedDOFs[i]) = condensedU.row(i);
+		for (const auto& g : mGroups)
+		{
+			Eigen::MatrixXd boundaryU(g.boundaryDOFs.size(),U.cols());
+			for (unsigned long i = 0; i < g.boundaryDOFs.size(); ++i) boundaryU.row(i) = U.row(g.boundaryDOFs[i]);
+			Eigen::MatrixXd interiorF(g.interiorDOFs.size(),F.cols());
+			for (unsigned long i = 0; i < g.interiorDOFs.size(); ++i) interiorF.row(i) = F.row(g.interiorDOFs[i]);
+			Eigen::MatrixXd interiorU = g.terms->interiorFactor.solve(interiorF) - g.terms->recovery*boundaryU;
+			for (unsigned long i = 0; i < g.interiorDOFs.size(); ++i) U.row(g.interiorDOFs[i]) = interiorU.row(i);
+		}
+		return U;
+	} // recover()
+
+	unsigned long static_condensation::getMemoryUsage() const
+	{ // the terms shared by congruent groups are counted once
+		unsigned long bytes = mCondensedIndex.size()*sizeof(long) + mCondensedDOFs.size()*sizeof(unsigned long);
+		std::unordered_set<const condensed_terms*> terms;
+		for (const auto& g : mGroups)
+		{
+			bytes += (g.elements.size() + g.boundaryDOFs.size() + g.interiorDOFs.size())*sizeof(unsigned long);
+			for (const auto& i : g.localEFTs) bytes += i.size()*sizeof(i[0]);
+			if (!g.terms || !terms.insert(g.terms.get()).second) continue;
+			bytes += (g.terms->boundarySM.size() + g.terms->recovery.size() +
+				g.terms->interiorFactor.matrixLDLT().size())*sizeof(double);
+		}
+		return bytes;
+	} // getMemoryUsage()
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_STATIC_CONDENSATION_CPP
@@ -0,0 +1,77 @@
+#ifndef SD_STATIC_CONDENSATION_HPP
+#define SD_STATIC_CONDENSATION_HPP
+
+#include <bso/structural_design/element/element.hpp>
+#include <bso/structural_design/element/stiffness_cache.hpp>
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <memory>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	/*
+	 * Static (Guyan) condensation of groups of elements into superelements. The DOFs that are only
+	 * coupled by the elements of a single group are interior to that group, and are eliminated per
+	 * group: with b its boundary and i its interior DOFs, the group adds K_bb - K_bi*K_ii^-1*K_ib to
+	 * the condensed GSM. Once the condensed system is solved, the interior displacements are recovered
+	 * per group. The condensed terms of a group are content addressed by the stiffness matrices of
+	 * its elements, so congruent groups share them, also between models analyzed one after another.
+	 */
+
+	class static_condensation
+	{
+	public:
+		struct condensed_terms
+		{
+			Eigen::MatrixXd boundarySM; // K_bb - K_bi*K_ii^-1*K_ib
+			Eigen::MatrixXd recovery; // K_ii^-1*K_ib
+			Eigen::LDLT<Eigen::MatrixXd> interiorFactor; // factorization of K_ii
+		};
+		typedef element::stiffness_cache<condensed_terms> terms_cache;
+	private:
+		struct group
+		{
+			std::vector<unsigned long> elements;
+			std::vector<unsigned long> boundaryDOFs; // global DOFs, local DOFs 0 to nb-1
+			std::vector<unsigned long> interiorDOFs; // global DOFs, local DOFs nb to nb+ni-1
+			std::vector<std::vector<std::pair<unsigned int, unsigned int> > > localEFTs; // per element: DOF in its SM and local DOF
+			std::shared_ptr<const condensed_terms> terms;
+		};
+		std::vector<group> mGroups;
+		std::vector<bool> mCondensedElements; // per element, whether it is part of a group
+		std::vector<long> mCondensedIndex; // per global DOF, its DOF in the condensed system, -1 if it is interior
+		std::vector<unsigned long> mCondensedDOFs; // per DOF of the condensed system, its global DOF
+	public:
+		static terms_cache& cache();
+
+		static_condensation();
+		~static_condensation();
+
+		void initialize(const std::vector<std::vector<unsigned long> >& groups,
+			const std::vector<element::element*>& elements, const unsigned long& DOFCount);
+		void clear();
+		void condenseGroup(const unsigned long& index, const std::vector<element::element*>& elements);
+		Eigen::SparseMatrix<double> assemble(const std::vector<element::element*>& elements) const;
+
+		Eigen::MatrixXd condenseLoads(const Eigen::MatrixXd& F) const;
+		Eigen::MatrixXd restrict(const Eigen::MatrixXd& U) const;
+		Eigen::MatrixXd recover(const Eigen::MatrixXd& condensedU, const Eigen::MatrixXd& F) const;
+
+		bool isActive() const {return !mCondensedIndex.empty();}
+		unsigned long getGroupCount() const {return mGroups.size();}
+		const std::vector<unsigned long>& getCondensedDOFs() const {return mCondensedDOFs;}
+		const std::vector<long>& getCondensedIndex() const {return mCondensedIndex;}
+		unsigned long getCondensedDOFCount() const {return mCondensedDOFs.size();}
+		unsigned long getMemoryUsage() const;
+	};
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/static_condensation.cpp>
+
+#endif // SD_STATIC_CONDENSATION_HPP
@@ -91,17 +91,12 @@ void sd_model::topologyOptimization<topology_optimization::SIMP>(const double& f
 
 			// FEA
 			mFEA->generateGSM();
-			mFEA->solve("SimplicialLDLT");
+			mFEA->solve(mTopOptSolver,mTopOptWarmStart);
 
 			// objective function and sensitivity analysis (retrieve data from FEA)
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				c 						+= i->getTotalEnergy();
-				dc(eleIndexI) =  i->getEnergySensitivity(penal); 
-				dv(eleIndexI) =  i->getVolume();
-				++eleIndexI;
-			}
+			c = mFEA->getTotalEnergies().sum();
+			dc = mFEA->getEnergySensitivities(penal);
+			dv = mFEA->getVolumes();
 
 			dc = (dc * x.transpose()).diagonal();
 			dc = H * dc;
@@ -136,12 +131,7 @@ void sd_model::topologyOptimization<topology_optimization::SIMP>(const double& f
 				((volume * xNew.transpose()).trace() > f * totVolume) ? l1 = lmid : l2 = lmid;
 			}
 		
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				i->updateDensity(xNew(eleIndexI), penal);
-				++eleIndexI;
-			}
+			mFEA->updateDensities(xNew, penal);
 
 			// update change
 			xChange = xNew - x;
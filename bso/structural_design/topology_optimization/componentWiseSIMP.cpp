@@ -121,7 +121,7 @@ void sd_model::topologyOptimization<topology_optimization::COMP_SIMP>(
 
 		// FEA
 		mFEA->generateGSM();
-		mFEA->solve("SimplicialLDLT");
+		mFEA->solve(mTopOptSolver,mTopOptWarmStart);
 
 		double volume = 0;
 		if (fComp.size() > 0)
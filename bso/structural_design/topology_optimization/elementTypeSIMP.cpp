@@ -103,7 +103,7 @@ void sd_model::topologyOptimization<topology_optimization::ELE_SIMP>(const doubl
 
 			// FEA
 			mFEA->generateGSM();
-			mFEA->solve("SimplicialLDLT");
+			mFEA->solve(mTopOptSolver,mTopOptWarmStart);
 
 			double volume = 0;
 			if (fEle.size() > 0)
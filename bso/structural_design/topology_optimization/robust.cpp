@@ -113,17 +113,12 @@ void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double&
 
 			// FEA
 			mFEA->generateGSM();
-			mFEA->solve("SimplicialLDLT");
+			mFEA->solve(mTopOptSolver,mTopOptWarmStart);
 
 			// objective function and sensitivity analysis (retrieve data from FEA)
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				c 						+= i->getTotalEnergy();
-				dc(eleIndexI) =  i->getEnergySensitivity(penal); 
-				dv(eleIndexI) =  i->getVolume();
-				++eleIndexI;
-			}
+			c = mFEA->getTotalEnergies().sum();
+			dc = mFEA->getEnergySensitivities(penal);
+			dv = mFEA->getVolumes();
 			
 			eleIndexI = 0;
 			for (auto& i : mFEA->getElements())
@@ -174,12 +169,7 @@ void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double&
 				((volume * xn.transpose()).trace() > f * totVolume) ? l1 = lmid : l2 = lmid;
 			}
 		
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				i->updateDensity(xe(eleIndexI), penal);
-				++eleIndexI;
-			}
+			mFEA->updateDensities(xe, penal);
 			
 			// update change
 			xChange = xNew - x;
@@ -225,12 +215,7 @@ void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double&
 			<< (timeEnd - loopStart)/CLOCKS_PER_SEC << " seconds."
 			<< std::endl << std::endl;
 	
-	eleIndexI = 0;
-	for (auto& i : mFEA->getElements())
-	{
-		i->updateDensity(xn(eleIndexI), penal);
-		++eleIndexI;
-	}
+	mFEA->updateDensities(xn, penal);
 }
 	
 } // namespace structural_design
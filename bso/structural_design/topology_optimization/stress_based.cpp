@@ -136,13 +136,12 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 			ae.setZero(freeDOFs,numEle); // adjoint load vectors for stress sensitivity calculation
 
 			// objective function and sensitivity analysis (retrieve data from FEA)
+			c += mFEA->getTotalEnergies().sum();
+			dv = mFEA->getVolumes() / totVolume;
+			s = mFEA->getStresses(alpha, beta); // gives Drucker-Prager stress for unequal strength limits, and Von Mises stress for equal strength limits
 			eleIndexI = 0;
 			for (auto& i : mFEA->getElements())
 			{
-				c 						+= i->getTotalEnergy();
-				dv(eleIndexI) =  i->getVolume();
-				dv(eleIndexI) /= totVolume;
-				s(eleIndexI)  =  i->getStressAtCenter(alpha, beta); // gives Drucker-Prager stress for unequal strength limits, and Von Mises stress for equal strength limits
 				s(eleIndexI) +=  eps - 1 - eps / xPhys(eleIndexI); // relaxed stress, should be < 0
 				ae.col(eleIndexI) = i->getStressSensitivityTermAE(freeDOFs, alpha); // adjoint load vectors are required for the stress sensitivity calculation
 				++eleIndexI;
@@ -194,12 +193,7 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 				xPhys(i) /= Hs(i);
 			}
 
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				i->updateDensity(xPhys(eleIndexI), penal, "regularSIMP");
-				++eleIndexI;
-			}
+			mFEA->updateDensities(xPhys, penal, "regularSIMP");
 
 			timeEnd = clock();
 			out << std::setw(5)  << std::left << loop
@@ -0,0 +1,54 @@
+#ifndef ARENA_CPP
+#define ARENA_CPP
+
+#include <new>
+#include <type_traits>
+
+namespace bso { namespace utilities {
+
+	arena::arena(const std::size_t& initialBlockSize /*= 1 << 16*/) : mResource(initialBlockSize)
+	{
+
+	} // ctor
+
+	arena::~arena()
+	{
+		this->release();
+	} // dtor
+
+	template <class T, class...ARGS>
+	T* arena::create(ARGS&&... args)
+	{
+		void* memory;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			memory = mResource.allocate(sizeof(T), alignof(T));
+			mBytes += sizeof(T);
+		}
+
+		// construct outside of the lock, if this throws, the memory is only reclaimed by release()
+		T* object = new (memory) T(std::forward<ARGS>(args)...);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		++mObjectCount;
+		if (!std::is_trivially_destructible<T>::value)
+		{
+			mObjects.push_back({object, [](void* p){static_cast<T*>(p)->~T();}});
+		}
+		return object;
+	} // create()
+
+	void arena::release()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (auto i = mObjects.rbegin(); i != mObjects.rend(); ++i) i->second(i->first);
+		mObjects.clear();
+		mResource.release();
+		mObjectCount = 0;
+		mBytes = 0;
+	} // release()
+
+} // namespace utilities
+} // namespace bso
+
+#endif // ARENA_CPP
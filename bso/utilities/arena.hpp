@@ -0,0 +1,46 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace bso { namespace utilities {
+
+	/*
+	 * Monotonic storage for objects that are all destroyed at the same time, e.g. the points, nodes
+	 * and elements of a mesh. Objects are placed contiguously in large blocks and are never freed
+	 * individually, release() destroys all of them, in reverse order of creation, and frees the
+	 * blocks in one call. Objects may be created from several threads at once.
+	 */
+
+	class arena
+	{
+	private:
+		std::pmr::monotonic_buffer_resource mResource;
+		std::vector<std::pair<void*, void(*)(void*)> > mObjects; // objects that need to be destructed, in order of creation
+		std::mutex mMutex;
+		unsigned long mObjectCount = 0;
+		std::size_t mBytes = 0;
+	public:
+		arena(const std::size_t& initialBlockSize = 1 << 16); // the blocks grow geometrically from this size
+		arena(const arena& rhs) = delete;
+		arena& operator = (const arena& rhs) = delete;
+		~arena();
+
+		template <class T, class...ARGS>
+		T* create(ARGS&&... args); // constructs a T in the arena, it is destroyed by release()
+		void release();
+
+		unsigned long size() const {return mObjectCount;}
+		std::size_t getMemoryUsage() const {return mBytes;} // bytes taken by the objects, excluding the unused part of the blocks
+	};
+
+} // namespace utilities
+} // namespace bso
+
+#include <bso/utilities/arena.cpp>
+
+#endif // ARENA_HPP
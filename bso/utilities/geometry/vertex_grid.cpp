@@ -0,0 +1,104 @@
+#ifndef VERTEX_GRID_CPP
+#define VERTEX_GRID_CPP
+
+#include <cmath>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace utilities { namespace geometry {
+
+	template <class T>
+	std::size_t vertex_grid<T>::cell_key_hash::operator()(const cell_key& k) const
+	{
+		std::size_t seed = 0;
+		for (const auto& i : k)
+		{ // combine the hashes of the three cell indices
+			seed ^= std::hash<long long>()(i) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+		}
+		return seed;
+	} // cell_key_hash()
+
+	template <class T>
+	long long vertex_grid<T>::quantize(const double& x) const
+	{ // cell boundaries are shifted by half a cell, so round coordinates lie in the middle of a cell
+		return (long long)std::floor(x / mCellSize + 0.5);
+	} // quantize()
+
+	template <class T>
+	vertex_grid<T>::vertex_grid(const double& tol /*= 1e-9*/)
+	{
+		if (!(tol > 0))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot initialize a vertex grid with tolerance: "
+									 << tol << ",\n"
+									 << "the tolerance must be larger than zero.\n"
+									 << "(bso/utilities/geometry/vertex_grid.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mTolerance = tol;
+		mCellSize = 64.0 * tol;
+		mProbeRadius = 2.0 * tol; // twice the tolerance, to be safe from round-off at cell boundaries
+	} // ctor
+
+	template <class T>
+	vertex_grid<T>::~vertex_grid()
+	{
+
+	} // dtor
+
+	template <class T>
+	void vertex_grid<T>::insert(T item)
+	{
+		const vertex& v = *item;
+		mCells[{quantize(v(0)), quantize(v(1)), quantize(v(2))}].push_back({mSize++, item});
+	} // insert()
+
+	template <class T>
+	T vertex_grid<T>::find(const vertex& v) const
+	{ // returns the earliest inserted item that is the same as v, or nullptr if there is none
+		long long lower[3], upper[3];
+		for (unsigned int i = 0; i < 3; ++i)
+		{ // a vertex is only near the neighbouring cells if it is within the probe radius of a cell boundary
+			lower[i] = quantize(v(i) - mProbeRadius);
+			upper[i] = quantize(v(i) + mProbeRadius);
+		}
+
+		T found = nullptr;
+		unsigned long foundIndex = 0;
+		for (long long i = lower[0]; i <= upper[0]; ++i)
+		{
+			for (long long j = lower[1]; j <= upper[1]; ++j)
+			{
+				for (long long k = lower[2]; k <= upper[2]; ++k)
+				{
+					auto cellSearch = mCells.find({i,j,k});
+					if (cellSearch == mCells.end()) continue;
+					for (const auto& l : cellSearch->second)
+					{
+						if (found != nullptr && foundIndex < l.first) continue;
+						if (l.second->isSameAs(v, mTolerance))
+						{
+							found = l.second;
+							foundIndex = l.first;
+						}
+					}
+				}
+			}
+		}
+		return found;
+	} // find()
+
+	template <class T>
+	void vertex_grid<T>::clear()
+	{
+		mCells.clear();
+		mSize = 0;
+	} // clear()
+
+} // namespace geometry
+} // namespace utilities
+} // namespace bso
+
+#endif // VERTEX_GRID_CPP
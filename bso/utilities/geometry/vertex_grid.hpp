@@ -0,0 +1,48 @@
+#ifndef VERTEX_GRID_HPP
+#define VERTEX_GRID_HPP
+
+#include <bso/utilities/geometry/vertex.hpp>
+
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bso { namespace utilities { namespace geometry {
+
+	template <class T> // T is a pointer to vertex or to a class derived from it
+	class vertex_grid
+	{ // spatial hash that finds stored vertices with vertex::isSameAs() in O(1)
+	private:
+		typedef std::array<long long,3> cell_key;
+		struct cell_key_hash
+		{
+			std::size_t operator()(const cell_key& k) const;
+		};
+
+		double mTolerance; // tolerance passed to vertex::isSameAs()
+		double mCellSize; // edge length of a grid cell, much larger than the tolerance
+		double mProbeRadius; // distance around a vertex in which cells are searched
+		unsigned long mSize = 0;
+		std::unordered_map<cell_key, std::vector<std::pair<unsigned long, T> >, cell_key_hash> mCells; // per cell: insertion index and item
+
+		long long quantize(const double& x) const;
+	public:
+		vertex_grid(const double& tol = 1e-9);
+		~vertex_grid();
+
+		void insert(T item);
+		T find(const vertex& v) const;
+		void clear();
+
+		const unsigned long& size() const {return mSize;}
+		const double& tolerance() const {return mTolerance;}
+	};
+
+} // namespace geometry
+} // namespace utilities
+} // namespace bso
+
+#include <bso/utilities/geometry/vertex_grid.cpp>
+
+#endif // VERTEX_GRID_HPP
@@ -0,0 +1,111 @@
+#ifndef THREAD_POOL_CPP
+#define THREAD_POOL_CPP
+
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace utilities {
+
+	thread_pool::thread_pool(const unsigned int& threadCount /*= 1*/)
+	{
+		if (threadCount == 0)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot initialize a thread pool without threads.\n"
+									 << "(bso/utilities/thread_pool.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		for (unsigned int i = 1; i < threadCount; ++i)
+		{
+			mWorkers.push_back(std::thread(&thread_pool::work, this, i));
+		}
+	} // ctor
+
+	thread_pool::~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mJobAvailable.notify_all();
+		for (auto& i : mWorkers) i.join();
+	} // dtor
+
+	void thread_pool::work(const unsigned int threadIndex)
+	{
+		unsigned long lastGeneration = 0;
+		while (true)
+		{
+			std::function<void(const unsigned int&)> job;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mJobAvailable.wait(lock, [&]{return mStop || mGeneration != lastGeneration;});
+				if (mStop) return;
+				lastGeneration = mGeneration;
+				job = mJob;
+			}
+			job(threadIndex);
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				--mActiveWorkers;
+			}
+			mJobFinished.notify_one();
+		}
+	} // work()
+
+	void thread_pool::run(const std::function<void(const unsigned int&)>& job)
+	{ // job should not throw and should not call run() itself, exceptions are to be caught and passed on by the job
+		if (mWorkers.empty())
+		{
+			job(0);
+			return;
+		}
+		std::lock_guard<std::mutex> runLock(mRunMutex);
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mJob = job;
+			mActiveWorkers = mWorkers.size();
+			++mGeneration;
+		}
+		mJobAvailable.notify_all();
+		job(0);
+		std::unique_lock<std::mutex> lock(mMutex);
+		mJobFinished.wait(lock, [&]{return mActiveWorkers == 0;});
+	} // run()
+
+	template <class FUNC>
+	void thread_pool::parallel_for(const unsigned long& begin, const unsigned long& end, FUNC f)
+	{ // if f throws, the exception of the lowest block is rethrown after all threads finished
+		if (end <= begin) return;
+		unsigned long rangeSize = end - begin;
+		unsigned int threadCount = this->size();
+		if (threadCount == 1 || rangeSize == 1)
+		{
+			for (unsigned long i = begin; i < end; ++i) f(i);
+			return;
+		}
+
+		std::vector<std::exception_ptr> exceptions(threadCount);
+		this->run([&](const unsigned int& threadIndex)
+		{
+			unsigned long blockBegin = begin + (rangeSize * threadIndex) / threadCount;
+			unsigned long blockEnd   = begin + (rangeSize * (threadIndex + 1)) / threadCount;
+			try
+			{
+				for (unsigned long i = blockBegin; i < blockEnd; ++i) f(i);
+			}
+			catch (...)
+			{
+				exceptions[threadIndex] = std::current_exception();
+			}
+		});
+		for (const auto& i : exceptions)
+		{
+			if (i) std::rethrow_exception(i);
+		}
+	} // parallel_for()
+
+} // namespace utilities
+} // namespace bso
+
+#endif // THREAD_POOL_CPP
@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bso { namespace utilities {
+
+	/*
+	 * A fixed set of worker threads that run loops over independent indices.
+	 * Each loop is split into contiguous, equally sized blocks, one per thread,
+	 * so the partition only depends on the loop range and the thread count.
+	 */
+
+	class thread_pool
+	{
+	private:
+		std::vector<std::thread> mWorkers;
+		std::mutex mRunMutex; // only one job runs at a time, also when the pool is shared
+		std::mutex mMutex;
+		std::condition_variable mJobAvailable;
+		std::condition_variable mJobFinished;
+		std::function<void(const unsigned int&)> mJob; // receives the index of the thread that runs it
+		unsigned long mGeneration = 0; // increases with every job, so workers can tell a new job from an old one
+		unsigned int mActiveWorkers = 0;
+		bool mStop = false;
+
+		void work(const unsigned int threadIndex);
+	public:
+		thread_pool(const unsigned int& threadCount = 1);
+		thread_pool(const thread_pool& rhs) = delete;
+		thread_pool& operator = (const thread_pool& rhs) = delete;
+		~thread_pool();
+
+		unsigned int size() const {return mWorkers.size() + 1;} // the calling thread also takes part
+		void run(const std::function<void(const unsigned int&)>& job); // runs job(threadIndex) once on every thread
+		template <class FUNC>
+		void parallel_for(const unsigned long& begin, const unsigned long& end, FUNC f); // calls f(i) for every i in [begin,end)
+	};
+
+} // namespace utilities
+} // namespace bso
+
+#include <bso/utilities/thread_pool.cpp>
+
+#endif // THREAD_POOL_HPP
@@ -5,6 +5,8 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include <unit_tests/utilities/trim_and_cast_test.cpp>
+#include <unit_tests/utilities/thread_pool_test.cpp>
+#include <unit_tests/utilities/arena_test.cpp>
 #include <unit_tests/utilities/geometry_test.cpp>
 #include <unit_tests/utilities/data_handling_test.cpp>
 #include <unit_tests/spatial_design/ms_space_test.cpp>
@@ -101,7 +101,7 @@ BOOST_AUTO_TEST_SUITE( sd_line_segment_component )
 		structure st1("beam",{{"width",100},{"height",400},{"poisson",0.3},{"E",1e5}});
 		ls1.addStructure(st1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		ls1.mesh(2,pointStore);
 
 		BOOST_REQUIRE(ls1.getElementPoints().size() == 2);
@@ -124,7 +124,7 @@ BOOST_AUTO_TEST_SUITE( sd_line_segment_component )
 		structure st1("truss",{{"A",100},{"E",1e5}});
 		ls1.addStructure(st1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		ls1.mesh(2,pointStore);
 
 		BOOST_REQUIRE(ls1.getElementPoints().size() == 2);
@@ -151,7 +151,7 @@ BOOST_AUTO_TEST_SUITE( sd_line_segment_component )
 		load l1(lc1,40,0);
 		ls1.addLoad(l1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		ls1.mesh(2,pointStore);
 		
 		BOOST_REQUIRE(ls1.getMeshedPoints()[0]->getLoads()[0].magnitude() == 10);
@@ -172,7 +172,7 @@ BOOST_AUTO_TEST_SUITE( sd_line_segment_component )
 		constraint c1(2);
 		ls1.addConstraint(c1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		ls1.mesh(2,pointStore);
 		
 		BOOST_REQUIRE(ls1.getMeshedPoints()[0]->getConstraints()[0].DOF() == 2);
@@ -0,0 +1,84 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_point_store_component"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/component/point_store.hpp>
+#include <bso/structural_design/component/quadrilateral.hpp>
+
+#include <set>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace component_test {
+using namespace bso::structural_design::component;
+
+BOOST_AUTO_TEST_SUITE( sd_point_store_component )
+	
+	BOOST_AUTO_TEST_CASE( add_and_find )
+	{
+		point_store ps1;
+		BOOST_REQUIRE(ps1.size() == 0);
+		
+		point* p1 = ps1.addPoint({0,0,0});
+		point* p2 = ps1.addPoint({1,0,0});
+		point* p3 = ps1.addPoint({1e-10,0,0}); // within tolerance of p1
+		
+		BOOST_REQUIRE(ps1.size() == 2);
+		BOOST_REQUIRE(p3 == p1);
+		BOOST_REQUIRE(p1->getID() == 0);
+		BOOST_REQUIRE(p2->getID() == 1);
+		BOOST_REQUIRE(ps1.findPoint({1,0,0}) == p2);
+		BOOST_REQUIRE(ps1.findPoint({2,0,0}) == nullptr);
+		BOOST_REQUIRE(ps1[1] == p2);
+		BOOST_REQUIRE(ps1.back() == p2);
+		
+		point_store ps2 = ps1;
+		BOOST_REQUIRE(ps2.size() == 2);
+		BOOST_REQUIRE(ps2[1] != p2);
+		BOOST_REQUIRE(ps2[1]->getID() == 1);
+		BOOST_REQUIRE(ps2.findPoint({1,0,0}) == ps2[1]);
+		BOOST_REQUIRE(ps2.addPoint({2,0,0})->getID() == 2);
+		
+		ps1.clear();
+		BOOST_REQUIRE(ps1.size() == 0);
+		BOOST_REQUIRE(ps1.findPoint({0,0,0}) == nullptr);
+		BOOST_REQUIRE(ps1.addPoint({1,0,0})->getID() == 0);
+	}
+	
+	BOOST_AUTO_TEST_CASE( shared_points_and_unique_IDs )
+	{
+		quadrilateral q1({{0,0,0},{1,0,0},{1,1,0},{0,1,0}});
+		quadrilateral q2({{1,0,0},{2,0,0},{2,1,0},{1,1,0}});
+		point_store pointStore;
+		q1.mesh(4,pointStore);
+		q2.mesh(4,pointStore);
+		
+		// the 5 points on the shared edge are only stored once
+		BOOST_REQUIRE(pointStore.size() == 45);
+		
+		std::set<unsigned long> IDs;
+		for (const auto& i : pointStore) IDs.insert(i->getID());
+		BOOST_REQUIRE(IDs.size() == pointStore.size());
+		BOOST_REQUIRE(*IDs.rbegin() == pointStore.size()-1);
+	}
+	
+	BOOST_AUTO_TEST_CASE( large_mesh )
+	{
+		quadrilateral q1({{0,0,0},{300,0,0},{300,300,0},{0,300,0}});
+		point_store pointStore;
+		q1.mesh(300,pointStore);
+		
+		BOOST_REQUIRE(pointStore.size() == 301*301);
+		BOOST_REQUIRE(pointStore.back()->getID() == 301*301-1);
+		BOOST_REQUIRE(pointStore.findPoint({150,150,0}) != nullptr);
+	}
+	
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace component_test
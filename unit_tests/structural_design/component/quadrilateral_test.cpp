@@ -98,7 +98,7 @@ BOOST_AUTO_TEST_SUITE( sd_quadrilateral_component )
 		structure st1("flat_shell",{{"thickness",100},{"poisson",0.3},{"E",1e5}});
 		q1.addStructure(st1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		q1.mesh(2,pointStore);
 
 		BOOST_REQUIRE(q1.getElementPoints().size() == 4);
@@ -134,7 +134,7 @@ BOOST_AUTO_TEST_SUITE( sd_quadrilateral_component )
 		load l1(lc1,160,0);
 		q1.addLoad(l1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		q1.mesh(2,pointStore);
 		
 		for (auto& i : pointStore)
@@ -164,7 +164,7 @@ BOOST_AUTO_TEST_SUITE( sd_quadrilateral_component )
 		constraint c1(4);
 		q1.addConstraint(c1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		q1.mesh(2,pointStore);
 		
 		for (auto& i : pointStore)
@@ -0,0 +1,53 @@
+// microbenchmark of the derivation of the element stiffness matrices, prints the time per element
+// build with: make element_benchmark (in bso/unit_tests)
+
+#include <bso/structural_design/element/elements.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+namespace element_benchmark {
+using namespace bso::structural_design::element;
+
+template <class FACTORY>
+void run(const std::string& name, const unsigned long& count, FACTORY createElement)
+{ // creates and destroys the element count times, after a warm up
+	for (unsigned long i = 0; i < count/10; ++i) std::unique_ptr<element>(createElement(i));
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long i = 0; i < count; ++i) std::unique_ptr<element>(createElement(i));
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	std::cout << name << ": " << 1e6*time.count()/count << " us per element" << std::endl;
+}
+
+} // namespace element_benchmark
+
+int main(int argc, char* argv[])
+{
+	using namespace element_benchmark;
+	unsigned long count = (argc > 1) ? std::stoul(argv[1]) : 20000;
+	
+	node n1({0,0,0},1), n2({1000,0,0},2), n3({1100,800,0},3), n4({0,900,0},4),
+			 n5({100,50,1000},5), n6({1100,50,1000},6), n7({1200,850,1000},7), n8({100,950,1000},8);
+	node s1({0,0,0},9), s2({1000,0,0},10), s3({1000,1000,500},11), s4({0,1000,500},12);
+	
+	for (bool shared : {false, true})
+	{ // derive every stiffness matrix, then share it through the stiffness caches
+		beam::terms_cache::instance().setEnabled(shared);
+		flat_shell::terms_cache::instance().setEnabled(shared);
+		quad_hexahedron::terms_cache::instance().setEnabled(shared);
+		std::string suffix = (shared) ? " (shared)" : "";
+		
+		// keep one element alive, the caches only hold the terms of existing elements
+		std::unique_ptr<element> b(new beam(0,1e5,100,200,0.3,{&n1,&n3}));
+		std::unique_ptr<element> f(new flat_shell(0,1e5,10,0.3,{&s1,&s2,&s3,&s4}));
+		std::unique_ptr<element> q(new quad_hexahedron(0,1e5,0.3,{&n1,&n2,&n3,&n4,&n5,&n6,&n7,&n8}));
+		
+		if (!shared) run("truss", count, [&](unsigned long i){return new truss(i,1e5,1e2,{&n1,&n3});});
+		run("beam" + suffix, count, [&](unsigned long i){return new beam(i,1e5,100,200,0.3,{&n1,&n3});});
+		run("flat_shell" + suffix, count, [&](unsigned long i){return new flat_shell(i,1e5,10,0.3,{&s1,&s2,&s3,&s4});});
+		run("quad_hexahedron" + suffix, count, [&](unsigned long i){return new quad_hexahedron(i,1e5,0.3,
+			{&n1,&n2,&n3,&n4,&n5,&n6,&n7,&n8});});
+	}
+	return 0;
+}
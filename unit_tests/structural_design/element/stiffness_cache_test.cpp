@@ -0,0 +1,108 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_stiffness_cache"
+#endif
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/element/elements.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace element_test {
+using namespace bso::structural_design::element;
+
+BOOST_AUTO_TEST_SUITE( sd_stiffness_cache_test )
+
+	BOOST_AUTO_TEST_CASE( key )
+	{
+		typedef flat_shell::terms_cache cache;
+		std::vector<bso::utilities::geometry::vertex> v1 = {{0,0,0},{1000,0,0},{1000,500,0},{0,500,0}};
+		std::vector<bso::utilities::geometry::vertex> v2 = v1, v3 = v1;
+		for (auto& i : v2) i += bso::utilities::geometry::vertex({3000.1,-200,1e4});
+		v3[2](1) += 1e-3;
+		
+		cache::key k1, k2, k3;
+		cache::addParameter(k1,150);
+		cache::addParameter(k2,150);
+		cache::addParameter(k3,150);
+		cache::addGeometry(k1,v1);
+		cache::addGeometry(k2,v2);
+		cache::addGeometry(k3,v3);
+		BOOST_REQUIRE(k1 == k2);
+		BOOST_REQUIRE(k1 != k3);
+		
+		cache::key k4;
+		cache::addParameter(k4,150.0 + 1e-12);
+		cache::addGeometry(k4,v1);
+		BOOST_REQUIRE(k1 != k4);
+	}
+	
+	BOOST_AUTO_TEST_CASE( flat_shells )
+	{
+		node n1({   0,  0,0},1), n2({1000,  0,0},2), n3({1000,500,0},3), n4({   0,500,0},4);
+		node n5({3000,200,0},5), n6({4000,200,0},6), n7({4000,700,0},7), n8({3000,700,0},8);
+		
+		unsigned long initialSize = flat_shell::terms_cache::instance().size();
+		{
+			flat_shell fs1(1,1e5,150,0.3,{&n1,&n2,&n3,&n4});
+			flat_shell fs2(2,1e5,150,0.3,{&n5,&n6,&n7,&n8}); // translated
+			flat_shell fs3(3,1e5,100,0.3,{&n5,&n6,&n7,&n8}); // other thickness
+			flat_shell fs4(4,1e5,150,0.3,{&n2,&n3,&n4,&n1}); // other orientation
+			BOOST_REQUIRE(fs1.getOriginalSM().data() == fs2.getOriginalSM().data());
+			BOOST_REQUIRE(fs1.getOriginalSM().data() != fs3.getOriginalSM().data());
+			BOOST_REQUIRE(fs1.getOriginalSM().data() != fs4.getOriginalSM().data());
+			BOOST_REQUIRE(flat_shell::terms_cache::instance().size() == initialSize + 3);
+			
+			// the shared terms give the same results as the derived ones
+			flat_shell::terms_cache::instance().setEnabled(false);
+			flat_shell fs5(5,1e5,150,0.3,{&n5,&n6,&n7,&n8});
+			flat_shell::terms_cache::instance().setEnabled(true);
+			BOOST_REQUIRE(fs5.getOriginalSM().data() != fs2.getOriginalSM().data());
+			BOOST_REQUIRE((fs5.getOriginalSM() - fs2.getOriginalSM()).norm() < 1e-9 * fs5.getOriginalSM().norm());
+			
+			unsigned long DOFCount = 0;
+			for (auto i : {&n5,&n6,&n7,&n8}) i->generateNFT(DOFCount);
+			bso::structural_design::component::load_case lc("test_case");
+			std::map<bso::structural_design::component::load_case, Eigen::VectorXd> displacements;
+			displacements[lc] = Eigen::VectorXd::LinSpaced(DOFCount,-0.1,0.2);
+			for (auto i : {&n5,&n6,&n7,&n8}) i->addDisplacements(displacements);
+			fs2.computeResponse(lc);
+			fs5.computeResponse(lc);
+			BOOST_REQUIRE(abs(fs2.getTotalEnergy()/fs5.getTotalEnergy() - 1) < 1e-9);
+			BOOST_REQUIRE(abs(fs2.getTotalEnergy("bending")/fs5.getTotalEnergy("bending") - 1) < 1e-9);
+			BOOST_REQUIRE((fs2.getStress() - fs5.getStress()).norm() < 1e-9 * fs5.getStress().norm());
+		}
+		// the terms are released with the last element that shares them
+		BOOST_REQUIRE(flat_shell::terms_cache::instance().size() == initialSize);
+	}
+	
+	BOOST_AUTO_TEST_CASE( beams_and_hexahedra )
+	{
+		node n1({0,0,0},1), n2({1000,0,0},2), n3({1000,1000,0},3), n4({0,1000,0},4);
+		node n5({0,0,1000},5), n6({1000,0,1000},6), n7({1000,1000,1000},7), n8({0,1000,1000},8);
+		node n9({0,0,2000},9), n10({1000,0,2000},10), n11({1000,1000,2000},11), n12({0,1000,2000},12);
+		
+		beam b1(1,1e5,100,200,0.3,{&n1,&n5});
+		beam b2(2,1e5,100,200,0.3,{&n2,&n6});
+		beam b3(3,1e5,200,100,0.3,{&n3,&n7});
+		BOOST_REQUIRE(b1.getOriginalSM().data() == b2.getOriginalSM().data());
+		BOOST_REQUIRE(b1.getOriginalSM().data() != b3.getOriginalSM().data());
+		
+		quad_hexahedron h1(1,1e5,0.3,{&n1,&n2,&n3,&n4,&n5,&n6,&n7,&n8});
+		quad_hexahedron h2(2,1e5,0.3,{&n5,&n6,&n7,&n8,&n9,&n10,&n11,&n12});
+		quad_hexahedron h3(3,1e5,0.2,{&n5,&n6,&n7,&n8,&n9,&n10,&n11,&n12});
+		BOOST_REQUIRE(h1.getOriginalSM().data() == h2.getOriginalSM().data());
+		BOOST_REQUIRE(h1.getOriginalSM().data() != h3.getOriginalSM().data());
+		
+		// the density of an element does not change the shared matrix
+		h1.updateDensity(0.5,3);
+		BOOST_REQUIRE(h1.getSM().norm() < h2.getSM().norm());
+		BOOST_REQUIRE(h1.getOriginalSM() == h2.getOriginalSM());
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace element_test
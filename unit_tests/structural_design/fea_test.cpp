@@ -7,6 +7,9 @@
 #include <bso/structural_design/fea.hpp>
 #include <bso/structural_design/component/point.hpp>
 
+#include <chrono>
+#include <sstream>
+
 /*
 BOOST_TEST()
 BOOST_REQUIRE_THROW(function, std::domain_error)
@@ -42,6 +45,47 @@ BOOST_AUTO_TEST_SUITE( sd_fea_test )
 		BOOST_REQUIRE(n3->ID() == 2);
 	}
 	
+	BOOST_AUTO_TEST_CASE( add_node_scaling )
+	{
+		auto buildNodes = [](fea& f, const unsigned int& n)
+		{ // adds n*n*10 nodes on a grid, each node twice
+			for (unsigned int repeat = 0; repeat < 2; ++repeat)
+			{
+				for (unsigned int i = 0; i < n; ++i)
+				{
+					for (unsigned int j = 0; j < n; ++j)
+					{
+						for (unsigned int k = 0; k < 10; ++k)
+						{
+							f.addNode({i*0.1, j*0.1, k*0.1 + repeat*1e-10});
+						}
+					}
+				}
+			}
+		};
+
+		fea smallFEA, largeFEA;
+		auto start = std::chrono::steady_clock::now();
+		buildNodes(smallFEA,50);
+		auto middle = std::chrono::steady_clock::now();
+		buildNodes(largeFEA,100);
+		auto end = std::chrono::steady_clock::now();
+
+		BOOST_REQUIRE(smallFEA.getNodes().size() == 25000);
+		BOOST_REQUIRE(largeFEA.getNodes().size() == 100000);
+		for (unsigned int i = 0; i < largeFEA.getNodes().size(); ++i)
+		{
+			BOOST_REQUIRE(largeFEA.getNodes()[i]->ID() == i+1);
+		}
+		BOOST_REQUIRE(largeFEA.addNode({9.9,9.9,0.9}) == largeFEA.getNodes().back());
+		BOOST_REQUIRE(largeFEA.getNodes().size() == 100000);
+
+		// four times as many nodes should take roughly four times as long (a linear search would take sixteen times as long)
+		double smallTime = std::chrono::duration<double>(middle - start).count();
+		double largeTime = std::chrono::duration<double>(end - middle).count();
+		BOOST_REQUIRE(largeTime < 10.0 * smallTime);
+	}
+
 	BOOST_AUTO_TEST_CASE( add_element )
 	{
 		fea testFEA;
@@ -80,6 +124,75 @@ BOOST_AUTO_TEST_SUITE( sd_fea_test )
 		BOOST_REQUIRE(n2->getGlobalDOF(2) == 3);
 	}
 	
+	BOOST_AUTO_TEST_CASE( assembly_modes )
+	{
+		fea scatterFEA, tripletFEA, blockFEA;
+		for (auto testFEA : {&scatterFEA, &tripletFEA, &blockFEA})
+		{
+			element::node* n1 = testFEA->addNode({0,0,0});
+			element::node* n2 = testFEA->addNode({1,0,0});
+			element::node* n3 = testFEA->addNode({1,1,0.5});
+			element::node* n4 = testFEA->addNode({0,1,1});
+			for (unsigned int i = 0; i < 6; ++i) n1->addConstraint(i);
+			
+			testFEA->addElement(new element::beam(0,1e5,0.1,0.2,0.3,{n1,n2}));
+			testFEA->addElement(new element::beam(1,1e5,0.1,0.2,0.3,{n2,n3}));
+			testFEA->addElement(new element::beam(2,1e5,0.1,0.2,0.3,{n3,n4}));
+			testFEA->addElement(new element::truss(3,1e5,1e-2,{n1,n3}));
+			testFEA->addElement(new element::truss(4,1e5,1e-2,{n2,n4}));
+			n4->addLoad(element::load(element::load_case("test_case"),1e2,2));
+		}
+		tripletFEA.setAssemblyMode("triplets");
+		blockFEA.setAssemblyMode("blocks");
+		BOOST_REQUIRE_THROW(tripletFEA.setAssemblyMode("notAMode"), std::invalid_argument);
+		
+		for (auto density : {1.0, 0.5, 0.25})
+		{
+			for (auto testFEA : {&scatterFEA, &tripletFEA, &blockFEA})
+			{
+				for (auto& i : testFEA->getElements()) i->updateDensity(density*(i->ID()+1)/5.0,3.0);
+				testFEA->generateGSM();
+			}
+			Eigen::MatrixXd scatterGSM = scatterFEA.getGSM();
+			Eigen::MatrixXd tripletGSM = tripletFEA.getGSM();
+			BOOST_REQUIRE(scatterGSM.rows() == 18);
+			// the products of the densities and the element SMs may be fused into the additions when
+			// scattering, which is not possible when summing triplets, so they differ in rounding only
+			BOOST_REQUIRE((scatterGSM - tripletGSM).cwiseAbs().maxCoeff() <=
+				1e-14*scatterGSM.cwiseAbs().maxCoeff());
+			
+			// the blocks hold the same values, at the DOFs of the nodes
+			BOOST_REQUIRE(blockFEA.getGSM().size() == 0);
+			BOOST_REQUIRE(blockFEA.getBlockGSM().getBlockRows() == 4);
+			BOOST_REQUIRE(blockFEA.getBlockGSM().getBlockCount() == 9); // n1 has no free DOFs
+			Eigen::MatrixXd blocks = blockFEA.getBlockGSM().toSparse();
+			const auto& blockDOFs = blockFEA.getBlockDOFs();
+			BOOST_REQUIRE(blockDOFs.size() == 18);
+			for (unsigned int i = 0; i < 18; ++i)
+			{
+				for (unsigned int j = 0; j < 18; ++j)
+				{
+					BOOST_REQUIRE(blocks(blockDOFs[i],blockDOFs[j]) == scatterGSM(i,j));
+				}
+			}
+			
+			scatterFEA.solve("SimplicialLDLT");
+			blockFEA.setIterativeSolverSettings(1e-10);
+			blockFEA.solve("Block-PCG");
+			BOOST_REQUIRE((blockFEA.getDisplacements() - scatterFEA.getDisplacements()).norm() <
+				1e-8*scatterFEA.getDisplacements().norm());
+		}
+		BOOST_REQUIRE_THROW(scatterFEA.solve("Block-PCG"), std::invalid_argument);
+		BOOST_REQUIRE_THROW(blockFEA.solve("SimplicialLDLT"), std::invalid_argument);
+		BOOST_REQUIRE_THROW(blockFEA.isSingular(), std::runtime_error);
+		
+		// switching back to an assembled GSM releases the blocks
+		blockFEA.setAssemblyMode("scatter");
+		blockFEA.generateGSM();
+		BOOST_REQUIRE(blockFEA.getBlockGSM().getBlockCount() == 0);
+		BOOST_REQUIRE((Eigen::MatrixXd(blockFEA.getGSM()) - Eigen::MatrixXd(scatterFEA.getGSM())).norm() == 0);
+	}
+	
 	BOOST_AUTO_TEST_CASE( solve )
 	{
 		fea testFEA;
@@ -122,6 +235,366 @@ BOOST_AUTO_TEST_SUITE( sd_fea_test )
 		testFEA.clearResponse();
 		BOOST_REQUIRE_THROW(testFEA.solve("notASolver"), std::invalid_argument);
 	}
+	
+	BOOST_AUTO_TEST_CASE( solve_load_cases )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1,0,0});
+		element::node* n3 = testFEA.addNode({2,0,0});
+		
+		n1->addConstraint(0);
+		n1->addConstraint(1);
+		n1->addConstraint(2);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		n3->addConstraint(1);
+		n3->addConstraint(2);
+		
+		element::load_case lc1("end_load");
+		element::load_case lc2("mid_load");
+		n3->addLoad(element::load(lc1,1e8,0));
+		n2->addLoad(element::load(lc2,1e8,0));
+		
+		testFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		testFEA.addElement(new element::truss(1,1e5,1e3,{n2,n3}));
+		testFEA.generateGSM();
+		
+		BOOST_REQUIRE(testFEA.getLoadCases().size() == 2);
+		BOOST_REQUIRE(testFEA.getLoads().rows() == 2);
+		BOOST_REQUIRE(testFEA.getLoads().cols() == 2);
+		
+		for (auto solver : {"SimplicialLDLT", "SimplicialLLT", "DenseLDLT", "MixedLDLT", "BiCGSTAB", "scaledBiCGSTAB", "PCG", "PCG-AMG", "EbE-PCG"})
+		{
+			testFEA.solve(solver);
+			
+			BOOST_REQUIRE(testFEA.getDisplacements().cols() == 2);
+			BOOST_REQUIRE(abs(n2->getDisplacements(lc1)(0)/1.0-1) < 1e-3);
+			BOOST_REQUIRE(abs(n3->getDisplacements(lc1)(0)/2.0-1) < 1e-3);
+			BOOST_REQUIRE(abs(n2->getDisplacements(lc2)(0)/1.0-1) < 1e-3);
+			BOOST_REQUIRE(abs(n3->getDisplacements(lc2)(0)/1.0-1) < 1e-3);
+			for (unsigned int i = 0; i < 2; ++i)
+			{
+				auto lc = testFEA.getLoadCases()[i];
+				BOOST_REQUIRE(testFEA.getDisplacements(lc) == testFEA.getDisplacements().col(i));
+			}
+		}
+		BOOST_REQUIRE_THROW(testFEA.getDisplacements(element::load_case("unknown")), std::invalid_argument);
+	}
+	
+	BOOST_AUTO_TEST_CASE( response_buffer )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1,0,0});
+		element::node* n3 = testFEA.addNode({2,0,0});
+		for (unsigned int i = 0; i < 3; ++i) n1->addConstraint(i);
+		for (auto i : {n2,n3}) {i->addConstraint(1); i->addConstraint(2);}
+		
+		element::load_case lc1("end_load");
+		element::load_case lc2("mid_load");
+		n3->addLoad(element::load(lc1,1e8,0));
+		n2->addLoad(element::load(lc2,1e8,0));
+		testFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		testFEA.addElement(new element::truss(1,1e5,1e3,{n2,n3}));
+		testFEA.generateGSM();
+		testFEA.solve("SimplicialLDLT");
+		
+		// the energies are stored per element and load case, the elements and nodes refer to them
+		const Eigen::MatrixXd& energies = testFEA.getEnergies();
+		BOOST_REQUIRE(energies.rows() == 2 && energies.cols() == 2);
+		const double* energyData = energies.data();
+		const double* displacementData = testFEA.getDisplacements().data();
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			const auto& ele = testFEA.getElements()[i];
+			for (unsigned int j = 0; j < 2; ++j)
+			{
+				auto lc = testFEA.getLoadCases()[j];
+				BOOST_REQUIRE(&ele->getEnergy(lc) == &energies(i,j));
+				Eigen::VectorXd eleDisplacements = ele->getDisplacements(lc);
+				BOOST_REQUIRE(eleDisplacements.size() == 6);
+				BOOST_REQUIRE(eleDisplacements.head<3>() == ele->getNodes()[0]->getDisplacements(lc).head<3>());
+				BOOST_REQUIRE(eleDisplacements.tail<3>() == ele->getNodes()[1]->getDisplacements(lc).head<3>());
+			}
+			BOOST_REQUIRE(abs(energies.row(i).sum() - ele->getTotalEnergy()) < 1e-9*ele->getTotalEnergy());
+		}
+		BOOST_REQUIRE(abs(energies(0,0)/0.5e8-1) < 1e-9); // both load cases stretch the first truss by 1
+		BOOST_REQUIRE(abs(energies(1,1)/0.5e8-1) < 1e-9);
+		BOOST_REQUIRE(abs(energies(1,0)) < 1e-9);
+		BOOST_REQUIRE_THROW(testFEA.getElements()[0]->computeResponse(element::load_case("unknown")), std::invalid_argument);
+		
+		// a next solve reuses the storage
+		testFEA.solve("SimplicialLDLT");
+		BOOST_REQUIRE(testFEA.getEnergies().data() == energyData);
+		BOOST_REQUIRE(testFEA.getDisplacements().data() == displacementData);
+		BOOST_REQUIRE(abs(energies(0,0)/0.5e8-1) < 1e-9);
+	}
+	
+	BOOST_AUTO_TEST_CASE( element_groups )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({2000,0,0});
+		for (unsigned int i = 0; i < 6; ++i) n1->addConstraint(i);
+		element::load_case lc1("test_case");
+		n3->addLoad(element::load(lc1,1e3,1));
+		n3->addLoad(element::load(lc1,1e3,0));
+		
+		testFEA.addElement(new element::beam(0,1e5,100,100,0.3,{n1,n2}));
+		testFEA.addElement(new element::truss(1,1e5,1e3,{n1,n3}));
+		testFEA.addElement(new element::beam(2,1e5,100,100,0.3,{n2,n3}));
+		
+		// the elements are grouped by type, and keep their index in the system
+		const auto& groups = testFEA.getElementGroups();
+		BOOST_REQUIRE(groups.get<element::beam>().elements.size() == 2);
+		BOOST_REQUIRE(groups.get<element::truss>().elements.size() == 1);
+		BOOST_REQUIRE(groups.get<element::flat_shell>().elements.empty());
+		BOOST_REQUIRE(groups.get<element::element>().elements.empty());
+		BOOST_REQUIRE(groups.get<element::beam>().indices == std::vector<unsigned long>({0,2}));
+		BOOST_REQUIRE(groups.get<element::truss>().indices == std::vector<unsigned long>({1}));
+		unsigned long count = 0;
+		groups.forEach([&](const auto& group){count += group.elements.size();});
+		BOOST_REQUIRE(count == 3);
+		
+		// the operations on all elements give the same results as those on each element
+		testFEA.updateDensities(Eigen::Vector3d(0.5,0.8,1.0), 3);
+		testFEA.generateGSM();
+		testFEA.solve();
+		Eigen::VectorXd energies = testFEA.getTotalEnergies();
+		Eigen::VectorXd sensitivities = testFEA.getEnergySensitivities(3);
+		Eigen::VectorXd volumes = testFEA.getVolumes();
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const auto& ele = testFEA.getElements()[i];
+			BOOST_REQUIRE(ele->getDensity() == std::vector<double>({0.5,0.8,1.0})[i]);
+			BOOST_REQUIRE(energies(i) == ele->getTotalEnergy());
+			BOOST_REQUIRE(sensitivities(i) == ele->getEnergySensitivity(3));
+			BOOST_REQUIRE(volumes(i) == ele->getVolume());
+		}
+		BOOST_REQUIRE(energies(0) > 0 && energies(1) > 0 && energies(2) > 0);
+		BOOST_REQUIRE_THROW(testFEA.getStresses(), std::runtime_error);
+		BOOST_REQUIRE_THROW(testFEA.updateDensities(Eigen::Vector2d(0.5,0.5)), std::invalid_argument);
+		BOOST_REQUIRE_THROW(testFEA.updateDensities(Eigen::Vector3d(0.5,0.5,0.5),3,"unknown"), std::invalid_argument);
+	}
+	
+	BOOST_AUTO_TEST_CASE( solve_changed_pattern )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1,0,0});
+		element::node* n3 = testFEA.addNode({2,0,0});
+		
+		n1->addConstraint(0);
+		n1->addConstraint(1);
+		n1->addConstraint(2);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		n3->addConstraint(1);
+		n3->addConstraint(2);
+		
+		element::load_case lc1("test_case");
+		element::load l1(lc1,1e8,0);
+		n3->addLoad(l1);
+		
+		auto t1 = new element::truss(0,1e5,1e3,{n1,n2});
+		auto t2 = new element::truss(1,1e5,1e3,{n1,n3});
+		auto t3 = new element::truss(2,1e5,1e3,{n2,n3});
+		testFEA.addElement(t1);
+		testFEA.addElement(t2);
+		testFEA.addElement(t3);
+		
+		for (auto solver : {"SimplicialLDLT", "SimplicialLLT"})
+		{
+			t3->updateDensity(1.0,1.0,"regularSIMP");
+			testFEA.generateGSM();
+			testFEA.solve(solver);
+			BOOST_REQUIRE(abs(n3->getDisplacements(lc1)(0)/1.0-1) < 1e-9);
+			
+			// only the values of the GSM change, the symbolic factorization is reused
+			t3->updateDensity(0.5,1.0,"regularSIMP");
+			testFEA.generateGSM();
+			testFEA.solve(solver);
+			BOOST_REQUIRE(abs(n3->getDisplacements(lc1)(0)/1.2-1) < 1e-9);
+			
+			// the coupling between n2 and n3 disappears from the sparsity pattern
+			t3->updateDensity(0.0,1.0,"regularSIMP");
+			testFEA.generateGSM();
+			testFEA.solve(solver);
+			BOOST_REQUIRE(abs(n2->getDisplacements(lc1)(0)) < 1e-9);
+			BOOST_REQUIRE(abs(n3->getDisplacements(lc1)(0)/2.0-1) < 1e-9);
+		}
+	}
+	
+	BOOST_AUTO_TEST_CASE( solve_low_rank_update )
+	{ // a chain of trusses, of which the stiffness of a few elements changes between the solves
+		fea testFEA;
+		std::vector<element::node*> nodes;
+		std::vector<element::truss*> trusses;
+		for (unsigned int i = 0; i <= 40; ++i)
+		{
+			nodes.push_back(testFEA.addNode({(double)i,0,0}));
+			if (i == 0) nodes.back()->addConstraint(0);
+			nodes.back()->addConstraint(1);
+			nodes.back()->addConstraint(2);
+			if (i == 0) continue;
+			trusses.push_back(new element::truss(i,1e5,1e3,{nodes[i-1],nodes[i]}));
+			testFEA.addElement(trusses.back());
+		}
+		element::load_case lc1("end_load");
+		element::load_case lc2("mid_load");
+		nodes[40]->addLoad(element::load(lc1,1e8,0));
+		nodes[20]->addLoad(element::load(lc2,1e8,0));
+		
+		BOOST_REQUIRE_THROW(testFEA.setLowRankUpdateSettings(1.5), std::invalid_argument);
+		BOOST_REQUIRE_THROW(testFEA.setLowRankUpdateSettings(0.1,0), std::invalid_argument);
+		testFEA.setLowRankUpdateSettings(0.1);
+		testFEA.generateGSM();
+		testFEA.solve("LowRankLDLT");
+		BOOST_REQUIRE(testFEA.getLowRankUpdateRank() == 0);
+		BOOST_REQUIRE(abs(nodes[40]->getDisplacements(lc1)(0)/40.0-1) < 1e-9);
+		
+		// the change of a single element couples two DOFs, the factorization is updated
+		Eigen::VectorXd x = Eigen::VectorXd::Ones(trusses.size());
+		x(10) = 0.5;
+		testFEA.updateDensities(x,1.0,"regularSIMP");
+		testFEA.generateGSM();
+		testFEA.solve("LowRankLDLT");
+		BOOST_REQUIRE(testFEA.getLowRankUpdateRank() == 2);
+		Eigen::MatrixXd updated = testFEA.getDisplacements();
+		BOOST_REQUIRE(testFEA.getSolverErrors()[0] < 1e-8);
+		BOOST_REQUIRE(abs(nodes[40]->getDisplacements(lc1)(0)/41.0-1) < 1e-9);
+		testFEA.solve("SimplicialLDLT");
+		BOOST_REQUIRE((updated - testFEA.getDisplacements()).norm() < 1e-9*updated.norm());
+		
+		// the changes accumulate with respect to the factorized GSM
+		x(30) = 0.5;
+		testFEA.updateDensities(x,1.0,"regularSIMP");
+		testFEA.generateGSM();
+		testFEA.solve("LowRankLDLT");
+		BOOST_REQUIRE(testFEA.getLowRankUpdateRank() == 4);
+		BOOST_REQUIRE(abs(nodes[40]->getDisplacements(lc1)(0)/42.0-1) < 1e-9);
+		BOOST_REQUIRE(abs(nodes[20]->getDisplacements(lc2)(0)/21.0-1) < 1e-9);
+		Eigen::MatrixXd ae = testFEA.getLoads();
+		BOOST_REQUIRE((testFEA.solveAdjoint(ae) - testFEA.getDisplacements()).norm() <
+			1e-9*testFEA.getDisplacements().norm());
+		
+		// too many changed DOFs, the GSM is factorized again
+		x.head(10).setConstant(0.5);
+		testFEA.updateDensities(x,1.0,"regularSIMP");
+		testFEA.generateGSM();
+		testFEA.solve("LowRankLDLT");
+		BOOST_REQUIRE(testFEA.getLowRankUpdateRank() == 0);
+		BOOST_REQUIRE(abs(nodes[40]->getDisplacements(lc1)(0)/52.0-1) < 1e-9);
+	}
+	
+	BOOST_AUTO_TEST_CASE( solve_auto )
+	{ // the chain of trusses of solve_low_rank_update, solved with the solver the registry selects
+		fea testFEA;
+		std::vector<element::node*> nodes;
+		for (unsigned int i = 0; i <= 40; ++i)
+		{
+			nodes.push_back(testFEA.addNode({(double)i,0,0}));
+			if (i == 0) nodes.back()->addConstraint(0);
+			nodes.back()->addConstraint(1);
+			nodes.back()->addConstraint(2);
+			if (i > 0) testFEA.addElement(new element::truss(i,1e5,1e3,{nodes[i-1],nodes[i]}));
+		}
+		element::load_case lc("end_load");
+		nodes[40]->addLoad(element::load(lc,1e8,0));
+		testFEA.generateGSM();
+		testFEA.solve("SimplicialLDLT");
+		Eigen::MatrixXd reference = testFEA.getDisplacements();
+		
+		solver::solver_registry& registry = solver::solver_registry::instance();
+		std::stringstream log;
+		registry.setLog(&log);
+		testFEA.solve("auto");
+		BOOST_REQUIRE(testFEA.getSolver() == "DenseLDLT");
+		BOOST_REQUIRE(testFEA.getSolverSelection().properties.DOFCount == 40);
+		BOOST_REQUIRE(testFEA.getSolverSelection().properties.dimensions == 1);
+		BOOST_REQUIRE(log.str().find("DenseLDLT") != std::string::npos);
+		BOOST_REQUIRE((testFEA.getDisplacements() - reference).norm() < 1e-9*reference.norm());
+		Eigen::MatrixXd ae = testFEA.getLoads();
+		BOOST_REQUIRE((testFEA.solveAdjoint(ae) - reference).norm() < 1e-9*reference.norm());
+		
+		// beyond the dense limit, the estimated fill of the sparse factor is that of its ordering
+		solver::solver_registry::selection_limits defaults = registry.getLimits(), limits = defaults;
+		limits.denseDOFs = 10;
+		registry.setLimits(limits);
+		testFEA.solve("auto");
+		registry.setLimits(defaults);
+		BOOST_REQUIRE(testFEA.getSolver() == "SimplicialLDLT");
+		BOOST_REQUIRE(testFEA.getSolverSelection().properties.factorFill == testFEA.getOrderingFill());
+		
+		// a registered back-end, which a rule selects
+		BOOST_REQUIRE_THROW(testFEA.solve("denseLU"), std::invalid_argument);
+		solver::solver_registry::registration denseLU("denseLU",[](const Eigen::SparseMatrix<double>& A,
+			const Eigen::MatrixXd& B, Eigen::MatrixXd& X){X = Eigen::MatrixXd(A).partialPivLu().solve(B);});
+		registry.addRule("test",[](solver::system_properties& p, std::string& reason)
+		{
+			reason = "test";
+			return std::string("denseLU");
+		});
+		testFEA.solve("auto");
+		registry.removeRule("test");
+		registry.setLog(nullptr);
+		BOOST_REQUIRE(testFEA.getSolver() == "denseLU");
+		BOOST_REQUIRE((testFEA.getDisplacements() - reference).norm() < 1e-9*reference.norm());
+		BOOST_REQUIRE(testFEA.getSolverErrors()[0] < 1e-12);
+		BOOST_REQUIRE((testFEA.solveAdjoint(ae) - reference).norm() < 1e-9*reference.norm());
+		registry.unregisterSolver("denseLU");
+		BOOST_REQUIRE_THROW(testFEA.solve("denseLU"), std::invalid_argument);
+	}
+	
+	BOOST_AUTO_TEST_CASE( is_singular )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1,0,0});
+		element::node* n3 = testFEA.addNode({2,0,0});
+		
+		n1->addConstraint(0);
+		n1->addConstraint(1);
+		n1->addConstraint(2);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		n3->addConstraint(1);
+		n3->addConstraint(2);
+		
+		testFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		testFEA.addElement(new element::truss(1,1e5,1e3,{n2,n3}));
+		testFEA.generateGSM();
+		
+		BOOST_REQUIRE(!testFEA.isSingular());
+		BOOST_REQUIRE(testFEA.getMechanismDOFs().empty());
+		BOOST_REQUIRE(testFEA.getMechanismNodes().empty());
+		BOOST_REQUIRE_THROW(testFEA.isSingular(0.5), std::invalid_argument);
+		
+		// a truss that is only supported in its axial direction forms a mechanism
+		fea testFEA2;
+		n1 = testFEA2.addNode({0,0,0});
+		n2 = testFEA2.addNode({1,0,0});
+		n3 = testFEA2.addNode({1,1,0});
+		
+		n1->addConstraint(0);
+		n1->addConstraint(1);
+		n1->addConstraint(2);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		n3->addConstraint(2);
+		
+		testFEA2.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		testFEA2.addElement(new element::truss(1,1e5,1e3,{n2,n3}));
+		testFEA2.generateGSM();
+		
+		BOOST_REQUIRE(testFEA2.isSingular());
+		BOOST_REQUIRE(testFEA2.getMechanismDOFs().size() == 1);
+		BOOST_REQUIRE(testFEA2.getMechanismDOFs()[0] == n3->getGlobalDOF(0));
+		BOOST_REQUIRE(testFEA2.getMechanismNodes().size() == 1);
+		BOOST_REQUIRE(testFEA2.getMechanismNodes()[0] == n3);
+	}
 
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace structural_design_test
\ No newline at end of file
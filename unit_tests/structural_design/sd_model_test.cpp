@@ -6,6 +6,8 @@
 
 #include <bso/structural_design/sd_model.hpp>
 
+#include <map>
+
 /*
 BOOST_TEST()
 BOOST_REQUIRE_THROW(function, std::domain_error)
@@ -144,6 +146,95 @@ BOOST_AUTO_TEST_SUITE( sd_analysis_test )
 		BOOST_REQUIRE(checkDisp.isApprox(displacements,1e-4));
 	}
 	
+	BOOST_AUTO_TEST_CASE( is_stable )
+	{
+		sd_model sd1;
+		namespace geom = bso::utilities::geometry;
+		
+		auto p1 = sd1.addPoint({0,0,0});
+		auto p2 = sd1.addPoint({0.320,1.500,0.32*tan(60*M_PI/180.0)/3.0});
+		auto p3 = sd1.addPoint({0.640,0,0});
+		auto p4 = sd1.addPoint({0.320,0,0.32*tan(60*M_PI/180.0)});
+		
+		component::constraint c0(0);
+		component::constraint c1(1);
+		component::constraint c2(2);
+		p1->addConstraint(c0); p1->addConstraint(c1); p1->addConstraint(c2);
+		p3->addConstraint(c0); p3->addConstraint(c1); p3->addConstraint(c2);
+		p4->addConstraint(c0); p4->addConstraint(c1); p4->addConstraint(c2);
+		
+		component::structure str1("truss",{{"E",1e7},{"A",M_PI*pow(2e-2,2)}});
+		sd1.addGeometry(geom::line_segment({*p2,*p1}))->addStructure(str1);
+		sd1.addGeometry(geom::line_segment({*p2,*p3}))->addStructure(str1);
+		auto geom3 = sd1.addGeometry(geom::line_segment({*p2,*p4}));
+		
+		// without the third truss, the top point can move out of the plane of the other two
+		BOOST_REQUIRE(!sd1.isStable());
+		BOOST_REQUIRE(sd1.getMechanismVertices().size() == 1);
+		BOOST_REQUIRE(sd1.getMechanismVertices()[0].isSameAs(*p2));
+		
+		geom3->addStructure(str1);
+		BOOST_REQUIRE(sd1.isStable());
+		BOOST_REQUIRE(sd1.getMechanismVertices().empty());
+	}
+
+	BOOST_AUTO_TEST_CASE( mesh_cache )
+	{ // a model that did not change is not meshed again, nor checked for its stability
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+			{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+		geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+		component::load_case lc("horizontal load");
+		geom2->addLoad(component::load(lc,1e3,0));
+
+		unsigned long revision = sd.getRevision();
+		BOOST_REQUIRE(!sd.isMeshCurrent(4));
+		sd.mesh(4);
+		BOOST_REQUIRE(sd.isMeshCurrent(4) && !sd.isMeshCurrent(2) && !sd.isMeshCurrent(4,false));
+		auto fea = sd.getFEA();
+		auto elements = fea->getElements();
+		sd.analyze();
+		Eigen::MatrixXd reference = fea->getDisplacements();
+
+		// the stability check leaves the mesh of the model, and is reused
+		BOOST_REQUIRE(sd.isStable());
+		BOOST_REQUIRE(sd.getFEA() == fea && sd.isMeshCurrent(4));
+		BOOST_REQUIRE(fea->getDisplacements() == reference);
+		BOOST_REQUIRE(sd.isStable());
+
+		// the densities of the cached mesh are reset to those of a new mesh
+		sd.setElementDensities(0.5,3);
+		sd.analyze();
+		BOOST_REQUIRE((fea->getDisplacements() - reference).norm() > reference.norm());
+		sd.mesh(4);
+		BOOST_REQUIRE(sd.getFEA() == fea && fea->getElements() == elements);
+		BOOST_REQUIRE(fea->getDisplacements().isZero());
+		sd.analyze();
+		BOOST_REQUIRE((fea->getDisplacements() - reference).norm() < 1e-12*reference.norm());
+		BOOST_REQUIRE(sd.getRevision() == revision);
+
+		// a change to any of the components of the model invalidates the mesh
+		geom2->addLoad(component::load(lc,1e3,2));
+		BOOST_REQUIRE(sd.getRevision() != revision && !sd.isMeshCurrent(4));
+		sd.mesh(4);
+		sd.analyze();
+		BOOST_REQUIRE(sd.isMeshCurrent(4));
+		BOOST_REQUIRE((sd.getFEA()->getDisplacements() - reference).norm() > 1e-3*reference.norm());
+		sd.addPoint({0,0,0.5});
+		BOOST_REQUIRE(!sd.isMeshCurrent(4));
+
+		// a model meshed at size 1 without load panels is checked for its stability on its own mesh
+		sd.mesh(1,false);
+		fea = sd.getFEA();
+		BOOST_REQUIRE(sd.isStable());
+		BOOST_REQUIRE(sd.getFEA() == fea && !fea->getMechanismDOFs().size());
+	}
+	
 	BOOST_AUTO_TEST_CASE( analyze_beam )
 	{
 		sd_model sd1;
@@ -193,6 +284,527 @@ BOOST_AUTO_TEST_SUITE( sd_analysis_test )
 		BOOST_REQUIRE(checkDisp.isApprox(checkNode->getDisplacements(lc1),1e-4));
 	}
 	
+	BOOST_AUTO_TEST_CASE( analyze_parallel )
+	{ // results with multiple threads should be bitwise the same as those with a single thread
+		namespace geom = bso::utilities::geometry;
+		std::vector<sd_model> models(2);
+		for (auto& sd : models)
+		{
+			auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+				{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+			auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+			auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+			
+			geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+			geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+			for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+			
+			component::load_case lc1("vertical load");
+			component::load_case lc2("horizontal load");
+			geom2->addLoad(component::load(lc1,-1e3,2));
+			geom2->addLoad(component::load(lc2,1e3,0));
+		}
+		models[1].setThreadCount(4);
+		BOOST_REQUIRE(models[0].getThreadCount() == 1);
+		BOOST_REQUIRE(models[1].getThreadCount() == 4);
+		BOOST_REQUIRE_THROW(models[1].setThreadCount(0), std::invalid_argument);
+		
+		for (auto& sd : models)
+		{
+			sd.mesh(4);
+			sd.analyze();
+		}
+		
+		auto fea0 = models[0].getFEA();
+		auto fea1 = models[1].getFEA();
+		BOOST_REQUIRE(fea1->getThreadCount() == 4);
+		BOOST_REQUIRE(fea0->getElements().size() == fea1->getElements().size());
+		BOOST_REQUIRE(Eigen::MatrixXd(fea0->getGSM()) == Eigen::MatrixXd(fea1->getGSM()));
+		BOOST_REQUIRE(fea0->getDisplacements() == fea1->getDisplacements());
+		for (unsigned int i = 0; i < fea0->getElements().size(); ++i)
+		{
+			BOOST_REQUIRE(fea0->getElements()[i]->ID() == fea1->getElements()[i]->ID());
+			BOOST_REQUIRE(fea0->getElements()[i]->getTotalEnergy() == fea1->getElements()[i]->getTotalEnergy());
+		}
+	}
+	
+	BOOST_AUTO_TEST_CASE( analyze_iterative )
+	{ // the preconditioned conjugate gradient solvers should converge to the direct solution
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+			{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		
+		geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+		geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+		
+		component::load_case lc1("vertical load");
+		component::load_case lc2("horizontal load");
+		geom2->addLoad(component::load(lc1,-1e3,2));
+		geom2->addLoad(component::load(lc2,1e3,0));
+		
+		sd.mesh(6);
+		sd.analyze("SimplicialLDLT");
+		auto fea = sd.getFEA();
+		Eigen::MatrixXd reference = fea->getDisplacements();
+		
+		BOOST_REQUIRE_THROW(fea->setIterativeSolverSettings(0), std::invalid_argument);
+		fea->setIterativeSolverSettings(1e-8);
+		for (auto solver : {"PCG", "PCG-AMG", "PCG-GMG"})
+		{
+			sd.analyze(solver);
+			BOOST_REQUIRE(fea->getSolverIterations().size() == 2);
+			BOOST_REQUIRE(fea->getSolverErrors().size() == 2);
+			for (unsigned int i = 0; i < 2; ++i)
+			{
+				BOOST_REQUIRE(fea->getSolverIterations()[i] > 0);
+				BOOST_REQUIRE(fea->getSolverErrors()[i] < 1e-8);
+				BOOST_REQUIRE((fea->getDisplacements().col(i) - reference.col(i)).norm() <
+					1e-6*reference.col(i).norm());
+			}
+		}
+		
+		// the solver reports failure when it runs out of iterations
+		fea->setIterativeSolverSettings(1e-12,2);
+		BOOST_REQUIRE_THROW(sd.analyze("PCG"), std::runtime_error);
+	}
+	
+	BOOST_AUTO_TEST_CASE( analyze_mixed_precision )
+	{ // the single precision factorization is refined to the accuracy of the double precision one
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+			{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		
+		geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+		geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+		
+		component::load_case lc1("vertical load");
+		component::load_case lc2("horizontal load");
+		geom2->addLoad(component::load(lc1,-1e3,2));
+		geom2->addLoad(component::load(lc2,1e3,0));
+		
+		sd.mesh(4);
+		sd.analyze("SimplicialLDLT");
+		auto fea = sd.getFEA();
+		Eigen::MatrixXd reference = fea->getDisplacements();
+		
+		sd.analyze("MixedLDLT");
+		BOOST_REQUIRE(!fea->getMixedPrecisionFallback());
+		BOOST_REQUIRE(fea->getSolverIterations().size() == 2);
+		BOOST_REQUIRE(fea->getSolverErrors().size() == 2);
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			BOOST_REQUIRE(fea->getSolverIterations()[i] > 0);
+			BOOST_REQUIRE(fea->getSolverErrors()[i] < 1e-10);
+			BOOST_REQUIRE((fea->getDisplacements().col(i) - reference.col(i)).norm() <
+				1e-8*reference.col(i).norm());
+		}
+		
+		// a refinement that cannot reach its tolerance falls back to the double precision factorization
+		BOOST_REQUIRE_THROW(fea->setRefinementSettings(0), std::invalid_argument);
+		fea->setRefinementSettings(1e-10,0);
+		sd.analyze("MixedLDLT");
+		BOOST_REQUIRE(fea->getMixedPrecisionFallback());
+		BOOST_REQUIRE((fea->getDisplacements() - reference).norm() < 1e-12*reference.norm());
+		for (unsigned int i = 0; i < 2; ++i) BOOST_REQUIRE(fea->getSolverErrors()[i] < 1e-10);
+	}
+
+	BOOST_AUTO_TEST_CASE( analyze_load_combinations )
+	{ // the superposed responses of a combination equal those of a model loaded by the combination
+		namespace geom = bso::utilities::geometry;
+		component::load_case lc1("vertical load");
+		component::load_case lc2("horizontal load");
+		component::load_case lc3("combined load");
+		auto generate = [&](sd_model& sd, const bool& combined)
+		{
+			auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+				{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+			auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+			auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+			geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+			geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+			for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+			geom2->addLoad(component::load((combined) ? lc3 : lc1,(combined) ? -1.2e3 : -1e3,2));
+			geom2->addLoad(component::load((combined) ? lc3 : lc2,(combined) ? 1.5e3 : 1e3,0));
+			sd.mesh(2);
+			sd.analyze();
+		};
+		sd_model sd, reference;
+		generate(sd,false);
+		generate(reference,true);
+
+		BOOST_REQUIRE_THROW(sd.addLoadCombination("",{{lc1,1.0}}), std::invalid_argument);
+		BOOST_REQUIRE_THROW(sd.addLoadCombination("ULS",{}), std::invalid_argument);
+		BOOST_REQUIRE_THROW(sd.getCombinationResults("ULS"), std::invalid_argument);
+		sd.addLoadCombination("ULS",{{lc1,1.2},{lc2,1.5}});
+		sd.addLoadCombination("vertical",{{lc1,1.0},{component::load_case("wind"),1.5}});
+		BOOST_REQUIRE(sd.getLoadCombinations().size() == 2);
+
+		sd_results combined = sd.getCombinationResults("ULS");
+		sd_results expected = reference.getTotalResults();
+		BOOST_REQUIRE(abs(combined.mTotalStrainEnergy/expected.mTotalStrainEnergy-1) < 1e-9);
+		BOOST_REQUIRE(abs(combined.mAxialStrainEnergy/expected.mAxialStrainEnergy-1) < 1e-9);
+		BOOST_REQUIRE(abs(combined.mBendStrainEnergy/expected.mBendStrainEnergy-1) < 1e-9);
+		BOOST_REQUIRE(abs(combined.mShearStrainEnergy/expected.mShearStrainEnergy-1) < 1e-9);
+		BOOST_REQUIRE(abs(combined.mTotalStructuralVolume/expected.mTotalStructuralVolume-1) < 1e-12);
+		Eigen::VectorXd U = sd.getCombinationDisplacements("ULS");
+		Eigen::VectorXd referenceU = reference.getFEA()->getDisplacements().col(0);
+		BOOST_REQUIRE((U - referenceU).norm() < 1e-9*referenceU.norm());
+		std::vector<Eigen::VectorXd> forces = sd.getCombinationForces("ULS");
+		BOOST_REQUIRE(forces.size() == sd.getFEA()->getElements().size());
+		for (unsigned long i = 0; i < forces.size(); ++i)
+		{ // the meshes are the same, and so is the order of their elements
+			auto ele = reference.getFEA()->getElements()[i];
+			Eigen::VectorXd f = ele->getForces(ele->getDisplacements(lc3));
+			BOOST_REQUIRE((forces[i] - f).norm() <= 1e-9*f.norm() + 1e-9);
+		}
+
+		// a load case without loads contributes nothing, a single load case gives its own results
+		sd_results vertical = sd.getCombinationResults("vertical");
+		sd_results lc1Results = sd.getLoadCaseResults(lc1);
+		BOOST_REQUIRE(abs(vertical.mTotalStrainEnergy/lc1Results.mTotalStrainEnergy-1) < 1e-9);
+		BOOST_REQUIRE(abs(vertical.mAxialStrainEnergy/lc1Results.mAxialStrainEnergy-1) < 1e-9);
+		BOOST_REQUIRE(sd.getCombinationResults().size() == 2);
+
+		sd_results total = sd.getTotalResults();
+		sd_results lc2Results = sd.getLoadCaseResults(lc2);
+		BOOST_REQUIRE(total.mStrainEnergyPerLoadCase.size() == 2);
+		BOOST_REQUIRE(abs(total.mStrainEnergyPerLoadCase[lc1]/lc1Results.mTotalStrainEnergy-1) < 1e-12);
+		BOOST_REQUIRE(abs((lc1Results.mTotalStrainEnergy + lc2Results.mTotalStrainEnergy)/total.mTotalStrainEnergy-1) < 1e-12);
+		BOOST_REQUIRE(abs((lc1Results.mBendStrainEnergy + lc2Results.mBendStrainEnergy)/total.mBendStrainEnergy-1) < 1e-12);
+		BOOST_REQUIRE_THROW(sd.getLoadCaseResults(component::load_case("wind")), std::invalid_argument);
+
+		// the combinations are copied with the model
+		sd_model copy(sd);
+		BOOST_REQUIRE(copy.getLoadCombinations().size() == 2);
+		sd.removeLoadCombination("vertical");
+		BOOST_REQUIRE_THROW(sd.getCombinationResults("vertical"), std::invalid_argument);
+	}
+	
+	BOOST_AUTO_TEST_CASE( partial_results_batch )
+	{ // the regions queried at once give the results of testing each element against each region
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+			{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+		geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+		geom2->addLoad(component::load(component::load_case("horizontal load"),1e3,0));
+		sd.mesh(4);
+		sd.analyze();
+
+		auto reference = [&](const auto& region, const bool& separateEnergies)
+		{ // only the results of polygons separate the energies of the flat shells
+			sd_results results;
+			for (const auto& i : sd.getFEA()->getElements())
+			{
+				bool allPointsInsideOrOn = true;
+				for (const auto& j : i->getNodes()) allPointsInsideOrOn &= region.isInsideOrOn(*j);
+				if (!allPointsInsideOrOn) continue;
+				results.mTotalStrainEnergy += i->getTotalEnergy();
+				results.mTotalStructuralVolume += i->getVolume();
+				if (separateEnergies && i->isFlatShell()) results.mBendStrainEnergy += i->getTotalEnergy("bending");
+			}
+			return results;
+		};
+		auto isEqual = [](const sd_results& a, const sd_results& b)
+		{
+			return abs(a.mTotalStrainEnergy - b.mTotalStrainEnergy) <= 1e-12*abs(b.mTotalStrainEnergy) &&
+				abs(a.mTotalStructuralVolume - b.mTotalStructuralVolume) <= 1e-12*abs(b.mTotalStructuralVolume) &&
+				abs(a.mBendStrainEnergy - b.mBendStrainEnergy) <= 1e-12*abs(b.mBendStrainEnergy);
+		};
+
+		// an axis-aligned box, a skewed hexahedron, and one outside the model
+		std::vector<geom::quad_hexahedron> hexahedra = {
+			geom::quad_hexahedron({{0,0,0},{0.5,0,0},{0.5,1,0},{0,1,0},{0,0,1},{0.5,0,1},{0.5,1,1},{0,1,1}}),
+			geom::quad_hexahedron({{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{0.5,0,1},{0.5,1,1},{0,1,1}}),
+			geom::quad_hexahedron({{2,0,0},{3,0,0},{3,1,0},{2,1,0},{2,0,1},{3,0,1},{3,1,1},{2,1,1}})};
+		std::vector<geom::polyhedron*> polyhedra;
+		for (auto& i : hexahedra) polyhedra.push_back(&i);
+		std::vector<sd_results> results = sd.getPartialResults(polyhedra);
+		BOOST_REQUIRE(results.size() == 3);
+		for (unsigned int i = 0; i < 3; ++i) BOOST_REQUIRE(isEqual(results[i],reference(hexahedra[i],false)));
+		BOOST_REQUIRE(results[0].mTotalStructuralVolume > 0 && results[1].mTotalStructuralVolume > 0);
+		BOOST_REQUIRE(results[2].mTotalStrainEnergy == 0 && results[2].mTotalStructuralVolume == 0);
+		BOOST_REQUIRE(isEqual(sd.getPartialResults(&hexahedra[1]),results[1]));
+
+		// a rectangle and a trapezoid on the top face
+		std::vector<geom::quadrilateral> quadrilaterals = {
+			geom::quadrilateral({{0,0,1},{0.5,0,1},{0.5,1,1},{0,1,1}}),
+			geom::quadrilateral({{0,0,1},{1,0,1},{1,0.5,1},{0,1,1}})};
+		std::vector<geom::polygon*> polygons = {&quadrilaterals[0], &quadrilaterals[1]};
+		results = sd.getPartialResults(polygons);
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			BOOST_REQUIRE(isEqual(results[i],reference(quadrilaterals[i],true)));
+			BOOST_REQUIRE(results[i].mBendStrainEnergy > 0);
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( analyze_static_condensation )
+	{ // condensing the quadrilaterals to their boundaries should not change the solution
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto wall1 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,0,1},{0,0,1}}));
+		auto wall2 = sd.addGeometry(geom::quadrilateral({{0,0,0},{0,1,0},{0,1,1},{0,0,1}}));
+		auto roof = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto floor = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		for (auto& i : {wall1, wall2, roof})
+		{
+			i->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		}
+		for (unsigned int i = 0; i < 3; ++i) floor->addConstraint(component::constraint(i));
+		component::load_case lc1("vertical load");
+		component::load_case lc2("horizontal load");
+		roof->addLoad(component::load(lc1,-1e3,2));
+		roof->addLoad(component::load(lc2,1e3,0));
+		
+		sd.mesh(4);
+		sd.analyze("SimplicialLDLT");
+		auto fea = sd.getFEA();
+		Eigen::MatrixXd reference = fea->getDisplacements();
+		Eigen::MatrixXd referenceEnergies = fea->getEnergies();
+		unsigned long DOFCount = fea->getGSM().rows();
+		
+		sd.setStaticCondensation(true);
+		BOOST_REQUIRE(fea->getCondensation().getGroupCount() == 3);
+		BOOST_REQUIRE(fea->getGSM().rows() < (long)DOFCount/2);
+		BOOST_REQUIRE(fea->getGSM().rows() == (long)fea->getCondensation().getCondensedDOFCount());
+		for (auto solver : {"SimplicialLDLT", "SimplicialLLT", "PCG"})
+		{
+			fea->setIterativeSolverSettings(1e-12);
+			sd.analyze(solver);
+			BOOST_REQUIRE(fea->getDisplacements().rows() == (long)DOFCount);
+			BOOST_REQUIRE((fea->getDisplacements() - reference).norm() < 1e-8*reference.norm());
+			BOOST_REQUIRE((fea->getEnergies() - referenceEnergies).norm() < 1e-8*referenceEnergies.norm());
+		}
+		BOOST_REQUIRE_THROW(sd.analyze("EbE-PCG"), std::runtime_error);
+		
+		// a copy of the model reuses the condensed terms of its quadrilaterals
+		sd_model copy(sd);
+		copy.mesh(4);
+		unsigned long cacheSize = solver::static_condensation::cache().size();
+		copy.analyze();
+		BOOST_REQUIRE(solver::static_condensation::cache().size() == cacheSize);
+		BOOST_REQUIRE((copy.getFEA()->getDisplacements() - reference).norm() < 1e-8*reference.norm());
+		
+		sd.setStaticCondensation(false);
+		BOOST_REQUIRE(!fea->getCondensation().isActive());
+		BOOST_REQUIRE(fea->getGSM().rows() == (long)DOFCount);
+	}
+	
+	BOOST_AUTO_TEST_CASE( analyze_orderings )
+	{ // the ordering of the direct solvers changes their fill, but not their solution
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto wall1 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,0,1},{0,0,1}}));
+		auto wall2 = sd.addGeometry(geom::quadrilateral({{0,0,0},{0,1,0},{0,1,1},{0,0,1}}));
+		auto roof = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto floor = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		for (auto& i : {wall1, wall2, roof})
+		{
+			i->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		}
+		for (unsigned int i = 0; i < 3; ++i) floor->addConstraint(component::constraint(i));
+		roof->addLoad(component::load(component::load_case("vertical load"),-1e3,2));
+		
+		sd.mesh(6);
+		sd.analyze("SimplicialLDLT");
+		auto fea = sd.getFEA();
+		BOOST_REQUIRE(fea->getChosenOrdering() == "AMD");
+		Eigen::MatrixXd reference = fea->getDisplacements();
+		
+		BOOST_REQUIRE_THROW(fea->setOrdering("METIS"), std::invalid_argument);
+		std::map<std::string, unsigned long> fill;
+		for (std::string ordering : {"AMD", "COLAMD", "nested-dissection", "RCM", "auto"})
+		{
+			fea->setOrdering(ordering);
+			for (auto solver : {"SimplicialLDLT", "SimplicialLLT"})
+			{
+				sd.analyze(solver);
+				BOOST_REQUIRE((fea->getDisplacements() - reference).norm() < 1e-9*reference.norm());
+			}
+			BOOST_REQUIRE(fea->getOrdering().size() == fea->getGSM().rows());
+			fill[ordering] = fea->getOrderingFill();
+		}
+		BOOST_REQUIRE(fill["nested-dissection"] < fill["RCM"]);
+		for (const auto& i : fill) BOOST_REQUIRE(fill["auto"] <= i.second);
+		
+		// the ordering of one model is reused for a model with the same mesh
+		auto order = fea->getOrdering();
+		sd_model copy(sd);
+		copy.mesh(6);
+		copy.getFEA()->setOrdering(order);
+		copy.analyze("SimplicialLDLT");
+		BOOST_REQUIRE(copy.getFEA()->getChosenOrdering() == "preset");
+		BOOST_REQUIRE(copy.getFEA()->getOrderingFill() == fill["auto"]);
+		BOOST_REQUIRE((copy.getFEA()->getDisplacements() - reference).norm() < 1e-9*reference.norm());
+	}
+	
+	BOOST_AUTO_TEST_CASE( analyze_geometric_multigrid )
+	{ // the coarse levels are the model meshed at half the mesh size, etc., and the iterations of
+		// conjugate gradients preconditioned by them hardly grow when the mesh is refined
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+			{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+		for (unsigned int i = 0; i < 3; ++i) geom2->addConstraint(component::constraint(i));
+		geom1->addLoad(component::load(component::load_case("horizontal load"),1e3,0));
+		
+		std::vector<unsigned long> iterations;
+		for (unsigned int n : {2, 4, 8})
+		{
+			sd.mesh(n);
+			auto fea = sd.getFEA();
+			fea->setIterativeSolverSettings(1e-8);
+			sd.analyze("PCG-GMG");
+			iterations.push_back(fea->getSolverIterations()[0]);
+		}
+		BOOST_REQUIRE(iterations[2] < 1.5*iterations[0]);
+		
+		auto prolongations = sd.generateProlongations();
+		BOOST_REQUIRE(prolongations.size() == 3); // to the meshes of sizes 4, 2, and 1
+		BOOST_REQUIRE(prolongations[0].rows() == (long)sd.getFEA()->getDOFCount());
+		BOOST_REQUIRE(prolongations[0].cols() == 5*5*4*3);
+		BOOST_REQUIRE(prolongations[1].rows() == prolongations[0].cols());
+		BOOST_REQUIRE(prolongations[1].cols() == 3*3*2*3);
+		BOOST_REQUIRE(prolongations[2].cols() == 2*2*1*3);
+		for (const auto& i : prolongations)
+		{ // each fine DOF is interpolated, only next to the constrained face the weights sum to less than one
+			Eigen::VectorXd rowSums = i*Eigen::VectorXd::Ones(i.cols());
+			BOOST_REQUIRE(rowSums.minCoeff() > 0);
+			BOOST_REQUIRE(std::abs(rowSums.maxCoeff() - 1.0) < 1e-12);
+		}
+		
+		// without coarser meshes the solver cannot be used
+		fea unmeshed;
+		BOOST_REQUIRE_THROW(unmeshed.solve("PCG-GMG"), std::invalid_argument);
+	}
+	
+	BOOST_AUTO_TEST_CASE( analyze_warm_start )
+	{ // after a small change in stiffness, starting from the previous displacements saves iterations
+		namespace geom = bso::utilities::geometry;
+		sd_model sd;
+		auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+			{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+		auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+		geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+		geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+		for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+		geom2->addLoad(component::load(component::load_case("vertical load"),-1e3,2));
+		
+		sd.mesh(6);
+		auto fea = sd.getFEA();
+		fea->setIterativeSolverSettings(1e-8);
+		BOOST_REQUIRE_THROW(fea->setPreconditionerReuse(0.5), std::invalid_argument);
+		BOOST_REQUIRE_THROW(fea->setPreconditionerReuse(-1), std::invalid_argument);
+		fea->setPreconditionerReuse(3);
+		
+		for (auto solver : {"PCG", "PCG-AMG"})
+		{
+			for (auto& i : fea->getElements()) i->updateDensity(1.0,3);
+			fea->generateGSM();
+			sd.analyze(solver);
+			BOOST_REQUIRE(!fea->getPreconditionerReused());
+			
+			// soften some of the elements slightly
+			for (unsigned int i = 0; i < fea->getElements().size(); i += 3)
+			{
+				fea->getElements()[i]->updateDensity(0.98,3);
+			}
+			fea->generateGSM();
+			sd.analyze("SimplicialLDLT");
+			Eigen::MatrixXd reference = fea->getDisplacements();
+			sd.analyze(solver);
+			unsigned long coldIterations = fea->getSolverIterations()[0];
+			
+			// restore the previous displacements and start from there
+			for (auto& i : fea->getElements()) i->updateDensity(1.0,3);
+			fea->generateGSM();
+			sd.analyze(solver);
+			for (unsigned int i = 0; i < fea->getElements().size(); i += 3)
+			{
+				fea->getElements()[i]->updateDensity(0.98,3);
+			}
+			fea->generateGSM();
+			sd.analyze(solver,true);
+			BOOST_REQUIRE(fea->getPreconditionerReused());
+			BOOST_REQUIRE(fea->getSolverIterations()[0] < coldIterations);
+			BOOST_REQUIRE((fea->getDisplacements() - reference).norm() < 1e-6*reference.norm());
+		}
+	}
+	
+	BOOST_AUTO_TEST_CASE( analyze_matrix_free )
+	{ // element by element conjugate gradients, without assembling the GSM
+		namespace geom = bso::utilities::geometry;
+		std::vector<sd_model> models(3);
+		for (auto& sd : models)
+		{
+			auto geom1 = sd.addGeometry(geom::quad_hexahedron(
+				{{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+			auto geom2 = sd.addGeometry(geom::quadrilateral({{0,0,1},{1,0,1},{1,1,1},{0,1,1}}));
+			auto geom3 = sd.addGeometry(geom::quadrilateral({{0,0,0},{1,0,0},{1,1,0},{0,1,0}}));
+			geom1->addStructure(component::structure("quad_hexahedron",{{"E",1e5},{"poisson",0.3}}));
+			geom2->addStructure(component::structure("flat_shell",{{"E",1e5},{"thickness",0.1},{"poisson",0.3}}));
+			for (unsigned int i = 0; i < 3; ++i) geom3->addConstraint(component::constraint(i));
+			geom2->addLoad(component::load(component::load_case("vertical load"),-1e3,2));
+			geom2->addLoad(component::load(component::load_case("horizontal load"),1e3,0));
+		}
+		BOOST_REQUIRE_THROW(models[1].setAssemblyMode("unknown"), std::invalid_argument);
+		models[1].setAssemblyMode("matrix-free");
+		models[2].setAssemblyMode("matrix-free");
+		models[2].setThreadCount(4);
+		for (auto& sd : models)
+		{
+			sd.mesh(6);
+			for (auto& i : sd.getFEA()->getElements()) i->updateDensity(0.5,3);
+			sd.getFEA()->generateGSM();
+		}
+		models[0].analyze("SimplicialLDLT");
+		BOOST_REQUIRE(models[1].getFEA()->getGSM().nonZeros() == 0);
+		BOOST_REQUIRE_THROW(models[1].analyze("SimplicialLDLT"), std::runtime_error);
+		BOOST_REQUIRE(models[1].getFEA()->getSystemMemoryUsage() <
+			models[0].getFEA()->getSystemMemoryUsage()/2);
+		
+		for (unsigned int i = 1; i < 3; ++i)
+		{
+			models[i].getFEA()->setIterativeSolverSettings(1e-10);
+			models[i].analyze("EbE-PCG");
+		}
+		auto fea0 = models[0].getFEA();
+		auto fea1 = models[1].getFEA();
+		BOOST_REQUIRE(fea1->getSolverIterations().size() == 2);
+		BOOST_REQUIRE(fea1->getSolverErrors()[0] < 1e-10);
+		BOOST_REQUIRE((fea1->getDisplacements() - fea0->getDisplacements()).norm() <
+			1e-8*fea0->getDisplacements().norm());
+		BOOST_REQUIRE(fea1->getDisplacements() == models[2].getFEA()->getDisplacements());
+		for (unsigned int i = 0; i < fea0->getElements().size(); ++i)
+		{
+			double energy = fea0->getElements()[i]->getTotalEnergy();
+			BOOST_REQUIRE(abs(fea1->getElements()[i]->getTotalEnergy() - energy) <= 1e-6*abs(energy) + 1e-12);
+		}
+		
+		// the element by element solver can also be used on an assembled system
+		fea0->setIterativeSolverSettings(1e-10);
+		models[0].analyze("EbE-PCG");
+		BOOST_REQUIRE((fea1->getDisplacements() - fea0->getDisplacements()).norm() <
+			1e-8*fea0->getDisplacements().norm());
+		BOOST_REQUIRE(models[1].isStable());
+	}
+	
 	BOOST_AUTO_TEST_CASE( topopt_SIMP )
 	{ // benchmarked with 88-line matlab code from DTU
 		sd_model sd1;
@@ -241,6 +853,47 @@ BOOST_AUTO_TEST_SUITE( sd_analysis_test )
 		BOOST_REQUIRE(abs(compliance/101.5963 - 1) < 1e-5);
 	}
 	
+	BOOST_AUTO_TEST_CASE( topopt_SIMP_matrix_free )
+	{ // the same optimization on a coarser mesh, with and without assembling the GSM
+		std::vector<double> compliances;
+		for (bool matrixFree : {false, true})
+		{
+			sd_model sd1;
+			namespace geom = bso::utilities::geometry;
+			std::stringstream out;
+			sd1.setTopOptOutputStream(out);
+			
+			component::load_case lc1("vertical load");
+			auto p1 = sd1.addPoint({0,20,0});
+			auto p2 = sd1.addPoint({60,0,0});
+			p2->addConstraint(component::constraint(1));
+			p1->addLoad(component::load(lc1,1,1));
+			auto line1 = sd1.addGeometry(geom::line_segment({{0,0,0},{0,20,0}}));
+			line1->addConstraint(component::constraint(0));
+			auto quad1 = sd1.addGeometry(geom::quadrilateral({{0,0,0},{0,20,0},{20,20,0},{20,0,0}}));
+			auto quad2 = sd1.addGeometry(geom::quadrilateral({{20,0,0},{20,20,0},{40,20,0},{40,0,0}}));
+			auto quad3 = sd1.addGeometry(geom::quadrilateral({{40,0,0},{40,20,0},{60,20,0},{60,0,0}}));
+			for (auto quad : {quad1, quad2, quad3})
+			{
+				quad->addStructure(component::structure("flat_shell",{{"E",1},{"thickness",1},{"poisson",0.3}}));
+				for (unsigned int i = 2; i < 5; ++i) quad->addConstraint(component::constraint(i));
+			}
+			
+			if (matrixFree)
+			{
+				sd1.setAssemblyMode("matrix-free");
+				sd1.setTopOptSolver("EbE-PCG",true);
+			}
+			sd1.mesh(6);
+			sd1.getFEA()->setIterativeSolverSettings(1e-10);
+			sd1.topologyOptimization<topology_optimization::SIMP>(0.5,4.5,3.0,0.2,1e-2);
+			
+			compliances.push_back(0);
+			for (const auto& i : sd1.getFEA()->getElements()) compliances.back() += i->getTotalEnergy();
+		}
+		BOOST_REQUIRE(abs(compliances[1]/compliances[0] - 1) < 1e-6);
+	}
+	
 	
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace structural_design_test
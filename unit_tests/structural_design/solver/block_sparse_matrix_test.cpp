@@ -0,0 +1,77 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_block_sparse_matrix"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/solver/block_sparse_matrix.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+
+BOOST_AUTO_TEST_SUITE( sd_block_sparse_matrix )
+	
+	BOOST_AUTO_TEST_CASE( pattern )
+	{
+		block_sparse_matrix A;
+		BOOST_REQUIRE(A.rows() == 0);
+		BOOST_REQUIRE_THROW(A.setPattern(3,{{0,3}}), std::invalid_argument);
+		
+		A.setPattern(3,{{0,0},{2,1},{1,1},{0,0},{1,2},{2,2}});
+		BOOST_REQUIRE(A.rows() == 18);
+		BOOST_REQUIRE(A.getBlockCount() == 5); // the duplicate is removed
+		BOOST_REQUIRE(A.getValueCount() == 180);
+		BOOST_REQUIRE(A.findBlock(0,0) == 0);
+		BOOST_REQUIRE(A.findBlock(1,1) == 1);
+		BOOST_REQUIRE(A.findBlock(1,2) == 2);
+		BOOST_REQUIRE(A.findBlock(2,1) == 3);
+		BOOST_REQUIRE(A.findBlock(2,2) == 4);
+		BOOST_REQUIRE(A.findBlock(0,1) == -1);
+		BOOST_REQUIRE(A.findBlock(3,0) == -1);
+		BOOST_REQUIRE(A.getBlock(2).isZero());
+		
+		A.clear();
+		BOOST_REQUIRE(A.getBlockCount() == 0);
+		BOOST_REQUIRE(A.getMemoryUsage() == 0);
+	}
+	
+	BOOST_AUTO_TEST_CASE( products )
+	{ // the product and the diagonal should match those of the same matrix in Eigen's storage
+		unsigned long n = 10;
+		std::vector<std::pair<unsigned long, unsigned long> > pattern;
+		for (unsigned long i = 0; i < n; ++i)
+		{
+			pattern.push_back({i,i});
+			if (i > 0) pattern.push_back({i,i-1});
+			if (i+1 < n) pattern.push_back({i,i+1});
+		}
+		block_sparse_matrix A;
+		A.setPattern(n,pattern);
+		double* values = A.data();
+		for (unsigned long i = 0; i < A.getValueCount(); ++i) values[i] = std::sin(i+1.0);
+		
+		Eigen::SparseMatrix<double> B = A.toSparse();
+		BOOST_REQUIRE(B.rows() == 60);
+		BOOST_REQUIRE(B.nonZeros() == (long)A.getValueCount());
+		BOOST_REQUIRE(B.coeff(7,13) == A.getBlock(A.findBlock(1,2))(1,1));
+		
+		Eigen::VectorXd x(60), y;
+		for (unsigned int i = 0; i < 60; ++i) x(i) = std::cos(i+1.0);
+		A.multiply(x,y);
+		BOOST_REQUIRE((y - B*x).norm() < 1e-12*y.norm());
+		BOOST_REQUIRE((A.diagonal() - Eigen::VectorXd(B.diagonal())).norm() == 0);
+		
+		A.setZero();
+		A.multiply(x,y);
+		BOOST_REQUIRE(y.norm() == 0);
+	}
+	
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
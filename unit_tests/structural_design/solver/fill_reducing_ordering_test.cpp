@@ -0,0 +1,107 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_fill_reducing_ordering"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/solver/fill_reducing_ordering.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+
+	struct ordering_grid
+	{ // an n x n grid of nodes with two DOFs each, coupled to the adjacent nodes
+		Eigen::SparseMatrix<double> A;
+		std::vector<unsigned long> DOFNodes;
+		std::vector<Eigen::Vector3d> coordinates;
+		ordering_grid(const unsigned int& n)
+		{
+			std::vector<Eigen::Triplet<double> > triplets;
+			for (unsigned int i = 0; i < n*n; ++i)
+			{
+				coordinates.push_back(Eigen::Vector3d(i%n,i/n,0));
+				for (unsigned int j = 0; j < 2; ++j) DOFNodes.push_back(i);
+			}
+			auto couple = [&](const unsigned int& a, const unsigned int& b)
+			{
+				for (unsigned int j = 0; j < 2; ++j)
+				{
+					for (unsigned int k = 0; k < 2; ++k)
+					{
+						triplets.push_back({2*a+j,2*b+k,-1.0});
+						triplets.push_back({2*b+k,2*a+j,-1.0});
+					}
+				}
+			};
+			for (unsigned int i = 0; i < n*n; ++i)
+			{
+				for (unsigned int j = 0; j < 2; ++j) triplets.push_back({2*i+j,2*i+j,20.0});
+				triplets.push_back({2*i,2*i+1,1.0});
+				triplets.push_back({2*i+1,2*i,1.0});
+				if (i%n < n-1) couple(i,i+1);
+				if (i/n < n-1) couple(i,i+n);
+			}
+			A.resize(2*n*n,2*n*n);
+			A.setFromTriplets(triplets.begin(),triplets.end());
+		}
+	};
+
+BOOST_AUTO_TEST_SUITE( sd_fill_reducing_ordering )
+
+	BOOST_AUTO_TEST_CASE( orderings )
+	{
+		typedef fill_reducing_ordering ordering;
+		ordering_grid grid(12);
+		long n = grid.A.rows();
+		ordering::permutation natural(n);
+		natural.setIdentity();
+		unsigned long naturalFill = ordering::estimateFill(grid.A,natural);
+
+		std::vector<ordering::permutation> orders = {ordering::AMD(grid.A), ordering::COLAMD(grid.A),
+			ordering::nestedDissection(grid.A,grid.DOFNodes,grid.coordinates),
+			ordering::reverseCuthillMcKee(grid.A,grid.DOFNodes,grid.coordinates.size())};
+		for (const auto& i : orders)
+		{ // each is a permutation, and its estimated fill is that of the factor
+			BOOST_REQUIRE(i.size() == n);
+			std::vector<bool> found(n,false);
+			for (long j = 0; j < n; ++j) found[i.indices()(j)] = true;
+			BOOST_REQUIRE(std::find(found.begin(),found.end(),false) == found.end());
+
+			simplicial_LLT<Eigen::SparseMatrix<double> > LLT;
+			{
+				preset_ordering<int>::scope s(i);
+				LLT.compute(grid.A);
+			}
+			BOOST_REQUIRE(LLT.info() == Eigen::Success);
+			BOOST_REQUIRE(LLT.permutationPinv().indices() == i.indices());
+			BOOST_REQUIRE(ordering::estimateFill(grid.A,i) == (unsigned long)LLT.matrixL().nestedExpression().nonZeros());
+		}
+		BOOST_REQUIRE(ordering::estimateFill(grid.A,orders[0]) < naturalFill);
+		BOOST_REQUIRE(ordering::estimateFill(grid.A,orders[2]) < naturalFill);
+		BOOST_REQUIRE(ordering::estimateFill(grid.A,orders[3]) <= naturalFill);
+
+		// the DOFs of a node stay together
+		for (const auto& i : {orders[2], orders[3]})
+		{
+			for (long j = 0; j < n; j += 2)
+			{
+				BOOST_REQUIRE(grid.DOFNodes[i.indices()(j)] == grid.DOFNodes[i.indices()(j+1)]);
+			}
+		}
+
+		// without a preset, the solvers order by AMD
+		simplicial_LDLT<Eigen::SparseMatrix<double> > LDLT(grid.A);
+		BOOST_REQUIRE(LDLT.permutationPinv().indices() == orders[0].indices());
+
+		BOOST_REQUIRE_THROW(ordering::reverseCuthillMcKee(grid.A,{0,1},grid.coordinates.size()), std::invalid_argument);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
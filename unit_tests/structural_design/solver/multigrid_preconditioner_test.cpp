@@ -0,0 +1,125 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_multigrid_preconditioner"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/solver/multigrid_preconditioner.hpp>
+
+#include <Eigen/IterativeLinearSolvers>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+
+Eigen::SparseMatrix<double> poisson3D(const unsigned int& n)
+{ // finite difference Laplacian on an n x n x n grid with a Dirichlet boundary
+	std::vector<Eigen::Triplet<double> > triplets;
+	auto index = [n](int i, int j, int k) {return (int)(i + n*(j + n*k));};
+	for (int i = 0; i < (int)n; ++i)
+	{
+		for (int j = 0; j < (int)n; ++j)
+		{
+			for (int k = 0; k < (int)n; ++k)
+			{
+				triplets.push_back({index(i,j,k),index(i,j,k),6.0});
+				if (i > 0) triplets.push_back({index(i,j,k),index(i-1,j,k),-1.0});
+				if (j > 0) triplets.push_back({index(i,j,k),index(i,j-1,k),-1.0});
+				if (k > 0) triplets.push_back({index(i,j,k),index(i,j,k-1),-1.0});
+				if (i+1 < (int)n) triplets.push_back({index(i,j,k),index(i+1,j,k),-1.0});
+				if (j+1 < (int)n) triplets.push_back({index(i,j,k),index(i,j+1,k),-1.0});
+				if (k+1 < (int)n) triplets.push_back({index(i,j,k),index(i,j,k+1),-1.0});
+			}
+		}
+	}
+	Eigen::SparseMatrix<double> A(n*n*n,n*n*n);
+	A.setFromTriplets(triplets.begin(),triplets.end());
+	return A;
+}
+
+BOOST_AUTO_TEST_SUITE( sd_multigrid_preconditioner )
+	
+	BOOST_AUTO_TEST_CASE( aggregation_hierarchy )
+	{
+		Eigen::SparseMatrix<double> A = poisson3D(16);
+		multigrid_preconditioner mg;
+		mg.setCoarsestSize(50);
+		mg.compute(A);
+		BOOST_REQUIRE(mg.info() == Eigen::Success);
+		BOOST_REQUIRE(mg.getLevelCount() > 1);
+		BOOST_REQUIRE(mg.getLevelSize(0) == 4096);
+		for (unsigned int i = 1; i < mg.getLevelCount(); ++i)
+		{
+			BOOST_REQUIRE(mg.getLevelSize(i) < mg.getLevelSize(i-1));
+		}
+		
+		// a single V-cycle is a good approximation of the inverse
+		Eigen::VectorXd x = Eigen::VectorXd::Ones(A.rows());
+		Eigen::VectorXd b = A * x;
+		Eigen::VectorXd y = mg.solve(b);
+		BOOST_REQUIRE((b - A*y).norm() < 0.5*b.norm());
+		
+		// the DOF blocks and near null space must match the matrix
+		mg.setNodes({{0,1},{2}},Eigen::MatrixXd::Ones(3,1));
+		BOOST_REQUIRE_THROW(mg.compute(A), std::invalid_argument);
+	}
+	
+	BOOST_AUTO_TEST_CASE( preconditioned_conjugate_gradients )
+	{
+		Eigen::SparseMatrix<double> A = poisson3D(16);
+		Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+		
+		Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper> plainCG;
+		plainCG.setTolerance(1e-8);
+		plainCG.compute(A);
+		Eigen::VectorXd x1 = plainCG.solve(b);
+		BOOST_REQUIRE(plainCG.info() == Eigen::Success);
+		
+		Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			multigrid_preconditioner> multigridCG;
+		multigridCG.setTolerance(1e-8);
+		multigridCG.preconditioner().setCoarsestSize(50);
+		multigridCG.compute(A);
+		Eigen::VectorXd x2 = multigridCG.solve(b);
+		BOOST_REQUIRE(multigridCG.info() == Eigen::Success);
+		BOOST_REQUIRE(multigridCG.iterations() < plainCG.iterations()/2);
+		BOOST_REQUIRE((x1-x2).norm() < 1e-6*x1.norm());
+	}
+	
+	BOOST_AUTO_TEST_CASE( given_prolongations )
+	{ // piecewise constant prolongation on a 1D grid
+		unsigned int n = 64;
+		std::vector<Eigen::Triplet<double> > triplets;
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			triplets.push_back({(int)i,(int)i,2.0});
+			if (i > 0) triplets.push_back({(int)i,(int)i-1,-1.0});
+			if (i+1 < n) triplets.push_back({(int)i,(int)i+1,-1.0});
+		}
+		Eigen::SparseMatrix<double> A(n,n);
+		A.setFromTriplets(triplets.begin(),triplets.end());
+		
+		triplets.clear();
+		for (unsigned int i = 0; i < n; ++i) triplets.push_back({(int)i,(int)i/2,1.0});
+		Eigen::SparseMatrix<double> P(n,n/2);
+		P.setFromTriplets(triplets.begin(),triplets.end());
+		
+		multigrid_preconditioner mg;
+		mg.setProlongations({P});
+		mg.compute(A);
+		BOOST_REQUIRE(mg.info() == Eigen::Success);
+		BOOST_REQUIRE(mg.getLevelCount() == 2);
+		BOOST_REQUIRE(mg.getLevelSize(1) == n/2);
+		
+		mg.setProlongations({P,P});
+		BOOST_REQUIRE_THROW(mg.compute(A), std::invalid_argument);
+	}
+	
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
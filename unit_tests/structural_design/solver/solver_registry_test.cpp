@@ -0,0 +1,118 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_solver_registry"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/solver/solver_registry.hpp>
+
+#include <sstream>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+
+BOOST_AUTO_TEST_SUITE( sd_solver_registry )
+
+	BOOST_AUTO_TEST_CASE( default_rules )
+	{
+		solver_registry registry;
+		std::vector<std::string> rules = {"assembly", "size", "memory", "sparse"};
+		BOOST_REQUIRE(registry.getRules() == rules);
+
+		unsigned long estimates = 0;
+		system_properties p;
+		p.assemblyMode = "scatter";
+		p.dimensions = 2;
+		p.availableMemory = 1e9;
+		p.estimateFill = [&](){++estimates; return p.DOFCount*20;};
+
+		p.DOFCount = 100;
+		solver_selection s = registry.select(p);
+		BOOST_REQUIRE(s.solver == "DenseLDLT" && s.rule == "size");
+		BOOST_REQUIRE(estimates == 0);
+		BOOST_REQUIRE(s.properties.DOFCount == 100 && !s.properties.estimateFill);
+
+		p.DOFCount = 10000;
+		s = registry.select(p);
+		BOOST_REQUIRE(s.solver == "SimplicialLDLT" && s.rule == "sparse");
+		BOOST_REQUIRE(estimates == 1 && s.properties.factorFill == 200000);
+
+		p.DOFCount = 200000;
+		BOOST_REQUIRE(registry.select(p).solver == "SimplicialLDLT");
+		p.dimensions = 3;
+		BOOST_REQUIRE(registry.select(p).solver == "PCG");
+		p.dimensions = 2;
+		p.DOFCount = 600000;
+		BOOST_REQUIRE(registry.select(p).solver == "PCG");
+
+		// the factor does not fit in the memory that is available
+		p.DOFCount = 10000;
+		p.availableMemory = 1e6;
+		s = registry.select(p);
+		BOOST_REQUIRE(s.solver == "PCG" && s.rule == "memory");
+		p.availableMemory = 1e9;
+
+		p.assemblyMode = "blocks";
+		BOOST_REQUIRE(registry.select(p).solver == "Block-PCG");
+		p.assemblyMode = "matrix-free";
+		BOOST_REQUIRE(registry.select(p).solver == "EbE-PCG");
+		p.assemblyMode = "scatter";
+
+		solver_registry::selection_limits limits;
+		limits.denseDOFs = 20000;
+		registry.setLimits(limits);
+		BOOST_REQUIRE(registry.select(p).solver == "DenseLDLT");
+		limits.largeDOFs = 100;
+		BOOST_REQUIRE_THROW(registry.setLimits(limits), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( registration )
+	{
+		solver_registry registry;
+		auto backEnd = [](const Eigen::SparseMatrix<double>& A, const Eigen::MatrixXd& B, Eigen::MatrixXd& X)
+		{
+			X = Eigen::MatrixXd(A).llt().solve(B);
+		};
+		BOOST_REQUIRE_THROW(registry.registerSolver("SimplicialLDLT",backEnd), std::invalid_argument);
+		BOOST_REQUIRE_THROW(registry.registerSolver("auto",backEnd), std::invalid_argument);
+		BOOST_REQUIRE_THROW(registry.registerSolver("denseLLT",nullptr), std::invalid_argument);
+		BOOST_REQUIRE_THROW(registry.getBackEnd("denseLLT"), std::invalid_argument);
+		registry.registerSolver("denseLLT",backEnd);
+		BOOST_REQUIRE(registry.isRegistered("denseLLT") && registry.isKnown("denseLLT"));
+		BOOST_REQUIRE(!registry.isRegistered("PCG") && registry.isKnown("PCG"));
+
+		// a rule that is added later takes precedence, and may pass
+		registry.addRule("tiny",[](system_properties& p, std::string& reason)
+		{
+			reason = "test";
+			return std::string((p.DOFCount < 10) ? "denseLLT" : "");
+		});
+		system_properties p;
+		p.DOFCount = 5;
+		std::stringstream log;
+		registry.setLog(&log);
+		solver_selection s = registry.select(p);
+		BOOST_REQUIRE(s.solver == "denseLLT" && s.rule == "tiny" && s.reason == "test");
+		BOOST_REQUIRE(log.str().find("denseLLT by rule tiny (test), DOFs: 5") != std::string::npos);
+		p.DOFCount = 50;
+		BOOST_REQUIRE(registry.select(p).solver == "DenseLDLT");
+		registry.setLog(nullptr);
+
+		registry.addRule("tiny",[](system_properties& p, std::string& reason){return std::string("unknown");});
+		BOOST_REQUIRE(registry.getRules().size() == 5);
+		BOOST_REQUIRE_THROW(registry.select(p), std::runtime_error);
+		registry.removeRule("tiny");
+		registry.unregisterSolver("denseLLT");
+		BOOST_REQUIRE(!registry.isKnown("denseLLT"));
+		BOOST_REQUIRE(registry.getRules().size() == 4);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
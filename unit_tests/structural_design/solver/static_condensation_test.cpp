@@ -0,0 +1,80 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_static_condensation"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/fea.hpp>
+#include <bso/structural_design/solver/static_condensation.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+namespace sd = bso::structural_design;
+
+BOOST_AUTO_TEST_SUITE( sd_static_condensation )
+
+	BOOST_AUTO_TEST_CASE( chain_of_trusses )
+	{ // a chain of four trusses with stiffness k, fixed at its first node. The first group holds
+		// the first two trusses, its interior is node 1. The second group holds the other two, its
+		// interior is nodes 3 and 4. Only the x-displacement of node 2 remains
+		sd::fea testFEA;
+		std::vector<sd::element::node*> nodes;
+		for (unsigned int i = 0; i < 5; ++i)
+		{
+			nodes.push_back(testFEA.addNode({(double)i,0,0}));
+			if (i == 0) nodes.back()->addConstraint(0);
+			nodes.back()->addConstraint(1);
+			nodes.back()->addConstraint(2);
+			if (i > 0) testFEA.addElement(new sd::element::truss(i,1e5,1e3,{nodes[i-1],nodes[i]}));
+		}
+		sd::element::load_case lc("end_load");
+		nodes[4]->addLoad(sd::element::load(lc,1e8,0));
+		testFEA.generateGSM();
+		double k = 1e8;
+
+		static_condensation sc;
+		BOOST_REQUIRE(!sc.isActive());
+		BOOST_REQUIRE_THROW(sc.initialize({{0,1},{1,2}},testFEA.getElements(),4), std::invalid_argument);
+		BOOST_REQUIRE_THROW(sc.initialize({{0,4}},testFEA.getElements(),4), std::invalid_argument);
+
+		// a group without interior DOFs is not condensed
+		sc.initialize({{0},{1}},testFEA.getElements(),4);
+		BOOST_REQUIRE(!sc.isActive());
+
+		sc.initialize({{0,1},{2,3}},testFEA.getElements(),4);
+		BOOST_REQUIRE(sc.isActive());
+		BOOST_REQUIRE(sc.getGroupCount() == 2);
+		BOOST_REQUIRE(sc.getCondensedDOFCount() == 1);
+		unsigned long DOF = nodes[2]->getGlobalDOF(0);
+		BOOST_REQUIRE(sc.getCondensedDOFs()[0] == DOF);
+
+		for (unsigned long i = 0; i < sc.getGroupCount(); ++i) sc.condenseGroup(i,testFEA.getElements());
+		Eigen::SparseMatrix<double> GSM = sc.assemble(testFEA.getElements());
+		BOOST_REQUIRE(GSM.rows() == 1 && GSM.cols() == 1);
+		BOOST_REQUIRE(std::abs(GSM.coeff(0,0)/(k/2)-1) < 1e-9); // two trusses in series, the free end adds nothing
+
+		// the load at the free end moves to node 2
+		Eigen::MatrixXd F = testFEA.getLoads();
+		Eigen::MatrixXd condensedF = sc.condenseLoads(F);
+		BOOST_REQUIRE(std::abs(condensedF(0,0)/1e8-1) < 1e-9);
+
+		Eigen::MatrixXd condensedU = condensedF/GSM.coeff(0,0);
+		Eigen::MatrixXd U = sc.recover(condensedU,F);
+		BOOST_REQUIRE(U.rows() == 4);
+		for (unsigned int i = 1; i < 5; ++i)
+		{
+			BOOST_REQUIRE(std::abs(U(nodes[i]->getGlobalDOF(0),0)/(double)i-1) < 1e-9);
+		}
+		BOOST_REQUIRE(sc.restrict(U)(0,0) == U(DOF,0));
+		BOOST_REQUIRE(sc.getMemoryUsage() > 0);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
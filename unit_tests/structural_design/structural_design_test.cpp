@@ -9,12 +9,19 @@
 #include <unit_tests/structural_design/element/beam_test.cpp>
 #include <unit_tests/structural_design/element/flat_shell_test.cpp>
 #include <unit_tests/structural_design/element/quad_hexahedron_test.cpp>
+#include <unit_tests/structural_design/element/stiffness_cache_test.cpp>
 #include <unit_tests/structural_design/component/structure_test.cpp>
 #include <unit_tests/structural_design/component/load_test.cpp>
 #include <unit_tests/structural_design/component/constraint_test.cpp>
 #include <unit_tests/structural_design/component/point_test.cpp>
+#include <unit_tests/structural_design/component/point_store_test.cpp>
 #include <unit_tests/structural_design/component/line_segment_test.cpp>
 #include <unit_tests/structural_design/component/quadrilateral_test.cpp>
 #include <unit_tests/structural_design/component/quad_hexahedron_test.cpp>
+#include <unit_tests/structural_design/solver/block_sparse_matrix_test.cpp>
+#include <unit_tests/structural_design/solver/multigrid_preconditioner_test.cpp>
+#include <unit_tests/structural_design/solver/fill_reducing_ordering_test.cpp>
+#include <unit_tests/structural_design/solver/static_condensation_test.cpp>
+#include <unit_tests/structural_design/solver/solver_registry_test.cpp>
 #include <unit_tests/structural_design/fea_test.cpp>
 #include <unit_tests/structural_design/sd_model_test.cpp>
\ No newline at end of file
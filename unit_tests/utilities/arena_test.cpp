@@ -0,0 +1,103 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE arena
+#endif
+
+#include <bso/utilities/arena.hpp>
+#include <bso/utilities/thread_pool.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/test/included/unit_test.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace utilities_test {
+using namespace bso::utilities;
+
+	struct arena_tracked
+	{ // records the order in which the objects are destroyed
+		int mID;
+		std::vector<int>* mDestroyed;
+		arena_tracked(const int& id, std::vector<int>* destroyed) : mID(id), mDestroyed(destroyed) {}
+		~arena_tracked() {mDestroyed->push_back(mID);}
+	};
+
+	struct alignas(32) arena_aligned
+	{
+		double mValues[4];
+	};
+
+BOOST_AUTO_TEST_SUITE( arena_tests )
+
+	BOOST_AUTO_TEST_CASE( create_and_release )
+	{
+		std::vector<int> destroyed;
+		arena a(64);
+		BOOST_REQUIRE(a.size() == 0);
+		for (int i = 0; i < 100; ++i)
+		{
+			arena_tracked* t = a.create<arena_tracked>(i,&destroyed);
+			BOOST_REQUIRE(t->mID == i);
+		}
+		int* n = a.create<int>(5);
+		BOOST_REQUIRE(*n == 5);
+		BOOST_REQUIRE(a.size() == 101);
+		BOOST_REQUIRE(a.getMemoryUsage() == 100*sizeof(arena_tracked) + sizeof(int));
+		BOOST_REQUIRE(destroyed.empty());
+
+		a.release();
+		BOOST_REQUIRE(a.size() == 0);
+		BOOST_REQUIRE(a.getMemoryUsage() == 0);
+		BOOST_REQUIRE(destroyed.size() == 100);
+		for (int i = 0; i < 100; ++i) BOOST_REQUIRE(destroyed[i] == 99-i);
+
+		// the arena can be reused after a release, and destroys its objects when it is destroyed
+		destroyed.clear();
+		{
+			arena b;
+			b.create<arena_tracked>(1,&destroyed);
+			b.create<arena_tracked>(2,&destroyed);
+		}
+		BOOST_REQUIRE(destroyed.size() == 2 && destroyed[0] == 2 && destroyed[1] == 1);
+	}
+
+	BOOST_AUTO_TEST_CASE( alignment )
+	{
+		arena a(64);
+		a.create<char>('a');
+		for (unsigned int i = 0; i < 10; ++i)
+		{
+			arena_aligned* p = a.create<arena_aligned>();
+			BOOST_REQUIRE(reinterpret_cast<std::uintptr_t>(p) % alignof(arena_aligned) == 0);
+			a.create<char>('b');
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( concurrent_create )
+	{
+		std::vector<int> destroyed;
+		arena a(64);
+		thread_pool tp(4);
+		std::vector<arena_tracked*> objects(1000,nullptr);
+		tp.parallel_for(0,objects.size(),[&](const unsigned long& i)
+		{
+			objects[i] = a.create<arena_tracked>(i,nullptr);
+		});
+		BOOST_REQUIRE(a.size() == 1000);
+		for (unsigned int i = 0; i < objects.size(); ++i)
+		{
+			BOOST_REQUIRE(objects[i]->mID == (int)i);
+			objects[i]->mDestroyed = &destroyed;
+		}
+		a.release();
+		BOOST_REQUIRE(destroyed.size() == 1000);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace utilities_test
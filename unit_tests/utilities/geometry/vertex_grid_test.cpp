@@ -0,0 +1,82 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "vertex_grid"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/utilities/geometry/vertex_grid.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace geometry_test {
+using namespace bso::utilities::geometry;
+
+BOOST_AUTO_TEST_SUITE( vertex_grid_tests )
+
+	BOOST_AUTO_TEST_CASE( init )
+	{
+		BOOST_REQUIRE_NO_THROW(vertex_grid<vertex*> g1);
+		BOOST_REQUIRE_THROW(vertex_grid<vertex*> g2(0.0), std::invalid_argument);
+		BOOST_REQUIRE_THROW(vertex_grid<vertex*> g3(-1e-3), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( insert_and_find )
+	{
+		vertex v1 = {0,0,0};
+		vertex v2 = {1,0,0};
+		vertex v3 = {0.1+0.2,0,0};
+		vertex_grid<vertex*> g1;
+		g1.insert(&v1);
+		g1.insert(&v2);
+		g1.insert(&v3);
+
+		BOOST_REQUIRE(g1.size() == 3);
+		BOOST_REQUIRE(g1.find({0,0,0}) == &v1);
+		BOOST_REQUIRE(g1.find({1,0,0}) == &v2);
+		BOOST_REQUIRE(g1.find({0.3,0,0}) == &v3);
+		BOOST_REQUIRE(g1.find({1,1e-10,-1e-10}) == &v2);
+		BOOST_REQUIRE(g1.find({1,1e-8,0}) == nullptr);
+		BOOST_REQUIRE(g1.find({0.5,0,0}) == nullptr);
+
+		g1.clear();
+		BOOST_REQUIRE(g1.size() == 0);
+		BOOST_REQUIRE(g1.find({0,0,0}) == nullptr);
+	}
+
+	BOOST_AUTO_TEST_CASE( same_as_semantics )
+	{ // the grid should find exactly what a linear search with isSameAs finds
+		std::vector<vertex> vertices;
+		double tol = 1e-3;
+		for (unsigned int i = 0; i < 200; ++i)
+		{
+			vertices.push_back({i*0.7e-3, (i%7)*0.9e-3, -(i%3)*1.1e-3});
+		}
+		vertex_grid<vertex*> g1(tol);
+		for (auto& i : vertices) g1.insert(&i);
+
+		for (unsigned int i = 0; i < 400; ++i)
+		{
+			vertex query = {i*0.35e-3, (i%5)*0.9e-3, -(i%3)*1.1e-3};
+			vertex* check = nullptr;
+			for (auto& j : vertices)
+			{
+				if (j.isSameAs(query,tol))
+				{
+					check = &j;
+					break;
+				}
+			}
+			BOOST_REQUIRE(g1.find(query) == check);
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace geometry_test
@@ -10,4 +10,5 @@
 #include <unit_tests/utilities/geometry/triangle_test.cpp>
 #include <unit_tests/utilities/geometry/tetrahedron_test.cpp>
 #include <unit_tests/utilities/geometry/quadrilateral_test.cpp>
-#include <unit_tests/utilities/geometry/quad_hexahedron_test.cpp>
\ No newline at end of file
+#include <unit_tests/utilities/geometry/quad_hexahedron_test.cpp>
+#include <unit_tests/utilities/geometry/vertex_grid_test.cpp>
@@ -0,0 +1,70 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE thread_pool
+#endif
+
+#include <bso/utilities/thread_pool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/included/unit_test.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace utilities_test {
+using namespace bso::utilities;
+
+BOOST_AUTO_TEST_SUITE( thread_pool_tests )
+
+	BOOST_AUTO_TEST_CASE( init )
+	{
+		thread_pool tp1;
+		thread_pool tp2(4);
+		BOOST_REQUIRE(tp1.size() == 1);
+		BOOST_REQUIRE(tp2.size() == 4);
+		BOOST_REQUIRE_THROW(thread_pool tp3(0), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( parallel_for )
+	{
+		for (unsigned int n : {1, 2, 3, 8})
+		{
+			thread_pool tp(n);
+			for (unsigned long size : {0, 1, 5, 1000})
+			{
+				std::vector<int> visits(size,0);
+				tp.parallel_for(0,size,[&](const unsigned long& i){++visits[i];});
+				for (const auto& i : visits) BOOST_REQUIRE(i == 1);
+			}
+			
+			std::atomic<unsigned long> sum(0);
+			for (unsigned int i = 0; i < 100; ++i)
+			{ // the pool is reused for many short loops
+				tp.parallel_for(10,20,[&](const unsigned long& j){sum += j;});
+			}
+			BOOST_REQUIRE(sum == 100*145);
+		}
+	}
+	
+	BOOST_AUTO_TEST_CASE( exceptions )
+	{
+		thread_pool tp(4);
+		BOOST_REQUIRE_THROW(tp.parallel_for(0,100,[](const unsigned long& i)
+		{
+			if (i == 50) throw std::runtime_error("test");
+		}), std::runtime_error);
+		
+		// the pool can still be used after an exception
+		std::vector<int> visits(100,0);
+		tp.parallel_for(0,100,[&](const unsigned long& i){++visits[i];});
+		for (const auto& i : visits) BOOST_REQUIRE(i == 1);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace utilities_test